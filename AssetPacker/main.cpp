@@ -0,0 +1,72 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <tinyxml2.h>
+
+#include "exceptions/EngineException.h"
+#include "resource/AssetArchive.h"
+
+using namespace std;
+using namespace gamelib;
+
+// Packs the assets listed in a resources file into an archive that ResourceManager::MountArchive() can load.
+// Paths in the resources file are read relative to the working directory, as the game would.
+// Usage: AssetPacker <resources.xml> <archive>
+int main(const int argc, char** argv)
+{
+	if (argc != 3)
+	{
+		cerr << "Usage: " << argv[0] << " <resources.xml> <archive>" << endl;
+		return 1;
+	}
+
+	tinyxml2::XMLDocument resources;
+	if (resources.LoadFile(argv[1]) != tinyxml2::XML_SUCCESS)
+	{
+		cerr << "Could not read resources file '" << argv[1] << "': " << resources.ErrorStr() << endl;
+		return 1;
+	}
+
+	const auto* assets = resources.FirstChildElement("Assets");
+	if (!assets)
+	{
+		cerr << "No Assets found in resource file" << endl;
+		return 1;
+	}
+
+	vector<AssetArchive::Source> sources;
+	for (auto* element = assets->FirstChildElement("Asset"); element; element = element->NextSiblingElement("Asset"))
+	{
+		const auto* type = element->Attribute("type");
+		const auto* name = element->Attribute("name");
+		const auto* fileName = element->Attribute("filename");
+		if (!type || !name || !fileName)
+		{
+			cerr << "Skipping an asset without a type, name or filename" << endl;
+			continue;
+		}
+
+		// As ResourceManager::CreateAssetFromElement()
+		auto assetType = Asset::AssetType::Undefined;
+		if (strcmp(type, "graphic") == 0) { assetType = element->FirstChildElement("sprite") ? Asset::AssetType::Sprite : Asset::AssetType::Graphic; }
+		else if (strcmp(type, "fx") == 0 || strcmp(type, "music") == 0) { assetType = Asset::AssetType::Audio; }
+		else if (strcmp(type, "font") == 0) { assetType = Asset::AssetType::Font; }
+		else if (strcmp(type, "script") == 0) { assetType = Asset::AssetType::Script; }
+
+		sources.push_back({ element->IntAttribute("uid"), name, assetType, fileName });
+	}
+
+	try
+	{
+		AssetArchive::Pack(argv[2], sources);
+	}
+	catch (const EngineException& e)
+	{
+		cerr << e.what() << endl;
+		return 1;
+	}
+
+	cout << "Packed " << sources.size() << " assets into " << argv[2] << endl;
+	return 0;
+}
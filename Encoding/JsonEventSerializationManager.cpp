@@ -15,7 +15,7 @@ namespace gamelib
 	{
 		const Json payload = Json::object
 		{
-			{ "messageType", object->Id.Name },
+			{ "messageType", object->Id.GetName() },
 			{ "direction", DirectionUtils::ToString(object->direction) },
 			{ "nickname", target }
 		};
@@ -45,7 +45,7 @@ namespace gamelib
     {
 	    const Json payload = Json::object
 		{
-			{ "messageType", object->Id.Name },
+			{ "messageType", object->Id.GetName() },
 			{ "direction", DirectionUtils::ToString(object->direction) },
 			{ "nickname", target }
 		};
@@ -70,7 +70,7 @@ namespace gamelib
 	{
 		const Json payload = Json::object
 		{
-			{ "messageType", evt->Id.Name },
+			{ "messageType", evt->Id.GetName() },
 			{ "level", evt->Level },
 			{ "nickname", target }
 		};
@@ -106,7 +106,7 @@ namespace gamelib
 		PongMessage pongMessage;
 			pongMessage.Type = "pong";
 			pongMessage.isHappy = true;
-			pongMessage.eventType = NetworkTrafficReceivedEventId.PrimaryId;
+			pongMessage.eventType = NetworkTrafficReceivedEventId.GetPrimaryId();
 			pongMessage.names = { "Stuart", "Jenny", "bruce" };
 			pongMessage.ages = {1, 2,3 };
 			pongMessage.fish = Fish("Neemo", "Mathews");
@@ -130,7 +130,7 @@ namespace gamelib
 		PingMessage pingMessage;
 			pingMessage.Type = "ping";
 			pingMessage.IsHappy = true;
-			pingMessage.EventType = NetworkTrafficReceivedEventId.PrimaryId;
+			pingMessage.EventType = NetworkTrafficReceivedEventId.GetPrimaryId();
 			pingMessage.Names = { "Stuart", "Jenny", "bruce" };
 			pingMessage.Ages = {1, 2,3 };
 			pingMessage.TheFish = Fish("Neemo", "Mathews");
@@ -0,0 +1,142 @@
+#include "pch.h"
+#include "asset/ScriptAsset.h"
+#include "events/SceneChangedEvent.h"
+#include "exceptions/EngineException.h"
+#include "resource/AssetArchive.h"
+#include "resource/AssetLoader.h"
+#include "resource/ResourceManager.h"
+
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+using namespace std;
+namespace gamelib
+{
+	class AssetArchiveTests : public testing::Test
+	{
+	public:
+		void TearDown() override
+		{
+			for (const auto& file : files) { remove(file.c_str()); }
+		}
+
+		// A file that is deleted after the test
+		string WriteFile(const string& fileName, const string& contents)
+		{
+			ofstream file(fileName, ios::binary);
+			file << contents;
+			files.push_back(fileName);
+			return fileName;
+		}
+
+		static string ToString(const span<const byte> data) { return { reinterpret_cast<const char*>(data.data()), data.size() }; }
+
+		const string archivePath = "AssetArchiveTests.pak";
+		vector<string> files { archivePath };
+	};
+
+	TEST_F(AssetArchiveTests, PacksAndFindsAssets)
+	{
+		AssetArchive::Pack(archivePath, {
+			{ 7, "music.wav", Asset::AssetType::Audio, WriteFile("AssetArchiveTests.wav", "RIFF audio") },
+			{ 3, "p1.png", Asset::AssetType::Graphic, WriteFile("AssetArchiveTests.png", string("\x89PNG\0image", 10)) },
+			{ 5, "empty.lua", Asset::AssetType::Script, WriteFile("AssetArchiveTests.lua", "") } });
+
+		const AssetArchive archive(archivePath);
+
+		ASSERT_EQ(archive.GetEntries().size(), 3);
+		EXPECT_EQ(archive.GetEntries()[0].Uid, 3) << "Expected the index to be sorted by uid";
+
+		const auto* image = archive.Find(3);
+		ASSERT_NE(image, nullptr);
+		EXPECT_EQ(image->Type, static_cast<uint32_t>(Asset::AssetType::Graphic));
+		EXPECT_EQ(image->NameHash, AssetArchive::HashName("p1.png"));
+		EXPECT_EQ(ToString(archive.GetData(*image)), string("\x89PNG\0image", 10));
+
+		const auto* music = archive.Find("music.wav");
+		ASSERT_NE(music, nullptr);
+		EXPECT_EQ(music->Uid, 7);
+		EXPECT_EQ(ToString(archive.GetData(*music)), "RIFF audio");
+		EXPECT_TRUE(archive.GetData(*archive.Find(5)).empty());
+
+		for (const auto& entry : archive.GetEntries()) { EXPECT_EQ(entry.Offset % AssetArchive::Alignment, 0); }
+		EXPECT_EQ(archive.Find(4), nullptr);
+		EXPECT_EQ(archive.Find("missing.png"), nullptr);
+	}
+
+	TEST_F(AssetArchiveTests, RejectsFilesThatAreNotArchives)
+	{
+		EXPECT_THROW(AssetArchive(WriteFile("AssetArchiveTests.txt", "This is not an asset archive")), EngineException);
+		EXPECT_THROW(AssetArchive("AssetArchiveTests.missing"), EngineException);
+	}
+
+	TEST_F(AssetArchiveTests, RejectsTruncatedArchives)
+	{
+		AssetArchive::Pack(archivePath, { { 1, "a.lua", Asset::AssetType::Script, WriteFile("AssetArchiveTests.lua", "print('a')") } });
+
+		string contents;
+		{
+			ifstream archive(archivePath, ios::binary);
+			contents.assign(istreambuf_iterator<char>(archive), istreambuf_iterator<char>());
+		}
+
+		EXPECT_THROW(AssetArchive(WriteFile("AssetArchiveTests.truncated", contents.substr(0, contents.size() - 4))), EngineException);
+	}
+
+	TEST_F(AssetArchiveTests, PackingChecksItsSources)
+	{
+		const auto file = WriteFile("AssetArchiveTests.lua", "print('a')");
+
+		EXPECT_THROW(AssetArchive::Pack(archivePath, { { 1, "a", Asset::AssetType::Script, file }, { 1, "b", Asset::AssetType::Script, file } }), EngineException);
+		EXPECT_THROW(AssetArchive::Pack(archivePath, { { 1, "a", Asset::AssetType::Script, "AssetArchiveTests.missing" } }), EngineException);
+	}
+
+	TEST_F(AssetArchiveTests, ResourceManagerLoadsFromMountedArchive)
+	{
+		// The test resources' script, packed with different contents to its file
+		const string packedScript = "-- packed";
+		AssetArchive::Pack(archivePath, { { 10, "TestScript", Asset::AssetType::Script, WriteFile("AssetArchiveTests.lua", packedScript) } });
+
+		ResourceManager::Get()->Reset();
+		ResourceManager::Get()->MountArchive(archivePath);
+		ResourceManager::Get()->IndexResourceFile("Resources.xml");
+		ResourceManager::Get()->HandleEvent(make_shared<SceneChangedEvent>(1), 0);
+
+		const auto script = dynamic_pointer_cast<ScriptAsset>(ResourceManager::Get()->GetAssetInfo("TestScript"));
+		ASSERT_NE(script, nullptr);
+		ASSERT_TRUE(script->IsLoadedInMemory);
+		EXPECT_EQ(*script->GetScriptContent(), packedScript);
+		EXPECT_EQ(script->GetSizeBytes(), packedScript.size());
+		EXPECT_TRUE(ResourceManager::Get()->GetAssetInfo(1)->PackedData.empty()) << "Expected assets not in the archive to load from their files";
+
+		ResourceManager::Get()->UnmountArchive();
+		EXPECT_FALSE(script->IsLoadedInMemory) << "Expected packed assets to be unloaded with the archive";
+		EXPECT_TRUE(script->PackedData.empty());
+
+		ResourceManager::Get()->Reset();
+	}
+
+	TEST_F(AssetArchiveTests, MountingFinishesLoadsInFlightFirst)
+	{
+		AssetArchive::Pack(archivePath, { { 10, "TestScript", Asset::AssetType::Script, WriteFile("AssetArchiveTests.lua", "-- packed") } });
+
+		ResourceManager::Get()->Reset();
+		ResourceManager::Get()->IndexResourceFile("Resources.xml");
+		ResourceManager::Get()->SetAsyncLoading(2);
+		const auto handle = ResourceManager::Get()->LoadSceneAssetsAsync(1);
+
+		// Workers may still be decoding the scene's assets from their files
+		ResourceManager::Get()->MountArchive(archivePath);
+		EXPECT_TRUE(handle->IsReady()) << "Expected the scene's loads to finish before the archive was attached";
+
+		const auto script = dynamic_pointer_cast<ScriptAsset>(ResourceManager::Get()->GetAssetInfo("TestScript"));
+		ASSERT_NE(script, nullptr);
+		EXPECT_FALSE(script->PackedData.empty());
+
+		ResourceManager::Get()->SetAsyncLoading(0);
+		ResourceManager::Get()->UnmountArchive();
+		ResourceManager::Get()->Reset();
+	}
+}
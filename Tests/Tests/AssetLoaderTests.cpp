@@ -0,0 +1,129 @@
+#include "pch.h"
+#include "asset/asset.h"
+#include "exceptions/EngineException.h"
+#include "resource/AssetLoader.h"
+
+#include "gtest/gtest.h"
+#include <chrono>
+#include <thread>
+using namespace std;
+namespace gamelib
+{
+	// Records which threads it was decoded and uploaded on
+	class FakeAsset final : public Asset
+	{
+	public:
+		FakeAsset(const int uid, const bool failDecode = false) : Asset(uid, "fake" + to_string(uid), "fake.bin", "fake", 1), failDecode(failDecode) { }
+
+		void Load() override { Decode(); Upload(); }
+		bool Unload() override { IsLoadedInMemory = false; return true; }
+
+		void Decode() override
+		{
+			DecodedOn = this_thread::get_id();
+			if (failDecode) { THROW(1, "Corrupt file", "FakeAsset"); }
+		}
+
+		void Upload() override
+		{
+			UploadedOn = this_thread::get_id();
+			IsLoadedInMemory = true;
+		}
+
+		thread::id DecodedOn;
+		thread::id UploadedOn;
+
+	private:
+		const bool failDecode;
+	};
+
+	class AssetLoaderTests : public testing::Test
+	{
+	public:
+		// Waits for the loader to decode everything submitted so far
+		static vector<DecodedAsset> TakeAll(AssetLoader& loader, const size_t count)
+		{
+			vector<DecodedAsset> taken;
+			const auto giveUp = chrono::steady_clock::now() + chrono::seconds(5);
+			while (taken.size() < count && chrono::steady_clock::now() < giveUp)
+			{
+				DecodedAsset decoded;
+				if (loader.TryTakeDecoded(decoded)) { taken.push_back(decoded); }
+				else { this_thread::yield(); }
+			}
+			return taken;
+		}
+	};
+
+	TEST_F(AssetLoaderTests, DecodesOffTheCallingThread)
+	{
+		AssetLoader loader(2);
+		vector<shared_ptr<FakeAsset>> assets;
+		for (auto uid = 0; uid < 8; uid++)
+		{
+			assets.push_back(make_shared<FakeAsset>(uid));
+			loader.Submit(assets.back());
+		}
+
+		const auto decoded = TakeAll(loader, assets.size());
+
+		ASSERT_EQ(decoded.size(), assets.size());
+		EXPECT_EQ(loader.GetPendingCount(), 0);
+		for (const auto& asset : assets)
+		{
+			EXPECT_NE(asset->DecodedOn, this_thread::get_id());
+			EXPECT_FALSE(asset->IsLoadedInMemory) << "Expected uploading to be left to the caller";
+		}
+	}
+
+	TEST_F(AssetLoaderTests, DecodeErrorsAreHandedBack)
+	{
+		AssetLoader loader(1);
+		loader.Submit(make_shared<FakeAsset>(1, true));
+
+		const auto decoded = TakeAll(loader, 1);
+
+		ASSERT_EQ(decoded.size(), 1);
+		EXPECT_EQ(decoded[0].Target->Uid, 1);
+		EXPECT_THROW(rethrow_exception(decoded[0].Error), EngineException);
+	}
+
+	TEST_F(AssetLoaderTests, PendingAssetsAreDroppedOnDestruction)
+	{
+		auto loader = make_unique<AssetLoader>(1);
+		for (auto uid = 0; uid < 100; uid++) { loader->Submit(make_shared<FakeAsset>(uid)); }
+
+		EXPECT_NO_THROW(loader = nullptr);
+	}
+
+	TEST_F(AssetLoaderTests, HandleReportsProgress)
+	{
+		AssetLoadHandle handle(3, 4);
+		EXPECT_FLOAT_EQ(handle.GetProgress().GetFraction(), 0.0f);
+
+		EXPECT_FALSE(handle.AssetDone(false));
+		EXPECT_FALSE(handle.AssetDone(true));
+		EXPECT_FLOAT_EQ(handle.GetProgress().GetFraction(), 0.5f);
+		EXPECT_FALSE(handle.IsReady());
+		EXPECT_EQ(handle.GetFuture().wait_for(chrono::seconds(0)), future_status::timeout);
+
+		EXPECT_FALSE(handle.AssetDone(false));
+		EXPECT_TRUE(handle.AssetDone(false));
+
+		ASSERT_EQ(handle.GetFuture().wait_for(chrono::seconds(0)), future_status::ready);
+		const auto progress = handle.GetFuture().get();
+		EXPECT_EQ(progress.Total, 4);
+		EXPECT_EQ(progress.Loaded, 3);
+		EXPECT_EQ(progress.Failed, 1);
+		EXPECT_TRUE(handle.IsReady());
+	}
+
+	TEST_F(AssetLoaderTests, EmptyHandleIsReady)
+	{
+		const AssetLoadHandle handle(3, 0);
+
+		EXPECT_TRUE(handle.IsReady());
+		EXPECT_FLOAT_EQ(handle.GetProgress().GetFraction(), 1.0f);
+		EXPECT_EQ(handle.GetFuture().wait_for(chrono::seconds(0)), future_status::ready);
+	}
+}
@@ -0,0 +1,77 @@
+#include "pch.h"
+#include "resource/AssetResidency.h"
+
+#include "gtest/gtest.h"
+#include <vector>
+using namespace std;
+namespace gamelib
+{
+	class AssetResidencyTests : public testing::Test
+	{
+	public:
+		static bool KeepNothing(int) { return false; }
+	};
+
+	TEST_F(AssetResidencyTests, TracksResidentBytes)
+	{
+		AssetResidency residency;
+		residency.Add(1, 100);
+		residency.Add(2, 50);
+		residency.Add(1, 300);
+
+		EXPECT_EQ(residency.GetResidentBytes(), 350) << "Expected adding an asset again to replace its size";
+		EXPECT_EQ(residency.GetResidentCount(), 2);
+
+		residency.Remove(1);
+		residency.Remove(7);
+		EXPECT_FALSE(residency.IsResident(1));
+		EXPECT_EQ(residency.GetResidentBytes(), 50);
+
+		residency.Clear();
+		EXPECT_EQ(residency.GetResidentCount(), 0);
+		EXPECT_EQ(residency.GetResidentBytes(), 0);
+	}
+
+	TEST_F(AssetResidencyTests, NoBudgetEvictsNothing)
+	{
+		AssetResidency residency;
+		for (auto uid = 0; uid < 10; uid++) { residency.Add(uid, 1000); }
+
+		EXPECT_TRUE(residency.SelectEvictions(KeepNothing).empty());
+	}
+
+	TEST_F(AssetResidencyTests, EvictsLeastRecentlyUsedFirst)
+	{
+		AssetResidency residency(250);
+		residency.Add(1, 100);
+		residency.Add(2, 100);
+		residency.Add(3, 100);
+		residency.Add(4, 100);
+
+		// 1 is used again, so 2 and 3 are now the oldest
+		residency.Touch(1);
+
+		EXPECT_EQ(residency.SelectEvictions(KeepNothing), vector<int>({ 2, 3 }));
+	}
+
+	TEST_F(AssetResidencyTests, KeptAssetsAreNotEvicted)
+	{
+		AssetResidency residency(100);
+		residency.Add(1, 100);
+		residency.Add(2, 100);
+		residency.Add(3, 100);
+
+		EXPECT_EQ(residency.SelectEvictions([](const int uid) { return uid == 1; }), vector<int>({ 2, 3 }));
+		EXPECT_TRUE(residency.SelectEvictions([](int) { return true; }).empty()) << "Expected the budget to be left exceeded";
+	}
+
+	TEST_F(AssetResidencyTests, LoweringTheBudgetEvictsMore)
+	{
+		AssetResidency residency(1000);
+		for (auto uid = 0; uid < 4; uid++) { residency.Add(uid, 100); }
+		EXPECT_TRUE(residency.SelectEvictions(KeepNothing).empty());
+
+		residency.SetBudget(150);
+		EXPECT_EQ(residency.SelectEvictions(KeepNothing), vector<int>({ 0, 1, 2 }));
+	}
+}
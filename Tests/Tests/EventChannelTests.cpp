@@ -0,0 +1,94 @@
+#include "pch.h"
+#include "events/EventChannel.h"
+#include "events/EventFactory.h"
+#include "events/SceneChangedEvent.h"
+#include "events/UpdateAllGameObjectsEvent.h"
+#include <events/EventSubscriber.h>
+
+#include "gtest/gtest.h"
+using namespace std;
+namespace gamelib
+{
+	class SceneChangeListener
+	{
+	public:
+		void OnSceneChanged(const SceneChangedEvent& event) { LastSceneId = event.SceneId; }
+		int LastSceneId = 0;
+	};
+
+	class UntypedSceneSubscriber final : public EventSubscriber
+	{
+	public:
+		std::vector<std::shared_ptr<Event>> HandleEvent(const std::shared_ptr<Event>& evt, const unsigned long deltaMs) override
+		{
+			Handled++;
+			return {};
+		}
+		std::string GetSubscriberName() override { return "untyped_scene_subscriber"; }
+		int Handled = 0;
+	};
+
+	class EventChannelTests : public testing::Test
+	{
+	protected:
+		EventChannel<SceneChangedEvent>& channel = EventChannel<SceneChangedEvent>::Get(SceneChangedEventTypeEventId);
+		vector<int> tokens;
+
+		void SetUp() override
+		{
+			EventManager::Get()->ClearSubscribers();
+			EventManager::Get()->Initialize();
+		}
+
+		void TearDown() override
+		{
+			for (const auto token : tokens) { channel.Unsubscribe(token); }
+		}
+	};
+
+	TEST_F(EventChannelTests, QueuedEventsReachTypedAndUntypedSubscribers)
+	{
+		int receivedSceneId = 0;
+		tokens.push_back(channel.Subscribe([&](const SceneChangedEvent& event) { receivedSceneId = event.SceneId; }));
+
+		UntypedSceneSubscriber untyped;
+		EventManager::Get()->SubscribeToEvent(SceneChangedEventTypeEventId, &untyped);
+
+		EventManager::Get()->RaiseEvent(EventFactory::Get()->CreateSceneChangedEventEvent(7), &untyped);
+		EventManager::Get()->ProcessAllEvents();
+
+		EXPECT_EQ(receivedSceneId, 7) << "Expected the typed handler to receive the queued event";
+		EXPECT_EQ(untyped.Handled, 1) << "Expected the existing subscriber to keep receiving the event";
+	}
+
+	TEST_F(EventChannelTests, PublishCallsBoundMemberFunction)
+	{
+		SceneChangeListener listener;
+		tokens.push_back(channel.Subscribe<&SceneChangeListener::OnSceneChanged>(&listener));
+
+		channel.Publish(SceneChangedEvent(3));
+
+		EXPECT_EQ(listener.LastSceneId, 3);
+		EXPECT_EQ(EventManager::Get()->CountReady(), 0) << "Expected publishing to bypass the event queues";
+	}
+
+	TEST_F(EventChannelTests, UnsubscribeDuringPublish)
+	{
+		int firstCalls = 0, secondCalls = 0;
+		int firstToken = 0;
+		firstToken = channel.Subscribe([&](const SceneChangedEvent&) { firstCalls++; channel.Unsubscribe(firstToken); });
+		tokens.push_back(channel.Subscribe([&](const SceneChangedEvent&) { secondCalls++; }));
+
+		channel.Publish(SceneChangedEvent(1));
+		channel.Publish(SceneChangedEvent(2));
+
+		EXPECT_EQ(firstCalls, 1) << "Expected the handler to stop receiving events once unsubscribed";
+		EXPECT_EQ(secondCalls, 2) << "Expected the other handler to be unaffected";
+		EXPECT_EQ(channel.CountHandlers(), 1);
+	}
+
+	TEST_F(EventChannelTests, ChannelIsBoundToOneEventId)
+	{
+		EXPECT_THROW(EventChannel<SceneChangedEvent>::Get(UpdateAllGameObjectsEventTypeEventId), EngineException);
+	}
+}
@@ -0,0 +1,80 @@
+#include "pch.h"
+#include "events/EventDispatchProfiler.h"
+#include "events/EventManager.h"
+#include "events/UpdateAllGameObjectsEvent.h"
+#include <events/EventSubscriber.h>
+
+#include "gtest/gtest.h"
+#include <sstream>
+using namespace std;
+namespace gamelib
+{
+	class ProfiledSubscriber final : public EventSubscriber
+	{
+	public:
+		std::vector<std::shared_ptr<Event>> HandleEvent(const std::shared_ptr<Event>& evt, const unsigned long deltaMs) override
+		{
+			return { make_shared<Event>(EventId(SubscriberEventHandled, "profiled_handled")) };
+		}
+		std::string GetSubscriberName() override { return "profiled_subscriber"; }
+	};
+
+	TEST(EventDispatchProfilerTests, RecordsHandlerCallsPerEventAndSubscriber)
+	{
+		ProfiledSubscriber subscriber;
+		EventManager::Get()->Reset();
+		EventManager::Get()->ClearSubscribers();
+		EventManager::Get()->SubscribeToEvent(UpdateAllGameObjectsEventTypeEventId, &subscriber);
+		EventManager::Get()->SetDispatchProfiling(true);
+
+		EventManager::Get()->RaiseEvent(make_shared<UpdateAllGameObjectsEvent>(), &subscriber);
+		EventManager::Get()->RaiseEvent(make_shared<UpdateAllGameObjectsEvent>(), &subscriber);
+		EventManager::Get()->ProcessAllEvents();
+
+		const auto profiler = EventManager::Get()->GetDispatchProfiler();
+		ASSERT_NE(profiler, nullptr);
+		const auto profile = profiler->FindProfile(UpdateAllGameObjectsEventTypeEventId, "profiled_subscriber");
+		ASSERT_NE(profile, nullptr);
+		EXPECT_EQ(profile->Calls, 2);
+		EXPECT_EQ(profile->SecondaryEvents, 2);
+		EXPECT_EQ(profile->HandlerNs.GetCount(), 2);
+		EXPECT_EQ(profiler->GetTrace().size(), 2);
+
+		EventManager::Get()->SetDispatchProfiling(false);
+		EventManager::Get()->Reset();
+		EXPECT_EQ(EventManager::Get()->GetDispatchProfiler(), nullptr);
+	}
+
+	TEST(EventDispatchProfilerTests, TraceKeepsLatestCalls)
+	{
+		EventDispatchProfiler profiler(2);
+		const auto start = EventDispatchProfiler::Clock::now();
+		for (int i = 1; i <= 3; i++)
+		{
+			profiler.Record(UpdateAllGameObjectsEventTypeEventId, "subscriber", start + std::chrono::microseconds(i), start + std::chrono::microseconds(i * 2), 1, 0);
+		}
+
+		const auto trace = profiler.GetTrace();
+		ASSERT_EQ(trace.size(), 2) << "Expected the oldest call to be overwritten";
+		EXPECT_EQ(trace[0].DurationNs, 2000);
+		EXPECT_EQ(trace[1].DurationNs, 3000);
+		EXPECT_EQ(profiler.GetProfiles()[0].Calls, 3) << "Expected totals to include calls no longer in the trace";
+	}
+
+	TEST(EventDispatchProfilerTests, ExportsChromeTraceAndFoldedStacks)
+	{
+		EventDispatchProfiler profiler;
+		const auto start = EventDispatchProfiler::Clock::now();
+		profiler.Record(UpdateAllGameObjectsEventTypeEventId, "a \"quoted\" subscriber", start, start + std::chrono::microseconds(5), 1, 0);
+
+		std::stringstream chromeTrace;
+		profiler.WriteChromeTrace(chromeTrace);
+		EXPECT_NE(chromeTrace.str().find("\"traceEvents\""), std::string::npos);
+		EXPECT_NE(chromeTrace.str().find("\"a \\\"quoted\\\" subscriber\""), std::string::npos) << "Expected names to be escaped";
+		EXPECT_NE(chromeTrace.str().find("\"dur\":5"), std::string::npos);
+
+		std::stringstream foldedStacks;
+		profiler.WriteFoldedStacks(foldedStacks);
+		EXPECT_EQ(foldedStacks.str(), "EventManager;" + UpdateAllGameObjectsEventTypeEventId.GetName() + ";a \"quoted\" subscriber 5\n");
+	}
+}
@@ -0,0 +1,35 @@
+#include "pch.h"
+#include "events/EventId.h"
+#include "events/EventNumbers.h"
+
+#include "gtest/gtest.h"
+#include <unordered_set>
+using namespace std;
+namespace gamelib
+{
+	TEST(EventIdTests, EqualIdsShareAHandleAndTheFirstName)
+	{
+		const EventId first(9001, "FirstName", 3);
+		const EventId second(9001, "SecondName", 3);
+		const EventId otherSecondaryId(9001, "FirstName", 4);
+
+		EXPECT_EQ(first, second);
+		EXPECT_EQ(first.GetHandle(), second.GetHandle());
+		EXPECT_EQ(second.GetName(), "FirstName") << "Expected the name the id was first created with";
+		EXPECT_NE(first, otherSecondaryId);
+		EXPECT_EQ(otherSecondaryId.GetPrimaryId(), 9001);
+		EXPECT_EQ(otherSecondaryId.GetSecondaryId(), 4);
+	}
+
+	TEST(EventIdTests, CanBeCopiedAndHashed)
+	{
+		EventId id(9002, "Copied");
+		id = EventId(9003, "Assigned");
+
+		const unordered_set<EventId> ids { id, EventId(9003, "Assigned"), EventId(9004, "Other") };
+
+		EXPECT_EQ(id.GetName(), "Assigned");
+		EXPECT_EQ(ids.size(), 2);
+		EXPECT_TRUE(EventId(9002, "Copied") < id) << "Expected ids to order by primary id";
+	}
+}
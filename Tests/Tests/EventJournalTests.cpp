@@ -0,0 +1,170 @@
+#include "pch.h"
+#include "events/EventJournal.h"
+#include "events/EventReplay.h"
+#include "events/EventManager.h"
+#include "events/SceneChangedEvent.h"
+#include "events/UpdateAllGameObjectsEvent.h"
+#include "exceptions/EngineException.h"
+#include <events/EventSubscriber.h>
+
+#include "gtest/gtest.h"
+#include <filesystem>
+using namespace std;
+namespace gamelib
+{
+	// Counts events and raises one of its own per event, which replay should regenerate rather than replay
+	class JournaledSubscriber final : public EventSubscriber
+	{
+	public:
+		std::vector<std::shared_ptr<Event>> HandleEvent(const std::shared_ptr<Event>& evt, const unsigned long deltaMs) override
+		{
+			Handled++;
+			if (evt->Id == UpdateAllGameObjectsEventTypeEventId) { RaiseEvent(make_shared<Event>(EventId(SubscriberEventHandled, "journaled_handled"))); }
+			return {};
+		}
+		std::string GetSubscriberName() override { return "journaled_subscriber"; }
+		int Handled = 0;
+	};
+
+	// Carries state that the journal has no codec for
+	class UnjournaledEvent final : public Event
+	{
+	public:
+		UnjournaledEvent() : Event(EventId(Fire, "input")) {}
+		int State = 42;
+	};
+
+	class EventJournalTests : public testing::Test
+	{
+	protected:
+		const std::string journalFileName = (std::filesystem::temp_directory_path() / "event_journal_tests.journal").string();
+		JournaledSubscriber subscriber;
+		const EventId inputId = EventId(Fire, "input");
+
+		void SetUp() override
+		{
+			EventManager::Get()->Reset();
+			EventManager::Get()->ClearSubscribers();
+			EventManager::Get()->SubscribeToEvent(UpdateAllGameObjectsEventTypeEventId, &subscriber);
+			EventManager::Get()->SubscribeToEvent(inputId, &subscriber);
+		}
+
+		void TearDown() override
+		{
+			EventManager::Get()->SetEventJournal(nullptr);
+			EventManager::Get()->Reset();
+			std::filesystem::remove(journalFileName);
+		}
+
+		void RecordSession()
+		{
+			EventManager::Get()->SetEventJournal(make_shared<EventJournalWriter>(journalFileName));
+
+			EventManager::Get()->RaiseEvent(make_shared<Event>(inputId), &subscriber);
+			EventManager::Get()->ProcessAllEvents(16);
+			EventManager::Get()->DispatchEventToSubscriber(make_shared<UpdateAllGameObjectsEvent>(), 17);
+			EventManager::Get()->ProcessAllEvents(17);
+
+			// Flushes and closes the journal
+			EventManager::Get()->SetEventJournal(nullptr);
+		}
+	};
+
+	TEST_F(EventJournalTests, RecordsRaisedAndDispatchedEvents)
+	{
+		RecordSession();
+
+		EventJournalReader reader(journalFileName);
+		EventJournalRecord record;
+		vector<JournalRecordType> types;
+		while (reader.ReadNext(record)) { types.push_back(record.Type); }
+
+		const vector expected
+		{
+			JournalRecordType::Raised,
+			JournalRecordType::Frame,
+			JournalRecordType::Dispatched,
+			JournalRecordType::DispatchedDirectly,
+			JournalRecordType::RaisedWhileDispatching,
+			JournalRecordType::Frame,
+			JournalRecordType::Dispatched
+		};
+		EXPECT_EQ(types, expected);
+	}
+
+	TEST_F(EventJournalTests, ReplayReproducesTheSession)
+	{
+		RecordSession();
+		const auto recordedHandled = subscriber.Handled;
+		subscriber.Handled = 0;
+		EventManager::Get()->Reset();
+
+		const auto result = EventReplay().Run(journalFileName, *EventManager::Get());
+
+		EXPECT_EQ(result.Frames, 2);
+		EXPECT_EQ(result.EventsRaised, 1) << "Expected events raised by subscribers not to be replayed";
+		EXPECT_EQ(result.EventsDispatchedDirectly, 1);
+		EXPECT_EQ(subscriber.Handled, recordedHandled);
+	}
+
+	TEST_F(EventJournalTests, RejectsFilesThatAreNotJournals)
+	{
+		{
+			std::ofstream notAJournal(journalFileName, std::ios::binary);
+			notAJournal << "not a journal";
+		}
+		EXPECT_THROW(EventJournalReader reader(journalFileName), EngineException);
+	}
+
+	TEST_F(EventJournalTests, ReplayRebuildsEventsWithTheirState)
+	{
+		std::shared_ptr<Event> replayed;
+		class Capture final : public EventSubscriber
+		{
+		public:
+			explicit Capture(std::shared_ptr<Event>& target) : target(target) {}
+			std::vector<std::shared_ptr<Event>> HandleEvent(const std::shared_ptr<Event>& evt, const unsigned long) override { target = evt; return {}; }
+			std::string GetSubscriberName() override { return "capture"; }
+			std::shared_ptr<Event>& target;
+		} capture(replayed);
+		EventManager::Get()->SubscribeToEvent(SceneChangedEventTypeEventId, &capture);
+
+		EventManager::Get()->SetEventJournal(make_shared<EventJournalWriter>(journalFileName));
+		EventManager::Get()->RaiseEvent(make_shared<SceneChangedEvent>(3), &subscriber);
+		EventManager::Get()->ProcessAllEvents(16);
+		EventManager::Get()->SetEventJournal(nullptr);
+		replayed = nullptr;
+		EventManager::Get()->Reset();
+
+		EventReplay().Run(journalFileName, *EventManager::Get());
+
+		ASSERT_NE(replayed, nullptr);
+		EXPECT_EQ(std::dynamic_pointer_cast<SceneChangedEvent>(replayed)->SceneId, 3);
+	}
+
+	TEST_F(EventJournalTests, ReplaySkipsEventsItCannotRebuild)
+	{
+		EventManager::Get()->SetEventJournal(make_shared<EventJournalWriter>(journalFileName));
+		EventManager::Get()->RaiseEvent(make_shared<UnjournaledEvent>(), &subscriber);
+		EventManager::Get()->SetEventJournal(nullptr);
+		EventManager::Get()->Reset();
+		subscriber.Handled = 0;
+
+		const auto result = EventReplay().Run(journalFileName, *EventManager::Get());
+
+		EXPECT_EQ(result.EventsRaised, 0);
+		EXPECT_EQ(result.EventsSkipped, 1);
+		EXPECT_EQ(subscriber.Handled, 0);
+	}
+
+	TEST_F(EventJournalTests, DrawingIsNotJournaled)
+	{
+		EventManager::Get()->SetEventJournal(make_shared<EventJournalWriter>(journalFileName));
+		EventManager::Get()->DispatchEventToSubscriber(make_shared<Event>(EventId(DrawCurrentScene, "DrawCurrentScene")), 16);
+		EventManager::Get()->SetEventJournal(nullptr);
+
+		EventJournalReader reader(journalFileName);
+		EventJournalRecord record;
+		EXPECT_FALSE(reader.ReadNext(record));
+	}
+}
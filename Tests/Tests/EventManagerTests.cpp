@@ -4,6 +4,7 @@
 #include <events/EventSubscriber.h>
 
 #include "gtest/gtest.h"
+#include <thread>
 using namespace std;
 namespace gamelib
 {
@@ -23,6 +24,23 @@ namespace gamelib
 		}
 	};
 
+	// Returns one secondary event per handled event, named after itself
+	class SecondaryEventSubscriber final : public EventSubscriber
+	{
+	public:
+		SecondaryEventSubscriber(std::string name, const SubscriberAffinity affinity) : name(std::move(name)), affinity(affinity) {}
+
+		std::vector<std::shared_ptr<Event>> HandleEvent(const std::shared_ptr<Event>& evt, const unsigned long deltaMs) override
+		{
+			return { make_shared<Event>(EventId(SubscriberEventHandled, name)) };
+		}
+		std::string GetSubscriberName() override { return name; }
+		SubscriberAffinity GetSubscriberAffinity() override { return affinity; }
+	private:
+		std::string name;
+		SubscriberAffinity affinity;
+	};
+
 	class EventManagerTests : public testing::Test 
 	{
 	 protected:
@@ -79,7 +97,7 @@ namespace gamelib
 		EXPECT_EQ(0, EventManager::Get()->CountReady()) << "Expected there to be no events waiting to be dispatched after processing all events";
 		EXPECT_TRUE(subscriber.HandleEventReceived) << "Subscriber was not notified after processing events";
 
-		const auto& all_event_subscribers = EventManager::Get()->GetSubscriptions()[Id];
+		const auto& all_event_subscribers = EventManager::Get()->GetSubscriptions().at(Id);
 		
 		EXPECT_EQ(1, all_event_subscribers.size()) << "Expect 1 subscriber to exist";
 		//EXPECT_STREQ(all_event_subscribers[0].lock()->GetSubscriberName().c_str(), subscriber->GetSubscriberName().c_str()) << "Our subscriber was not the subscription w eexepcted";
@@ -116,9 +134,362 @@ namespace gamelib
 		EventManager::Get()->SubscribeToEvent(Id, &subscriber);
 		EventManager::Get()->SubscribeToEvent(Id, &subscriber);
 
-		auto& all_event_subscribers = EventManager::Get()->GetSubscriptions();
+		const auto& all_event_subscribers = EventManager::Get()->GetSubscriptions();
+
+		EXPECT_EQ(all_event_subscribers.at(Id).size(), 1);
+
+	}
+
+	TEST_F(EventManagerTests, DispatchToUserDefinedEventId)
+	{
+		// Ids outside of EventNumbers (and ones with a secondary id) are still dispatched to their subscribers
+		const EventId userEventId(50, "UserEvent", 7);
+		EventManager::Get()->SubscribeToEvent(userEventId, &subscriber);
+		EventManager::Get()->DispatchEventToSubscriber(make_shared<Event>(userEventId), 0UL);
+
+		EXPECT_TRUE(subscriber.HandleEventReceived) << "Subscriber to a user-defined event id was not notified";
+	}
+
+	TEST_F(EventManagerTests, DispatchWithNoSubscribersDoesNotAddSubscription)
+	{
+		EventManager::Get()->DispatchEventToSubscriber(the_event, 0UL);
+
+		EXPECT_TRUE(the_event->Processed) << "The event was not marked as processed";
+		EXPECT_EQ(0, EventManager::Get()->GetSubscriptions().size()) << "Dispatching should not create an empty subscription";
+	}
+
+	TEST_F(EventManagerTests, ParallelDispatchMergesSecondaryEventsInSubscriptionOrder)
+	{
+		SecondaryEventSubscriber first("first", SubscriberAffinity::AnyThread);
+		SecondaryEventSubscriber second("second", SubscriberAffinity::MainThread);
+		SecondaryEventSubscriber third("third", SubscriberAffinity::AnyThread);
+		SecondaryEventSubscriber fourth("fourth", SubscriberAffinity::AnyThread);
+
+		EventManager::Get()->Reset();
+		EventManager::Get()->SetParallelDispatch(true, 2);
+		for (auto* pSubscriber : std::vector<IEventSubscriber*>{ &first, &second, &third, &fourth })
+		{
+			EventManager::Get()->SubscribeToEvent(Id, pSubscriber);
+		}
+
+		EventManager::Get()->DispatchEventToSubscriber(the_event, 0UL);
+		EventManager::Get()->SetParallelDispatch(false);
+
+		// Secondary events move onto the primary queue once processed
+		EventManager::Get()->ProcessAllEvents();
+		auto events = EventManager::Get()->GetEvents();
+		EventManager::Get()->Reset();
+
+		ASSERT_EQ(events.size(), 4) << "Expected a secondary event from each subscriber";
+		for (const auto* expectedOrigin : { "first", "second", "third", "fourth" })
+		{
+			EXPECT_EQ(events.front()->Origin, expectedOrigin) << "Secondary events were not merged in subscription order";
+			events.pop();
+		}
+		EXPECT_TRUE(the_event->Processed) << "The event was not marked as processed";
+	}
+
+	TEST_F(EventManagerTests, RaiseEventFromBackgroundThread)
+	{
+		EventManager::Get()->Reset();
+		EventManager::Get()->SubscribeToEvent(Id, &subscriber);
+
+		std::thread networkThread([&] { EventManager::Get()->RaiseEvent(the_event, &subscriber); });
+		networkThread.join();
+
+		EXPECT_EQ(1, EventManager::Get()->CountReady()) << "Expected the event to wait in the ingress queue";
+		EXPECT_FALSE(subscriber.HandleEventReceived) << "Events raised off the game loop thread should wait for processing";
+
+		EventManager::Get()->ProcessAllEvents();
+
+		EXPECT_TRUE(subscriber.HandleEventReceived) << "Subscriber was not notified of the event raised on another thread";
+		EXPECT_EQ(0, EventManager::Get()->CountReady());
+	}
+
+	// Counts the events it handles
+	class CountingSubscriber final : public EventSubscriber
+	{
+	public:
+		std::vector<std::shared_ptr<Event>> HandleEvent(const std::shared_ptr<Event>& evt, const unsigned long deltaMs) override
+		{
+			Handled.push_back(evt);
+			std::this_thread::sleep_for(HandleDelay);
+			return {};
+		}
+		std::string GetSubscriberName() override { return "counting_subscriber"; }
+		std::vector<std::shared_ptr<Event>> Handled;
+		std::chrono::microseconds HandleDelay {0};
+	};
+
+	TEST_F(EventManagerTests, CoalesceKeepLatest)
+	{
+		CountingSubscriber counter;
+		EventManager::Get()->Reset();
+		EventManager::Get()->SubscribeToEvent(Id, &counter);
+		EventManager::Get()->SetCoalescePolicy(Id, CoalescePolicy::KeepLatest);
+
+		const auto first = make_shared<UpdateAllGameObjectsEvent>();
+		const auto latest = make_shared<UpdateAllGameObjectsEvent>();
+		EventManager::Get()->RaiseEvent(first, &counter);
+		EventManager::Get()->RaiseEvent(latest, &counter);
+		EventManager::Get()->ProcessAllEvents();
+		EventManager::Get()->SetCoalescePolicy(Id, CoalescePolicy::KeepAll);
+
+		ASSERT_EQ(counter.Handled.size(), 1) << "Expected the superseded event to not be dispatched";
+		EXPECT_EQ(counter.Handled.front(), latest);
+	}
+
+	TEST_F(EventManagerTests, CoalesceKeepFirstByKey)
+	{
+		CountingSubscriber counter;
+		EventManager::Get()->Reset();
+		EventManager::Get()->SubscribeToEvent(Id, &counter);
+
+		// Key on the origin so that only duplicates from the same raiser are dropped
+		EventManager::Get()->SetCoalescePolicy(Id, CoalescePolicy::KeepFirst, [](const Event& event) { return std::hash<std::string>()(event.Origin); });
+
+		const auto first = make_shared<UpdateAllGameObjectsEvent>();
+		EventManager::Get()->RaiseEvent(first, &counter);
+		EventManager::Get()->RaiseEvent(make_shared<UpdateAllGameObjectsEvent>(), &counter);
+		EventManager::Get()->RaiseEvent(make_shared<UpdateAllGameObjectsEvent>(), &subscriber);
+		EventManager::Get()->ProcessAllEvents();
+
+		// Once dispatched, the same key can be raised again
+		EventManager::Get()->RaiseEvent(make_shared<UpdateAllGameObjectsEvent>(), &counter);
+		EventManager::Get()->ProcessAllEvents();
+		EventManager::Get()->SetCoalescePolicy(Id, CoalescePolicy::KeepAll);
+
+		ASSERT_EQ(counter.Handled.size(), 3) << "Expected one event per origin, then the later raise";
+		EXPECT_EQ(counter.Handled.front(), first);
+	}
+
+	TEST_F(EventManagerTests, CoalesceMerge)
+	{
+		CountingSubscriber counter;
+		EventManager::Get()->Reset();
+		EventManager::Get()->SubscribeToEvent(Id, &counter);
+		EventManager::Get()->SetCoalescePolicy(Id, CoalescePolicy::Merge, nullptr, [](Event& waiting, const Event& incoming)
+		{
+			waiting.Origin += "+" + incoming.Origin;
+		});
+
+		EventManager::Get()->RaiseEvent(make_shared<UpdateAllGameObjectsEvent>(), &counter);
+		EventManager::Get()->RaiseEvent(make_shared<UpdateAllGameObjectsEvent>(), &subscriber);
+		EventManager::Get()->ProcessAllEvents();
+		EventManager::Get()->SetCoalescePolicy(Id, CoalescePolicy::KeepAll);
+
+		ASSERT_EQ(counter.Handled.size(), 1);
+		EXPECT_EQ(counter.Handled.front()->Origin, "counting_subscriber+dummy_subscriber");
+		EXPECT_GT(EventManager::Get()->GetCoalescedCount(), 0);
+	}
+
+	TEST_F(EventManagerTests, SingletonEventsAreCoalesced)
+	{
+		CountingSubscriber counter;
+		EventManager::Get()->Reset();
+		EventManager::Get()->SubscribeToEvent(Id, &counter);
+
+		for (int i = 0; i < 3; i++)
+		{
+			const auto event = make_shared<UpdateAllGameObjectsEvent>();
+			event->IsSingleton = true;
+			EventManager::Get()->RaiseEvent(event, &counter);
+		}
+		EventManager::Get()->ProcessAllEvents();
+
+		EXPECT_EQ(counter.Handled.size(), 1) << "Expected only one singleton event to be dispatched";
+	}
+
+	TEST_F(EventManagerTests, HigherPriorityEventsDispatchFirst)
+	{
+		CountingSubscriber counter;
+		const EventId lowId(UpdateProcesses, "low");
+		EventManager::Get()->Reset();
+		EventManager::Get()->SubscribeToEvent(Id, &counter);
+		EventManager::Get()->SubscribeToEvent(lowId, &counter);
+		EventManager::Get()->SetEventPriority(lowId, EventPriority::Low);
+		EventManager::Get()->SetEventPriority(Id, EventPriority::High);
+
+		EventManager::Get()->RaiseEvent(make_shared<Event>(lowId), &counter);
+		EventManager::Get()->RaiseEvent(the_event, &counter);
+		EventManager::Get()->ProcessAllEvents();
+		EventManager::Get()->SetEventPriority(lowId, EventPriority::Normal);
+		EventManager::Get()->SetEventPriority(Id, EventPriority::Normal);
+
+		ASSERT_EQ(counter.Handled.size(), 2);
+		EXPECT_EQ(counter.Handled[0], the_event) << "Expected the high priority event first";
+		EXPECT_EQ(counter.Handled[1]->Id, lowId);
+		EXPECT_GE(EventManager::Get()->GetEventLatency(EventPriority::Low).GetCount(), 1) << "Expected the low priority latency to be recorded";
+	}
+
+	TEST_F(EventManagerTests, FrameBudgetDefersAndAgesLowPriorityEvents)
+	{
+		CountingSubscriber counter;
+		const EventId lowId(UpdateProcesses, "low");
+		const EventId criticalId(SceneLoaded, "critical");
+		EventManager::Get()->Reset();
+		EventManager::Get()->SubscribeToEvent(lowId, &counter);
+		EventManager::Get()->SubscribeToEvent(criticalId, &counter);
+		EventManager::Get()->SetEventPriority(lowId, EventPriority::Low);
+		EventManager::Get()->SetEventPriority(criticalId, EventPriority::Critical);
+
+		// A budget so small it is always exhausted: only critical events run, the low one is promoted a class per 2 frames
+		counter.HandleDelay = std::chrono::microseconds(100);
+		EventManager::Get()->SetFrameBudget(std::chrono::microseconds(1), 2);
+		EventManager::Get()->RaiseEvent(make_shared<Event>(lowId), &counter);
+		EventManager::Get()->RaiseEvent(make_shared<Event>(criticalId), &counter);
+
+		int frames = 0;
+		while (counter.Handled.size() < 2 && frames < 20)
+		{
+			EventManager::Get()->ProcessAllEvents();
+			frames++;
+		}
+		EventManager::Get()->SetFrameBudget(std::chrono::microseconds(0));
+		EventManager::Get()->SetEventPriority(lowId, EventPriority::Normal);
+		EventManager::Get()->SetEventPriority(criticalId, EventPriority::Normal);
+
+		ASSERT_EQ(counter.Handled.size(), 2) << "Expected the deferred event to eventually run";
+		EXPECT_EQ(counter.Handled[0]->Id, criticalId) << "Expected critical events to run despite the budget";
+		EXPECT_GT(frames, 1) << "Expected the low priority event to be deferred";
+	}
+
+	// Takes its events in batches and raises one secondary event per batch
+	class BatchSubscriber final : public EventSubscriber
+	{
+	public:
+		std::vector<std::shared_ptr<Event>> HandleEvent(const std::shared_ptr<Event>& evt, const unsigned long deltaMs) override { return {}; }
+		bool HandlesEventBatches() override { return true; }
+		void HandleEventBatch(const std::span<const std::shared_ptr<Event>> events, const unsigned long deltaMs, std::vector<std::shared_ptr<Event>>& secondaryEvents) override
+		{
+			BatchSizes.push_back(events.size());
+			secondaryEvents.push_back(make_shared<Event>(EventId(SubscriberEventHandled, "batch_handled")));
+		}
+		std::string GetSubscriberName() override { return "batch_subscriber"; }
+		std::vector<size_t> BatchSizes;
+	};
+
+	TEST_F(EventManagerTests, BatchSubscriberReceivesQueuedEventsOfOneTypeTogether)
+	{
+		BatchSubscriber batcher;
+		CountingSubscriber counter;
+		EventManager::Get()->Reset();
+		EventManager::Get()->SubscribeToEvent(Id, &batcher);
+		EventManager::Get()->SubscribeToEvent(Id, &counter);
+
+		for (int i = 0; i < 3; i++) { EventManager::Get()->RaiseEvent(make_shared<UpdateAllGameObjectsEvent>(), &counter); }
+		EventManager::Get()->ProcessAllEvents();
+
+		ASSERT_EQ(batcher.BatchSizes.size(), 1) << "Expected one call for all events of the type";
+		EXPECT_EQ(batcher.BatchSizes[0], 3);
+		EXPECT_EQ(counter.Handled.size(), 3) << "Expected other subscribers to still get one call per event";
+		EXPECT_EQ(EventManager::Get()->CountReady(), 1) << "Expected the batch's secondary event to be queued";
+	}
+
+	TEST_F(EventManagerTests, DirectDispatchToBatchSubscriberIsImmediate)
+	{
+		BatchSubscriber batcher;
+		EventManager::Get()->Reset();
+		EventManager::Get()->SubscribeToEvent(Id, &batcher);
+
+		EventManager::Get()->DispatchEventToSubscriber(the_event, 0UL);
+
+		ASSERT_EQ(batcher.BatchSizes.size(), 1) << "Expected a direct dispatch not to wait for the next ProcessAllEvents()";
+		EXPECT_EQ(batcher.BatchSizes[0], 1);
+	}
+
+	// Runs a callback when handling events
+	class CallbackSubscriber final : public EventSubscriber
+	{
+	public:
+		std::vector<std::shared_ptr<Event>> HandleEvent(const std::shared_ptr<Event>& evt, const unsigned long deltaMs) override
+		{
+			Handled++;
+			if (OnEvent) { OnEvent(); }
+			return {};
+		}
+		std::string GetSubscriberName() override { return "callback_subscriber"; }
+		std::function<void()> OnEvent;
+		int Handled = 0;
+	};
+
+	TEST_F(EventManagerTests, UnsubscribeWithHandle)
+	{
+		const auto handle = EventManager::Get()->SubscribeToEvent(Id, &subscriber);
+		EXPECT_TRUE(EventManager::Get()->IsSubscribed(handle));
+
+		EXPECT_TRUE(EventManager::Get()->Unsubscribe(handle));
+		EventManager::Get()->DispatchEventToSubscriber(the_event, 0UL);
+
+		EXPECT_FALSE(subscriber.HandleEventReceived) << "Expected an unsubscribed subscriber not to be notified";
+		EXPECT_FALSE(EventManager::Get()->Unsubscribe(handle)) << "Expected a handle to be stale once used";
+		EXPECT_EQ(EventManager::Get()->GetSubscriptions().at(Id).size(), 0);
+	}
+
+	TEST_F(EventManagerTests, StaleHandleDoesNotRemoveReusedSubscription)
+	{
+		CallbackSubscriber other;
+		const auto stale = EventManager::Get()->SubscribeToEvent(Id, &subscriber);
+		EventManager::Get()->Unsubscribe(stale);
+		const auto current = EventManager::Get()->SubscribeToEvent(Id, &other);
+
+		EXPECT_FALSE(EventManager::Get()->Unsubscribe(stale));
+		EXPECT_TRUE(EventManager::Get()->IsSubscribed(current)) << "Expected the stale handle to leave the new subscription alone";
+	}
+
+	TEST_F(EventManagerTests, SubscriptionChangesDuringDispatchAreDeferred)
+	{
+		CallbackSubscriber first, removed, added;
+		EventManager::Get()->SubscribeToEvent(Id, &first);
+		const auto removedHandle = EventManager::Get()->SubscribeToEvent(Id, &removed);
+		first.OnEvent = [&]
+		{
+			EventManager::Get()->Unsubscribe(removedHandle);
+			EventManager::Get()->SubscribeToEvent(Id, &added);
+		};
+
+		EventManager::Get()->DispatchEventToSubscriber(the_event, 0UL);
+		EXPECT_EQ(removed.Handled, 0) << "Expected a subscriber removed mid-dispatch not to be called";
+		EXPECT_EQ(added.Handled, 0) << "Expected a subscriber added mid-dispatch to wait for the next event";
+
+		first.OnEvent = nullptr;
+		EventManager::Get()->DispatchEventToSubscriber(make_shared<UpdateAllGameObjectsEvent>(), 0UL);
+		EXPECT_EQ(added.Handled, 1);
+		EXPECT_EQ(EventManager::Get()->GetSubscriptions().at(Id).size(), 2) << "Expected the removed subscription to be compacted away";
+	}
+
+	TEST_F(EventManagerTests, EventSubscriberUnsubscribesFromEvent)
+	{
+		CallbackSubscriber eventSubscriber;
+		eventSubscriber.SubscribeToEvent(Id);
+		eventSubscriber.UnsubscribeSubscribeToEvent(Id);
+		EventManager::Get()->DispatchEventToSubscriber(the_event, 0UL);
+
+		EXPECT_EQ(eventSubscriber.Handled, 0);
+		EXPECT_FALSE(eventSubscriber.SubscribesTo(Id));
+	}
+
+	TEST_F(EventManagerTests, UnsubscribeBySubscriberId)
+	{
+		class IdentifiedSubscriber final : public EventSubscriber
+		{
+		public:
+			std::vector<std::shared_ptr<Event>> HandleEvent(const std::shared_ptr<Event>& evt, const unsigned long deltaMs) override { return {}; }
+			std::string GetSubscriberName() override { return "identified_subscriber"; }
+			int GetSubscriberId() override { return 7; }
+		} identified;
+		const EventId otherId(Fire, "other");
+		const auto first = EventManager::Get()->SubscribeToEvent(Id, &identified);
+		const auto second = EventManager::Get()->SubscribeToEvent(otherId, &identified);
 
-		EXPECT_EQ(all_event_subscribers[Id].size(), 1);
+		EventManager::Get()->RemoveEventSubscription(7, Id);
+		EXPECT_FALSE(EventManager::Get()->IsSubscribed(first));
+		EXPECT_TRUE(EventManager::Get()->IsSubscribed(second)) << "Expected only the given event's subscription to be removed";
 
+		EventManager::Get()->SubscribeToEvent(Id, &identified);
+		EventManager::Get()->Unsubscribe(7);
+		EXPECT_FALSE(EventManager::Get()->IsSubscribed(second));
+		EXPECT_EQ(EventManager::Get()->GetSubscriptions().at(Id).size(), 0);
+		EXPECT_EQ(EventManager::Get()->GetSubscriptions().at(otherId).size(), 0);
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,61 @@
+#include "pch.h"
+#include "events/EventPool.h"
+#include "events/EventFactory.h"
+#include "events/UpdateAllGameObjectsEvent.h"
+#include "events/SceneChangedEvent.h"
+
+#include "gtest/gtest.h"
+using namespace std;
+namespace gamelib
+{
+	TEST(EventPoolTests, ReleasedEventMemoryIsReused)
+	{
+		const auto pool = EventPool<SceneChangedEvent>::Get();
+		pool->Reserve(1, 0);
+		pool->ResetStatistics();
+
+		const void* first;
+		{
+			const auto event = pool->Create(1);
+			first = event.get();
+		}
+		const auto second = pool->Create(2);
+
+		EXPECT_EQ(first, second.get()) << "Expected the released block to be reused";
+		EXPECT_EQ(second->SceneId, 2) << "Expected a freshly constructed event";
+		EXPECT_EQ(pool->GetStatistics().Hits, 2);
+		EXPECT_EQ(pool->GetStatistics().Misses, 0);
+	}
+
+	TEST(EventPoolTests, OutstandingEventsMissThePool)
+	{
+		const auto pool = EventPool<SceneChangedEvent>::Get();
+		pool->ResetStatistics();
+		const auto freeBlocks = pool->GetStatistics().FreeBlocks;
+
+		vector<shared_ptr<SceneChangedEvent>> events;
+		for (size_t i = 0; i < freeBlocks + 1; i++) { events.push_back(pool->Create(static_cast<int>(i))); }
+
+		EXPECT_EQ(pool->GetStatistics().Hits, freeBlocks);
+		EXPECT_EQ(pool->GetStatistics().Misses, 1);
+
+		events.clear();
+		EXPECT_EQ(pool->GetStatistics().FreeBlocks, freeBlocks + 1) << "Expected all blocks to be returned to the pool";
+	}
+
+	TEST(EventPoolTests, FactoryEventsArePooled)
+	{
+		const auto pool = EventPool<UpdateAllGameObjectsEvent>::Get();
+		{ auto warmUp = EventFactory::CreateUpdateAllGameObjectsEvent(); }
+		pool->ResetStatistics();
+
+		for (int tick = 0; tick < 10; tick++)
+		{
+			const auto event = EventFactory::CreateUpdateAllGameObjectsEvent();
+			EXPECT_EQ(event->Id, UpdateAllGameObjectsEventTypeEventId);
+		}
+
+		EXPECT_EQ(pool->GetStatistics().Misses, 0) << "Expected steady state event creation to not allocate";
+		EXPECT_EQ(pool->GetStatistics().Hits, 10);
+	}
+}
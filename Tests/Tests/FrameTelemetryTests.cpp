@@ -0,0 +1,136 @@
+#include "pch.h"
+#include "structure/FrameTelemetry.h"
+
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+using namespace std;
+namespace gamelib
+{
+	class FrameTelemetryTests : public testing::Test
+	{
+	public:
+		void SetUp() override
+		{
+			telemetry = make_unique<FrameTelemetry>(50000, 1000);
+			telemetry->SetClock([&] { return clockUs; });
+		}
+
+		// A frame whose stages take the given times, one after the other
+		void RunFrame(const uint64_t inputUs, const uint64_t networkUs, const uint64_t updateUs, const uint64_t drawUs) const
+		{
+			const vector<pair<FrameStage, uint64_t>> stages { { FrameStage::Input, inputUs }, { FrameStage::Network, networkUs }, { FrameStage::Update, updateUs }, { FrameStage::Draw, drawUs } };
+			for (const auto& [stage, durationUs] : stages)
+			{
+				const auto timer = telemetry->TimeStage(stage);
+				clockUs += durationUs;
+			}
+			telemetry->EndFrame();
+		}
+
+		mutable uint64_t clockUs = 1000000;
+		unique_ptr<FrameTelemetry> telemetry;
+	};
+
+	TEST_F(FrameTelemetryTests, RecordsFrameAndStageTimes)
+	{
+		for (auto frame = 0; frame < 10; frame++) { RunFrame(100, 200, 5000, 8000); }
+
+		EXPECT_EQ(telemetry->GetFrameCount(), 10);
+		EXPECT_EQ(telemetry->GetFrameHistogram().GetCount(), 10);
+		EXPECT_EQ(telemetry->GetFrameHistogram().GetMax(), 13300);
+		EXPECT_EQ(telemetry->GetStageHistogram(FrameStage::Input).GetMax(), 100);
+		EXPECT_EQ(telemetry->GetStageHistogram(FrameStage::Draw).GetMax(), 8000);
+		EXPECT_EQ(telemetry->GetStallCount(), 0);
+	}
+
+	TEST_F(FrameTelemetryTests, StagesAddUpOverAFrame)
+	{
+		// e.g. a fixed-step loop catching up with two updates before drawing
+		{ const auto timer = telemetry->TimeStage(FrameStage::Update); clockUs += 3000; }
+		{ const auto timer = telemetry->TimeStage(FrameStage::Update); clockUs += 4000; }
+		telemetry->EndFrame();
+
+		EXPECT_EQ(telemetry->GetStageHistogram(FrameStage::Update).GetMax(), 7000);
+	}
+
+	TEST_F(FrameTelemetryTests, StallsNameTheStageThatOverran)
+	{
+		vector<FrameStall> reported;
+		telemetry->SetStallCallback([&](const FrameStall& stall) { reported.push_back(stall); });
+
+		// Drawing usually takes longest, but a network stall makes the frame late
+		for (auto frame = 0; frame < 5; frame++) { RunFrame(100, 200, 5000, 20000); }
+		RunFrame(100, 40000, 5000, 20000);
+
+		ASSERT_EQ(reported.size(), 1);
+		EXPECT_EQ(reported[0].FrameNumber, 5);
+		EXPECT_EQ(reported[0].FrameUs, 65100);
+		EXPECT_EQ(reported[0].StageUs[static_cast<size_t>(FrameStage::Network)], 40000);
+		EXPECT_EQ(reported[0].Culprit, FrameStage::Network);
+		EXPECT_EQ(telemetry->GetStallCount(), 1);
+		EXPECT_EQ(telemetry->GetRecentStalls().size(), 1);
+	}
+
+	TEST_F(FrameTelemetryTests, StallsOutsideEveryStageAreBlamedOnUntimedTime)
+	{
+		vector<FrameStall> reported;
+		telemetry->SetStallCallback([&](const FrameStall& stall) { reported.push_back(stall); });
+
+		// e.g. a long sleep or vsync wait after drawing, while every stage took its usual time
+		for (auto frame = 0; frame < 5; frame++) { RunFrame(100, 200, 5000, 8000); }
+		{ const auto timer = telemetry->TimeStage(FrameStage::Input); clockUs += 100; }
+		{ const auto timer = telemetry->TimeStage(FrameStage::Network); clockUs += 200; }
+		{ const auto timer = telemetry->TimeStage(FrameStage::Update); clockUs += 5000; }
+		{ const auto timer = telemetry->TimeStage(FrameStage::Draw); clockUs += 8000; }
+		clockUs += 60000;
+		telemetry->EndFrame();
+
+		ASSERT_EQ(reported.size(), 1);
+		EXPECT_EQ(reported[0].UntimedUs, 60000);
+		EXPECT_EQ(reported[0].Culprit, FrameStage::Untimed) << "Expected no timed stage to be blamed";
+		EXPECT_EQ(telemetry->GetUntimedHistogram().GetMax(), 60000);
+	}
+
+	TEST_F(FrameTelemetryTests, StallsWhereNothingOverranHaveNoCulprit)
+	{
+		vector<FrameStall> reported;
+		telemetry->SetStallCallback([&](const FrameStall& stall) { reported.push_back(stall); });
+
+		// Every frame is slow, so the stalled one is no slower than usual
+		for (auto frame = 0; frame < 5; frame++) { RunFrame(100, 200, 5000, 60000); }
+
+		ASSERT_EQ(reported.size(), 5);
+		EXPECT_EQ(reported.back().Culprit, FrameStage::None);
+		EXPECT_STREQ(FrameTelemetry::GetStageName(reported.back().Culprit), "none");
+	}
+
+	TEST_F(FrameTelemetryTests, WritesSummariesEveryInterval)
+	{
+		vector<string> summaries;
+		telemetry->SetSummaryCallback([&](const string& summary) { summaries.push_back(summary); });
+		const string fileName = "FrameTelemetryTests.log";
+		telemetry->SetSummaryFile(fileName);
+
+		// 60 frames of 16ms, then a late one that ends the one second interval
+		for (auto frame = 0; frame < 60; frame++) { RunFrame(0, 0, 6000, 10000); }
+		EXPECT_TRUE(summaries.empty());
+		RunFrame(0, 0, 6000, 60000);
+
+		ASSERT_EQ(summaries.size(), 1);
+		EXPECT_EQ(summaries[0].rfind("frames=61 stalls=1 frame_us=", 0), 0) << summaries[0];
+		EXPECT_NE(summaries[0].find("/66000 "), string::npos) << "Expected the maximum frame time: " << summaries[0];
+		EXPECT_NE(summaries[0].find(" draw_us="), string::npos);
+		EXPECT_EQ(telemetry->GetFrameHistogram().GetCount(), 0) << "Expected the histograms to start over";
+
+		telemetry->SetSummaryFile("");
+		ifstream file(fileName);
+		string line;
+		getline(file, line);
+		EXPECT_NE(line.find(summaries[0]), string::npos);
+		file.close();
+		remove(fileName.c_str());
+	}
+}
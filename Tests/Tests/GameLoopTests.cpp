@@ -0,0 +1,427 @@
+#include "pch.h"
+#include "asset/asset.h"
+#include "events/EventManager.h"
+#include "events/SceneChangedEvent.h"
+#include "exceptions/EngineException.h"
+#include "objects/GameWorldData.h"
+#include "resource/ResourceManager.h"
+#include "structure/HeadlessGameLoop.h"
+#include "structure/InterpolatedGameLoop.h"
+#include "structure/PipelinedGameLoop.h"
+
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+using namespace std;
+namespace gamelib
+{
+	// Drives an InterpolatedGameLoop from a fake clock that advances as each frame draws
+	class InterpolatedGameLoopTests : public testing::Test
+	{
+	public:
+		void SetUp() override
+		{
+			gameWorldData.ElapsedGameTime = 0;
+		}
+
+		unique_ptr<InterpolatedGameLoop> MakeLoop(const uint64_t timeStepUs, const unsigned int maxCatchUpSteps = 5, const uint64_t frameTimeUs = 0)
+		{
+			auto loop = make_unique<InterpolatedGameLoop>(timeStepUs,
+				[&](const unsigned long deltaMs) { updates.push_back(deltaMs); },
+				[&](const float alpha)
+				{
+					// Drawing is where the frame spends its time
+					clockUs += frameCostsUs[min(alphas.size(), frameCostsUs.size() - 1)];
+					alphas.push_back(alpha);
+					gameWorldData.IsGameDone = alphas.size() == framesToRun;
+				},
+				[&](unsigned long) { inputs++; },
+				maxCatchUpSteps, frameTimeUs);
+
+			loop->SetClock([&] { return clockUs; }, [&](const uint64_t durationUs) { sleeps.push_back(durationUs); clockUs += durationUs; });
+			return loop;
+		}
+
+		GameWorldData gameWorldData;
+		uint64_t clockUs = 1000000;
+		vector<uint64_t> frameCostsUs { 0 };
+		size_t framesToRun = 0;
+		vector<unsigned long> updates;
+		vector<float> alphas;
+		vector<uint64_t> sleeps;
+		int inputs = 0;
+	};
+
+	TEST_F(InterpolatedGameLoopTests, UpdatesInFixedStepsAndDrawsWithTheRemainder)
+	{
+		// 10ms frames with 4ms steps: 2, 3, 2, 3 steps and so on
+		frameCostsUs = { 10000 };
+		framesToRun = 5;
+		const auto loop = MakeLoop(4000);
+
+		loop->Loop(&gameWorldData);
+
+		// The first frame starts as the loop does, so has no time to update
+		ASSERT_EQ(alphas.size(), 5);
+		EXPECT_FLOAT_EQ(alphas[0], 0.0f);
+		EXPECT_FLOAT_EQ(alphas[1], 0.5f);
+		EXPECT_FLOAT_EQ(alphas[2], 0.0f);
+		EXPECT_FLOAT_EQ(alphas[3], 0.5f);
+		EXPECT_FLOAT_EQ(alphas[4], 0.0f);
+		EXPECT_EQ(updates, vector<unsigned long>(10, 4));
+		EXPECT_EQ(loop->GetUpdateCount(), 10);
+		EXPECT_EQ(gameWorldData.ElapsedGameTime, 40);
+	}
+
+	TEST_F(InterpolatedGameLoopTests, SamplesInputOncePerUpdate)
+	{
+		// Frames much shorter than a step mostly have nothing to update
+		frameCostsUs = { 1000 };
+		framesToRun = 33;
+		const auto loop = MakeLoop(16000);
+
+		loop->Loop(&gameWorldData);
+
+		EXPECT_EQ(updates.size(), 2);
+		EXPECT_EQ(inputs, 2);
+	}
+
+	TEST_F(InterpolatedGameLoopTests, CatchUpIsCapped)
+	{
+		// A one second stall in the second frame, then 10ms frames
+		frameCostsUs = { 10000, 1000000, 10000 };
+		framesToRun = 4;
+		const auto loop = MakeLoop(10000, 4);
+
+		loop->Loop(&gameWorldData);
+
+		// Without the cap the stall would take 100 updates
+		EXPECT_EQ(updates.size(), 1 + 4 + 1);
+		EXPECT_EQ(loop->GetDroppedTimeUs(), 1000000 - 4 * 10000);
+		EXPECT_FLOAT_EQ(alphas.back(), 0.0f);
+	}
+
+	TEST_F(InterpolatedGameLoopTests, StepsShorterThanAMillisecondStillAddUp)
+	{
+		// 60Hz is 16.667ms: deltas of 16 and 17ms which add up to the simulated time
+		frameCostsUs = { 16667 * 3 };
+		framesToRun = 5;
+		const auto loop = MakeLoop(16667);
+
+		loop->Loop(&gameWorldData);
+
+		ASSERT_EQ(updates.size(), 12);
+		EXPECT_EQ(accumulate(updates.begin(), updates.end(), 0UL), 16667 * 12 / 1000);
+		for (const auto deltaMs : updates) { EXPECT_TRUE(deltaMs == 16 || deltaMs == 17); }
+	}
+
+	TEST_F(InterpolatedGameLoopTests, SleepsOutTheRestOfTheFrame)
+	{
+		// Frames that take 3ms of a 10ms frame time
+		frameCostsUs = { 3000 };
+		framesToRun = 4;
+		const auto loop = MakeLoop(10000, 5, 10000);
+
+		loop->Loop(&gameWorldData);
+
+		EXPECT_EQ(sleeps, vector<uint64_t>(4, 7000));
+		EXPECT_EQ(updates.size(), 3) << "Expected paced frames to run one step each";
+	}
+
+	TEST_F(InterpolatedGameLoopTests, TimeStepMustNotBeZero)
+	{
+		EXPECT_THROW(MakeLoop(0), EngineException);
+	}
+
+	TEST(RenderPacketBufferTests, WriterCanOnlyGetAheadByThePacketCount)
+	{
+		RenderPacketBuffer buffer(2);
+		for (auto frame = 0; frame < 2; frame++)
+		{
+			buffer.BeginWrite()->FrameNumber = frame;
+			buffer.EndWrite();
+		}
+		EXPECT_EQ(buffer.GetReadyCount(), 2);
+
+		// Both packets are taken, so the next write waits for the reader
+		atomic<bool> written = false;
+		thread writer([&]
+		{
+			buffer.BeginWrite()->FrameNumber = 2;
+			buffer.EndWrite();
+			written = true;
+		});
+
+		const auto* packet = buffer.BeginRead();
+		EXPECT_EQ(packet->FrameNumber, 0);
+		this_thread::sleep_for(chrono::milliseconds(20));
+		EXPECT_FALSE(written) << "Expected the writer to wait while the reader has the packet";
+
+		buffer.EndRead();
+		writer.join();
+		EXPECT_TRUE(written);
+
+		for (const auto expected : { 1, 2 })
+		{
+			EXPECT_EQ(buffer.BeginRead()->FrameNumber, expected);
+			buffer.EndRead();
+		}
+		EXPECT_EQ(buffer.BeginRead(false), nullptr);
+	}
+
+	TEST(RenderPacketBufferTests, ClosingWakesTheReaderAfterTheLastPacket)
+	{
+		RenderPacketBuffer buffer(3);
+		buffer.BeginWrite()->FrameNumber = 7;
+		buffer.EndWrite();
+
+		thread closer([&] { this_thread::sleep_for(chrono::milliseconds(10)); buffer.Close(); });
+
+		ASSERT_NE(buffer.BeginRead(), nullptr);
+		buffer.EndRead();
+		EXPECT_EQ(buffer.BeginRead(), nullptr) << "Expected closing to wake the waiting reader";
+		EXPECT_EQ(buffer.BeginWrite(), nullptr);
+		closer.join();
+
+		buffer.Reset();
+		EXPECT_NE(buffer.BeginWrite(), nullptr);
+	}
+
+	TEST(RenderPacketBufferTests, NeedsAtLeastTwoPackets)
+	{
+		EXPECT_THROW(RenderPacketBuffer buffer(1), EngineException);
+	}
+
+	TEST(RenderPacketTests, DrawsCommandsForObjectsThatDrawThemselves)
+	{
+		RenderPacket packet;
+		auto commands = 0;
+		RenderItem item;
+		item.Command = [&](SDL_Renderer*) { commands++; };
+		packet.Items.push_back(item);
+		item.IsVisible = false;
+		packet.Items.push_back(item);
+
+		packet.Draw(nullptr);
+
+		EXPECT_EQ(commands, 1) << "Expected only the visible item's command to be drawn";
+	}
+
+	TEST(RenderRetireQueueTests, ReleasesOnceEveryPacketThatMayUseItIsDrawn)
+	{
+		RenderRetireQueue queue;
+		vector<int> released;
+
+		queue.Retire([&] { released.push_back(1); });
+		EXPECT_EQ(released, vector { 1 }) << "Expected resources to be released straight away when not deferring";
+
+		queue.SetDeferring(true);
+		queue.SetSimulatedFrame(3);
+		queue.Retire([&] { released.push_back(2); });
+		queue.SetSimulatedFrame(4);
+		queue.Retire([&] { released.push_back(3); });
+
+		queue.ReleaseDrawn(1);
+		EXPECT_EQ(queue.GetRetiredCount(), 2) << "Expected packet 2 may still use both";
+
+		queue.ReleaseDrawn(2);
+		EXPECT_EQ(released, (vector { 1, 2 }));
+
+		queue.SetDeferring(false);
+		EXPECT_EQ(released, (vector { 1, 2, 3 })) << "Expected the rest to be released once no longer deferring";
+		EXPECT_EQ(queue.GetRetiredCount(), 0);
+	}
+
+	TEST(PipelinedGameLoopTests, DrawsEverySimulatedFrameOnTheCallingThreadWhileTheNextIsSimulated)
+	{
+		constexpr auto frames = 10;
+		GameWorldData gameWorldData;
+		gameWorldData.ElapsedGameTime = 0;
+
+		auto position = 0;
+		atomic<bool> drawing = false;
+		atomic<int> updatesWhileDrawing = 0;
+		thread::id updateThread;
+		vector<thread::id> drawThreads;
+		vector<pair<uint64_t, int>> drawn;
+		vector<thread::id> inputThreads;
+
+		PipelinedGameLoop loop([&](unsigned long)
+			{
+				updateThread = this_thread::get_id();
+				if (drawing) { ++updatesWhileDrawing; }
+				position += 10;
+				gameWorldData.IsGameDone = position == frames * 10;
+			},
+			[&](RenderPacket& packet)
+			{
+				RenderItem item;
+				item.Destination.x = position;
+				packet.Items.push_back(item);
+			},
+			[&](const RenderPacket& packet)
+			{
+				drawing = true;
+				drawThreads.push_back(this_thread::get_id());
+				drawn.emplace_back(packet.FrameNumber, packet.Items.at(0).Destination.x);
+				this_thread::sleep_for(chrono::milliseconds(5));
+				drawing = false;
+			},
+			[&](unsigned long) { inputThreads.push_back(this_thread::get_id()); });
+
+		loop.Loop(&gameWorldData);
+
+		ASSERT_EQ(drawn.size(), frames);
+		for (auto frame = 0; frame < frames; frame++)
+		{
+			EXPECT_EQ(drawn[frame], make_pair(static_cast<uint64_t>(frame), (frame + 1) * 10)) << "Expected each packet to hold its own frame's state";
+		}
+		EXPECT_EQ(drawThreads, vector<thread::id>(frames, this_thread::get_id()));
+		EXPECT_NE(updateThread, this_thread::get_id());
+		ASSERT_FALSE(inputThreads.empty());
+		EXPECT_EQ(inputThreads, vector<thread::id>(inputThreads.size(), this_thread::get_id())) << "Expected input to be sampled on the calling thread";
+		EXPECT_GT(updatesWhileDrawing, 0) << "Expected frames to be simulated while the last was drawn";
+		EXPECT_EQ(loop.GetFramesSimulated(), frames);
+		EXPECT_EQ(loop.GetFramesDrawn(), frames);
+	}
+
+	TEST(PipelinedGameLoopTests, ErrorsOnEitherThreadStopTheLoop)
+	{
+		GameWorldData gameWorldData;
+		gameWorldData.ElapsedGameTime = 0;
+		auto updates = 0;
+
+		PipelinedGameLoop failingUpdate([&](unsigned long) { if (++updates == 3) { throw runtime_error("update failed"); } },
+			[](RenderPacket&) {}, [](const RenderPacket&) {}, [](unsigned long) {});
+		EXPECT_THROW(failingUpdate.Loop(&gameWorldData), runtime_error);
+		EXPECT_EQ(failingUpdate.GetFramesDrawn(), 2) << "Expected the frames before the error to still be drawn";
+
+		auto draws = 0;
+		PipelinedGameLoop failingDraw([](unsigned long) {}, [](RenderPacket&) {},
+			[&](const RenderPacket&) { if (++draws == 3) { throw runtime_error("draw failed"); } }, [](unsigned long) {});
+		EXPECT_THROW(failingDraw.Loop(&gameWorldData), runtime_error);
+		EXPECT_FALSE(gameWorldData.IsGameDone);
+	}
+
+	// Records the threads it was decoded and uploaded on
+	class UploadThreadAsset final : public Asset
+	{
+	public:
+		UploadThreadAsset() : Asset(100, "uploadThreadAsset", "upload.bin", "fake", 5) { }
+
+		void Load() override { Decode(); Upload(); }
+		bool Unload() override { IsLoadedInMemory = false; return true; }
+		void Decode() override { DecodedOn = this_thread::get_id(); }
+
+		void Upload() override
+		{
+			UploadedOn = this_thread::get_id();
+			IsLoadedInMemory = true;
+		}
+
+		atomic<thread::id> DecodedOn;
+		atomic<thread::id> UploadedOn;
+	};
+
+	TEST(PipelinedGameLoopTests, UploadsLoadedAssetsOnTheCallingThread)
+	{
+		ResourceManager::Get()->Reset();
+		const auto asset = make_shared<UploadThreadAsset>();
+		ResourceManager::Get()->AddAsset(asset);
+
+		GameWorldData gameWorldData;
+		gameWorldData.ElapsedGameTime = 0;
+		auto updates = 0;
+		auto loadedOnSimulationThread = false;
+
+		// Scene changes load in the background, even with async loading off, and are finished by a later update
+		PipelinedGameLoop loop([&](unsigned long)
+			{
+				if (++updates == 1) { ResourceManager::Get()->HandleEvent(make_shared<SceneChangedEvent>(5), 0); }
+				loadedOnSimulationThread = ResourceManager::Get()->GetResidency().IsResident(asset->Uid);
+				gameWorldData.IsGameDone = loadedOnSimulationThread || updates == 5000;
+			},
+			[](RenderPacket&) {}, [](const RenderPacket&) {}, [](unsigned long) {});
+		loop.Loop(&gameWorldData);
+
+		EXPECT_TRUE(loadedOnSimulationThread);
+		EXPECT_NE(asset->DecodedOn.load(), this_thread::get_id());
+		EXPECT_EQ(asset->UploadedOn.load(), this_thread::get_id()) << "Expected the upload on the thread that owns the renderer";
+		EXPECT_FALSE(ResourceManager::Get()->IsRenderThreadUploads());
+
+		ResourceManager::Get()->SetAsyncLoading(0);
+		ResourceManager::Get()->Reset();
+		EventManager::Get()->ProcessAllEvents();
+	}
+
+	TEST(HeadlessGameLoopTests, FixedTickRateSleepsUntilEachTickIsDue)
+	{
+		GameWorldData gameWorldData;
+		gameWorldData.ElapsedGameTime = 0;
+		uint64_t clockUs = 1000000;
+		vector<uint64_t> sleeps;
+		vector<unsigned long> updates;
+
+		// 30 ticks a second, with updates taking 10ms
+		HeadlessGameLoop loop([&](const unsigned long deltaMs)
+		{
+			updates.push_back(deltaMs);
+			clockUs += 10000;
+			gameWorldData.IsGameDone = updates.size() == 3;
+		}, 33333);
+		loop.SetClock([&] { return clockUs; }, [&](const uint64_t durationUs) { sleeps.push_back(durationUs); clockUs += durationUs; });
+
+		loop.Loop(&gameWorldData);
+
+		EXPECT_EQ(sleeps, (vector<uint64_t> { 33333, 23333, 23333 }));
+		EXPECT_EQ(updates, (vector<unsigned long> { 33, 33, 33 }));
+		EXPECT_EQ(gameWorldData.ElapsedGameTime, 99);
+	}
+
+	TEST(HeadlessGameLoopTests, TicksTooLateAreDropped)
+	{
+		GameWorldData gameWorldData;
+		gameWorldData.ElapsedGameTime = 0;
+		uint64_t clockUs = 0;
+
+		// The first update stalls for 20 ticks
+		HeadlessGameLoop loop([&](unsigned long)
+		{
+			clockUs += clockUs < 20000 ? 200000 : 0;
+			gameWorldData.IsGameDone = clockUs > 250000;
+		}, 10000, 5);
+		loop.SetClock([&] { return clockUs; }, [&](const uint64_t durationUs) { clockUs += durationUs; });
+
+		loop.Loop(&gameWorldData);
+
+		EXPECT_EQ(loop.GetDroppedTicks(), 19);
+		EXPECT_LT(loop.GetUpdateCount(), 10) << "Expected missed ticks not to be run back to back";
+	}
+
+	TEST(HeadlessGameLoopTests, UncappedUpdatesBackToBackWithTheTimePassed)
+	{
+		GameWorldData gameWorldData;
+		gameWorldData.ElapsedGameTime = 0;
+		uint64_t clockUs = 0;
+		auto slept = false;
+		vector<unsigned long> updates;
+
+		// Updates taking 1.5ms
+		HeadlessGameLoop loop([&](const unsigned long deltaMs)
+		{
+			updates.push_back(deltaMs);
+			clockUs += 1500;
+			gameWorldData.IsGameDone = updates.size() == 5;
+		});
+		loop.SetClock([&] { return clockUs; }, [&](uint64_t) { slept = true; });
+
+		loop.Loop(&gameWorldData);
+
+		EXPECT_FALSE(slept);
+		EXPECT_EQ(updates, (vector<unsigned long> { 0, 1, 2, 1, 2 }));
+	}
+}
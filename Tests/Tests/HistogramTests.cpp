@@ -0,0 +1,50 @@
+#include "pch.h"
+
+#include <gtest/gtest.h>
+
+#include "utils/Histogram.h"
+
+namespace gamelib
+{
+	TEST(HistogramTests, SmallValuesAreExact)
+	{
+		Histogram histogram;
+		for (uint64_t value = 1; value <= 10; value++) { histogram.Record(value); }
+
+		EXPECT_EQ(histogram.GetCount(), 10);
+		EXPECT_EQ(histogram.GetMin(), 1);
+		EXPECT_EQ(histogram.GetMax(), 10);
+		EXPECT_EQ(histogram.GetPercentile(50), 5);
+		EXPECT_EQ(histogram.GetPercentile(100), 10);
+		EXPECT_DOUBLE_EQ(histogram.GetMean(), 5.5);
+	}
+
+	TEST(HistogramTests, LargeValuesAreWithinPrecision)
+	{
+		Histogram histogram;
+		for (uint64_t value = 1; value <= 100000; value++) { histogram.Record(value); }
+
+		// Buckets are 1/16th of their power of two wide, so values are within ~6%
+		const auto p99 = histogram.GetPercentile(99);
+		EXPECT_GE(p99, 99000);
+		EXPECT_LE(p99, 99000 + 99000 / 16);
+		EXPECT_EQ(histogram.GetPercentile(100), 100000) << "Expected percentiles to be capped at the maximum recorded";
+	}
+
+	TEST(HistogramTests, MergeAndReset)
+	{
+		Histogram first;
+		Histogram second;
+		first.Record(10);
+		second.Record(1000, 3);
+
+		first.Merge(second);
+		EXPECT_EQ(first.GetCount(), 4);
+		EXPECT_EQ(first.GetMax(), 1000);
+		EXPECT_EQ(first.GetMin(), 10);
+
+		first.Reset();
+		EXPECT_EQ(first.GetCount(), 0);
+		EXPECT_EQ(first.GetPercentile(99), 0);
+	}
+}
@@ -0,0 +1,82 @@
+#include "pch.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "utils/MpscRingBuffer.h"
+
+namespace gamelib
+{
+	class MpscRingBufferTests : public testing::Test
+	{
+	public:	
+
+		void SetUp() override
+		{
+		}
+
+		void TearDown() override
+		{
+		}
+	};
+
+	TEST_F(MpscRingBufferTests, FullBufferDropsAndRecordsHighWaterMark)
+	{
+		MpscRingBuffer<int> buffer(4);
+
+		for (int i = 0; i < 6; i++) { buffer.TryPush(i); }
+
+		const auto statistics = buffer.GetStatistics();
+		EXPECT_EQ(statistics.Capacity, 4);
+		EXPECT_EQ(statistics.Pushed, 4);
+		EXPECT_EQ(statistics.Dropped, 2) << "Expected pushes beyond capacity to be dropped";
+		EXPECT_EQ(statistics.HighWaterMark, 4);
+
+		int item;
+		for (int expected = 0; expected < 4; expected++)
+		{
+			ASSERT_TRUE(buffer.TryPop(item));
+			EXPECT_EQ(item, expected) << "Expected items in the order they were pushed";
+		}
+		EXPECT_FALSE(buffer.TryPop(item)) << "Expected buffer to be empty";
+		EXPECT_TRUE(buffer.TryPush(4)) << "Expected popped slots to be reusable";
+	}
+
+	TEST_F(MpscRingBufferTests, ConcurrentProducersLoseNothing)
+	{
+		constexpr int producerCount = 4;
+		constexpr int itemsPerProducer = 10000;
+		MpscRingBuffer<int> buffer(256);
+
+		std::vector<std::thread> producers;
+		for (int producer = 0; producer < producerCount; producer++)
+		{
+			producers.emplace_back([&buffer, producer]
+			{
+				for (int i = 0; i < itemsPerProducer; i++)
+				{
+					while (!buffer.TryPush(producer * itemsPerProducer + i)) { std::this_thread::yield(); }
+				}
+			});
+		}
+
+		// Each producer's items must arrive in the order that producer pushed them
+		std::vector<int> lastSeen(producerCount, -1);
+		int received = 0;
+		while (received < producerCount * itemsPerProducer)
+		{
+			int item;
+			if (!buffer.TryPop(item)) { std::this_thread::yield(); continue; }
+
+			const auto producer = item / itemsPerProducer;
+			EXPECT_GT(item % itemsPerProducer, lastSeen[producer]);
+			lastSeen[producer] = item % itemsPerProducer;
+			received++;
+		}
+
+		for (auto& producer : producers) { producer.join(); }
+		EXPECT_EQ(buffer.Size(), 0);
+		EXPECT_LE(buffer.GetStatistics().HighWaterMark, 256);
+	}
+}
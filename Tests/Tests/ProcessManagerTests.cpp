@@ -0,0 +1,390 @@
+#include "pch.h"
+#include "processes/Action.h"
+#include "processes/DelayProcess.h"
+#include "processes/ProcessManager.h"
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+using namespace std;
+namespace gamelib
+{
+	// Counts down its updates on whichever thread updates it, and records the threads it was updated and called back on
+	class CountdownProcess final : public Process
+	{
+	public:
+		CountdownProcess(const int updates, const ProcessAffinity affinity, vector<int>* completions = nullptr, const int id = 0)
+			: updatesLeft(updates), affinity(affinity), completions(completions), id(id) {}
+
+		[[nodiscard]] ProcessAffinity GetAffinity() const override { return affinity; }
+
+		thread::id UpdateThread;
+		thread::id SuccessThread;
+	protected:
+		void OnUpdate(unsigned long deltaMs) override
+		{
+			UpdateThread = this_thread::get_id();
+			if (--updatesLeft == 0) { Succeed(); }
+		}
+
+		void OnSuccess() override
+		{
+			SuccessThread = this_thread::get_id();
+			if (completions) { completions->push_back(id); }
+		}
+	private:
+		int updatesLeft;
+		ProcessAffinity affinity;
+		vector<int>* completions;
+		int id;
+	};
+
+	TEST(ProcessManagerTests, SerialUpdateChainsChildren)
+	{
+		ProcessManager processManager;
+		int childRuns = 0;
+
+		const auto parent = make_shared<Action>([](unsigned long) {});
+		parent->AttachChild(make_shared<Action>([&](unsigned long) { childRuns++; }));
+		processManager.AttachProcess(parent);
+
+		EXPECT_EQ(processManager.UpdateProcesses(10).Succeeded, 0) << "Expected a parent with a child not to count as a success";
+		EXPECT_EQ(processManager.UpdateProcesses(10).Succeeded, 1);
+		EXPECT_EQ(childRuns, 1);
+		EXPECT_EQ(processManager.GetProcessCount(), 0);
+	}
+
+	TEST(ProcessManagerTests, ParallelUpdateRunsEveryProcess)
+	{
+		ProcessManager processManager;
+		processManager.SetParallelUpdate(true, 3);
+		EXPECT_TRUE(processManager.IsParallelUpdate());
+
+		atomic<int> anyThreadUpdates = 0;
+		int ownerThreadUpdates = 0;
+		for (int i = 0; i < 200; i++)
+		{
+			processManager.AttachProcess(make_shared<Action>([&](unsigned long) { ++anyThreadUpdates; }, false, ProcessAffinity::AnyThread));
+		}
+		processManager.AttachProcess(make_shared<Action>([&](unsigned long) { ownerThreadUpdates++; }, false));
+
+		for (int i = 0; i < 5; i++) { processManager.UpdateProcesses(16); }
+
+		EXPECT_EQ(anyThreadUpdates, 1000);
+		EXPECT_EQ(ownerThreadUpdates, 5);
+		EXPECT_EQ(processManager.GetProcessCount(), 201);
+	}
+
+	TEST(ProcessManagerTests, ParallelUpdateCallsBackOnTheOwnerThread)
+	{
+		ProcessManager processManager;
+		processManager.SetParallelUpdate(true, 3);
+
+		vector<int> completions;
+		vector<shared_ptr<CountdownProcess>> countdowns;
+		for (int i = 0; i < 64; i++)
+		{
+			countdowns.push_back(make_shared<CountdownProcess>(1 + i % 3, ProcessAffinity::AnyThread, &completions, i));
+			processManager.AttachProcess(countdowns.back());
+		}
+
+		unsigned int successes = 0;
+		for (int i = 0; i < 3; i++) { successes += processManager.UpdateProcesses(16).Succeeded; }
+
+		EXPECT_EQ(successes, 64);
+		EXPECT_EQ(processManager.GetProcessCount(), 0);
+		ASSERT_EQ(completions.size(), 64);
+
+		// Processes needing fewer updates complete first
+		for (size_t i = 1; i < completions.size(); i++) { EXPECT_LE(completions[i - 1] % 3, completions[i] % 3); }
+
+		for (const auto& countdown : countdowns) { EXPECT_EQ(countdown->SuccessThread, this_thread::get_id()); }
+	}
+
+	TEST(ProcessManagerTests, ParallelUpdateKeepsOwnerThreadProcessesOnTheOwnerThread)
+	{
+		ProcessManager processManager;
+		processManager.SetParallelUpdate(true, 3);
+
+		vector<shared_ptr<CountdownProcess>> ownerThread;
+		for (int i = 0; i < 64; i++)
+		{
+			processManager.AttachProcess(make_shared<CountdownProcess>(1, ProcessAffinity::AnyThread));
+			ownerThread.push_back(make_shared<CountdownProcess>(1, ProcessAffinity::OwnerThread));
+			processManager.AttachProcess(ownerThread.back());
+		}
+
+		processManager.UpdateProcesses(16);
+
+		for (const auto& process : ownerThread) { EXPECT_EQ(process->UpdateThread, this_thread::get_id()); }
+	}
+
+	TEST(ProcessManagerTests, ParallelUpdateChainsChildrenOnTheOwnerThread)
+	{
+		ProcessManager processManager;
+		processManager.SetParallelUpdate(true, 3);
+
+		vector<int> completions;
+		for (int i = 0; i < 16; i++)
+		{
+			const auto parent = make_shared<CountdownProcess>(1, ProcessAffinity::AnyThread, &completions, i);
+			parent->AttachChild(make_shared<CountdownProcess>(1, ProcessAffinity::AnyThread, &completions, 100 + i))
+				->AttachChild(make_shared<DelayProcess>(10));
+			processManager.AttachProcess(parent);
+		}
+
+		EXPECT_EQ(processManager.UpdateProcesses(16).Succeeded, 0) << "Expected parents with children not to count as successes";
+		EXPECT_EQ(processManager.UpdateProcesses(16).Succeeded, 0);
+		EXPECT_EQ(processManager.GetProcessCount(), 16) << "Expected only the delays to be left";
+
+		// All the parents complete before the children
+		ASSERT_EQ(completions.size(), 32);
+		for (int i = 0; i < 16; i++)
+		{
+			EXPECT_LT(completions[i], 100);
+			EXPECT_GE(completions[16 + i], 100);
+		}
+
+		EXPECT_EQ(processManager.UpdateProcesses(16).Succeeded, 16);
+		EXPECT_EQ(processManager.GetProcessCount(), 0);
+	}
+
+	TEST(ProcessManagerTests, ParallelUpdateSpreadsUnevenWorkAcrossWorkers)
+	{
+		ProcessManager processManager;
+		processManager.SetParallelUpdate(true, 3);
+
+		mutex threadsMutex;
+		set<thread::id> threads;
+		for (int i = 0; i < 32; i++)
+		{
+			// The first few are slow, so the threads dealt them need the others to steal the rest of their share
+			const auto slow = i < 4;
+			processManager.AttachProcess(make_shared<Action>([&, slow](unsigned long)
+			{
+				if (slow) { this_thread::sleep_for(chrono::milliseconds(20)); }
+				lock_guard lock(threadsMutex);
+				threads.insert(this_thread::get_id());
+			}, true, ProcessAffinity::AnyThread));
+		}
+
+		EXPECT_EQ(processManager.UpdateProcesses(16).Succeeded, 32);
+		EXPECT_GT(threads.size(), 1);
+	}
+
+	TEST(ProcessManagerTests, ParallelUpdateRethrowsOnTheOwnerThread)
+	{
+		ProcessManager processManager;
+		processManager.SetParallelUpdate(true, 2);
+
+		bool thrown = false;
+		for (int i = 0; i < 8; i++)
+		{
+			processManager.AttachProcess(make_shared<Action>([i, &thrown](unsigned long)
+			{
+				if (i == 5 && !thrown)
+				{
+					thrown = true;
+					throw runtime_error("update failed");
+				}
+			}, true, ProcessAffinity::AnyThread));
+		}
+
+		EXPECT_THROW(processManager.UpdateProcesses(16), runtime_error);
+		EXPECT_EQ(processManager.UpdateProcesses(16).Succeeded, 8) << "Expected the processes that updated to complete, and the one that threw to be updated again";
+	}
+
+	TEST(ProcessManagerTests, HandlesFindProcessesUntilTheyAreRemoved)
+	{
+		ProcessManager processManager;
+
+		const auto first = make_shared<Action>([](unsigned long) {});
+		const auto second = make_shared<Action>([](unsigned long) {}, false);
+		const auto firstHandle = processManager.AttachProcess(first);
+		const auto secondHandle = processManager.AttachProcess(second);
+
+		EXPECT_TRUE(firstHandle.IsValid());
+		EXPECT_FALSE(ProcessHandle().IsValid());
+		EXPECT_EQ(processManager.GetProcess(firstHandle), first);
+		EXPECT_EQ(processManager.GetProcess(secondHandle), second);
+
+		processManager.UpdateProcesses(16);
+
+		// The first is removed and the second swapped into its place
+		EXPECT_FALSE(processManager.IsAttached(firstHandle));
+		EXPECT_EQ(processManager.GetProcess(secondHandle), second);
+
+		// Reuses the removed process's slot without reviving its handle
+		const auto third = make_shared<Action>([](unsigned long) {});
+		const auto thirdHandle = processManager.AttachProcess(third);
+		EXPECT_EQ(thirdHandle.Index, firstHandle.Index);
+		EXPECT_FALSE(processManager.IsAttached(firstHandle));
+		EXPECT_EQ(processManager.GetProcess(thirdHandle), third);
+		EXPECT_EQ(processManager.GetProcess(secondHandle), second);
+	}
+
+	TEST(ProcessManagerTests, ProcessesAttachedWhileUpdatingStartNextUpdate)
+	{
+		ProcessManager processManager;
+		int attachedRuns = 0;
+		ProcessHandle attachedHandle;
+		const auto attached = make_shared<Action>([&](unsigned long) { attachedRuns++; });
+
+		processManager.AttachProcess(make_shared<Action>([&](unsigned long)
+		{
+			attachedHandle = processManager.AttachProcess(attached);
+			EXPECT_EQ(processManager.GetProcess(attachedHandle), attached) << "Expected a handle that works straight away";
+		}));
+
+		processManager.UpdateProcesses(16);
+		EXPECT_EQ(attachedRuns, 0);
+		EXPECT_EQ(processManager.GetProcess(attachedHandle), attached);
+
+		processManager.UpdateProcesses(16);
+		EXPECT_EQ(attachedRuns, 1);
+		EXPECT_FALSE(processManager.IsAttached(attachedHandle));
+	}
+
+	// Not a pass/fail test: reports what one update costs per process as the number of processes grows.
+	// Disabled as it takes a while; run it with --gtest_also_run_disabled_tests
+	TEST(ProcessManagerTests, DISABLED_UpdateCostPerProcess)
+	{
+		constexpr int updates = 20;
+		for (const auto parallel : { false, true })
+		{
+			for (const auto processCount : { 10000, 100000 })
+			{
+				ProcessManager processManager;
+				processManager.SetParallelUpdate(parallel);
+				for (int i = 0; i < processCount; i++)
+				{
+					// Half finish part way through, to include removing them
+					processManager.AttachProcess(make_shared<DelayProcess>(i % 2 == 0 ? 160 : 1000000));
+				}
+
+				const auto start = chrono::steady_clock::now();
+				for (int i = 0; i < updates; i++) { processManager.UpdateProcesses(16); }
+				const auto elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() - start);
+
+				EXPECT_EQ(processManager.GetProcessCount(), processCount / 2);
+				cout << "[          ] " << (parallel ? "parallel" : "serial") << ", " << processCount << " processes: "
+					<< elapsed.count() / (static_cast<double>(updates) * processCount) << " ns per process per update" << endl;
+			}
+		}
+	}
+
+	// Counts its updates and the deltaMs it was given
+	class CountingProcess final : public Process
+	{
+	public:
+		explicit CountingProcess(const ProcessPriority priority, const chrono::microseconds workTime = chrono::microseconds(0)) : workTime(workTime)
+		{
+			SetPriority(priority);
+		}
+
+		int Updates = 0;
+		unsigned long TotalDeltaMs = 0;
+		int FirstUpdate = -1;
+		static inline int updateOrder = 0;
+	protected:
+		void OnUpdate(const unsigned long deltaMs) override
+		{
+			if (Updates++ == 0) { FirstUpdate = updateOrder++; }
+			TotalDeltaMs += deltaMs;
+			if (workTime.count() > 0) { this_thread::sleep_for(workTime); }
+		}
+	private:
+		chrono::microseconds workTime;
+	};
+
+	TEST(ProcessManagerTests, FrameBudgetDefersLowerPrioritiesUntilTheyStarve)
+	{
+		ProcessManager processManager;
+		processManager.SetFrameBudget(chrono::milliseconds(1), 3);
+
+		const auto critical = make_shared<CountingProcess>(ProcessPriority::Critical);
+		const auto slow = make_shared<CountingProcess>(ProcessPriority::High, chrono::milliseconds(2));
+		vector<shared_ptr<CountingProcess>> normal;
+		for (int i = 0; i < 3; i++) { normal.push_back(make_shared<CountingProcess>(ProcessPriority::Normal)); }
+
+		// Attached lowest priority first, to show that attach order doesn't matter
+		for (const auto& process : normal) { processManager.AttachProcess(process); }
+		processManager.AttachProcess(slow);
+		processManager.AttachProcess(critical);
+
+		for (int i = 0; i < 3; i++)
+		{
+			const auto stats = processManager.UpdateProcesses(16);
+			EXPECT_EQ(stats.Ran, 2);
+			EXPECT_EQ(stats.Deferred, 3);
+			EXPECT_GT(stats.Overrun.count(), 0) << "Expected the slow process to run past the budget";
+		}
+
+		// Deferred three times in a row: updated whatever the budget, with the time they missed
+		const auto stats = processManager.UpdateProcesses(16);
+		EXPECT_EQ(stats.Ran, 5);
+		EXPECT_EQ(stats.Deferred, 0);
+		for (const auto& process : normal)
+		{
+			EXPECT_EQ(process->Updates, 1);
+			EXPECT_EQ(process->TotalDeltaMs, 64);
+		}
+		EXPECT_EQ(critical->Updates, 4);
+		EXPECT_EQ(slow->Updates, 4);
+	}
+
+	TEST(ProcessManagerTests, FrameBudgetWorksThroughDeferredProcessesRoundRobin)
+	{
+		ProcessManager processManager;
+		processManager.SetFrameBudget(chrono::microseconds(1500), 100);
+
+		CountingProcess::updateOrder = 0;
+		vector<shared_ptr<CountingProcess>> slow;
+		for (int i = 0; i < 6; i++)
+		{
+			slow.push_back(make_shared<CountingProcess>(ProcessPriority::Low, chrono::milliseconds(1)));
+			processManager.AttachProcess(slow.back());
+		}
+
+		// At least one runs per update, and none runs twice before all have run once
+		for (int i = 0; i < 6; i++) { processManager.UpdateProcesses(16); }
+
+		for (const auto& process : slow)
+		{
+			EXPECT_GE(process->FirstUpdate, 0);
+			EXPECT_LT(process->FirstUpdate, 6);
+		}
+
+		vector<int> updates;
+		for (const auto& process : slow) { updates.push_back(process->Updates); }
+		EXPECT_LE(*max_element(updates.begin(), updates.end()) - *min_element(updates.begin(), updates.end()), 1)
+			<< "Expected deferred processes to take turns";
+	}
+
+	TEST(ProcessManagerTests, UpdateStatsCountEveryOutcome)
+	{
+		ProcessManager processManager;
+		for (int i = 0; i < 70000; i++)
+		{
+			processManager.AttachProcess(make_shared<CountdownProcess>(1, ProcessAffinity::OwnerThread));
+			const auto failing = make_shared<Action>([](unsigned long) {}, false);
+			failing->Fail();
+			processManager.AttachProcess(failing);
+		}
+		processManager.AttachProcess(make_shared<Action>([](unsigned long) {}, false));
+
+		// More than fit in the 16 bits each of the packed result this replaced
+		const auto stats = processManager.UpdateProcesses(16);
+		EXPECT_EQ(stats.Ran, 70001);
+		EXPECT_EQ(stats.Succeeded, 70000);
+		EXPECT_EQ(stats.Failed, 70000);
+		EXPECT_EQ(stats.Deferred, 0);
+		EXPECT_EQ(stats.Overrun.count(), 0) << "Expected no overrun without a budget";
+		EXPECT_EQ(processManager.GetProcessCount(), 1);
+	}
+}
\ No newline at end of file
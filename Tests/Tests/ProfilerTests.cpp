@@ -0,0 +1,150 @@
+#include "pch.h"
+#include "processes/ProcessManager.h"
+#include "structure/Profiler.h"
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+using namespace std;
+namespace gamelib
+{
+	class ProfilerTests : public testing::Test
+	{
+	public:
+		void SetUp() override
+		{
+			Profiler::Get()->Reset();
+			Profiler::Get()->SetEnabled(true);
+		}
+
+		void TearDown() override
+		{
+			Profiler::Get()->SetEnabled(false);
+			Profiler::Get()->Reset();
+		}
+
+		static ProfileZoneTotals FindTotals(const char* name)
+		{
+			for (const auto& totals : Profiler::Get()->GetLastFrame())
+			{
+				if (strcmp(totals.Name, name) == 0) { return totals; }
+			}
+			return {};
+		}
+	};
+
+	TEST_F(ProfilerTests, NestedZonesAreTimedWithTheirOwnTime)
+	{
+		{
+			const ProfileScope outer("outer");
+			this_thread::sleep_for(chrono::milliseconds(2));
+			for (auto i = 0; i < 3; i++)
+			{
+				const ProfileScope inner("inner");
+				this_thread::sleep_for(chrono::milliseconds(1));
+			}
+		}
+		Profiler::Get()->EndFrame();
+
+		const auto outer = FindTotals("outer");
+		const auto inner = FindTotals("inner");
+		EXPECT_EQ(outer.Calls, 1);
+		EXPECT_EQ(inner.Calls, 3);
+		EXPECT_GE(inner.TotalNs, 3000000);
+		EXPECT_GE(outer.TotalNs, 5000000);
+		EXPECT_EQ(outer.SelfNs, outer.TotalNs - inner.TotalNs) << "Expected the outer zone's own time to exclude the inner zones";
+		EXPECT_EQ(inner.SelfNs, inner.TotalNs);
+
+		const auto timeline = Profiler::Get()->GetTimeline();
+		ASSERT_EQ(timeline.size(), 4);
+		EXPECT_STREQ(timeline.back().Name, "outer") << "Expected zones in the order they ended";
+		EXPECT_EQ(timeline.back().Depth, 0);
+		EXPECT_EQ(timeline.front().Depth, 1);
+		EXPECT_GE(timeline.front().StartNs, timeline.back().StartNs);
+	}
+
+	TEST_F(ProfilerTests, TotalsArePerFrame)
+	{
+		{ const ProfileScope zone("first frame"); }
+		Profiler::Get()->EndFrame();
+		{ const ProfileScope zone("second frame"); }
+		{ const ProfileScope zone("second frame"); }
+		Profiler::Get()->EndFrame();
+
+		EXPECT_EQ(FindTotals("first frame").Calls, 0);
+		EXPECT_EQ(FindTotals("second frame").Calls, 2);
+		EXPECT_EQ(Profiler::Get()->GetFrameNumber(), 2);
+
+		const auto timeline = Profiler::Get()->GetTimeline();
+		ASSERT_EQ(timeline.size(), 3);
+		EXPECT_EQ(timeline[0].Frame, 0);
+		EXPECT_EQ(timeline[2].Frame, 1);
+	}
+
+	TEST_F(ProfilerTests, ZonesAreGatheredFromEveryThread)
+	{
+		thread worker([] { const ProfileScope zone("worker"); });
+		worker.join();
+		{ const ProfileScope zone("main"); }
+		Profiler::Get()->EndFrame();
+
+		const auto timeline = Profiler::Get()->GetTimeline();
+		ASSERT_EQ(timeline.size(), 2);
+		EXPECT_NE(timeline[0].Thread, timeline[1].Thread);
+		EXPECT_EQ(FindTotals("worker").Calls, 1) << "Expected zones of a finished thread to still be gathered";
+	}
+
+	TEST_F(ProfilerTests, NothingIsRecordedWhileDisabled)
+	{
+		Profiler::Get()->SetEnabled(false);
+		{ const ProfileScope zone("disabled"); }
+		Profiler::Get()->EndFrame();
+
+		EXPECT_TRUE(Profiler::Get()->GetLastFrame().empty());
+		EXPECT_TRUE(Profiler::Get()->GetTimeline().empty());
+	}
+
+	TEST_F(ProfilerTests, TimelineKeepsTheLatestZones)
+	{
+		Profiler::Get()->SetTimelineCapacity(2);
+		{ const ProfileScope zone("a"); }
+		{ const ProfileScope zone("b"); }
+		{ const ProfileScope zone("c"); }
+		Profiler::Get()->EndFrame();
+
+		const auto timeline = Profiler::Get()->GetTimeline();
+		ASSERT_EQ(timeline.size(), 2);
+		EXPECT_STREQ(timeline[0].Name, "b");
+		EXPECT_STREQ(timeline[1].Name, "c");
+		EXPECT_EQ(FindTotals("a").Calls, 1) << "Expected totals to include zones no longer in the timeline";
+
+		Profiler::Get()->SetTimelineCapacity(65536);
+	}
+
+	TEST_F(ProfilerTests, ExportsChromeTrace)
+	{
+		{ const ProfileScope zone("a \"quoted\" zone"); }
+		Profiler::Get()->EndFrame();
+
+		std::stringstream chromeTrace;
+		Profiler::Get()->WriteChromeTrace(chromeTrace);
+		EXPECT_NE(chromeTrace.str().find("\"traceEvents\""), std::string::npos);
+		EXPECT_NE(chromeTrace.str().find("\"a \\\"quoted\\\" zone\""), std::string::npos) << "Expected names to be escaped";
+		EXPECT_NE(chromeTrace.str().find("\"ph\":\"X\""), std::string::npos);
+	}
+
+#ifdef GAMELIB_PROFILING
+	TEST_F(ProfilerTests, EngineUpdatesAreInstrumented)
+	{
+		ProcessManager processManager;
+		processManager.UpdateProcesses(16);
+		Profiler::Get()->EndFrame();
+
+		EXPECT_EQ(FindTotals("ProcessManager::UpdateProcesses").Calls, 1);
+	}
+#endif
+}
@@ -7,7 +7,11 @@
 #include "file/SettingsManager.h"
 #include "font/FontManager.h"
 #include "graphic/SDLGraphicsManager.h"
+#include "resource/AssetLoader.h"
 #include "resource/ResourceManager.h"
+#include "events/SceneAssetsReadyEvent.h"
+#include <chrono>
+#include <thread>
 
 using namespace std;
 namespace gamelib
@@ -47,9 +51,9 @@ namespace gamelib
 	{
 		SettingsManager::Get()->ReadSettingsFile();
 		EXPECT_TRUE(ResourceManager::Get()->Initialize("Resources.xml")) << "Expected resource manager initialization to succeed";
-		EXPECT_EQ(EventManager::Get()->GetSubscriptions()[SceneChangedEventTypeEventId].size(), 1) << "Expected to subscribe to LevelChangedEventType";
+		EXPECT_EQ(EventManager::Get()->GetSubscriptions().at(SceneChangedEventTypeEventId).size(), 1) << "Expected to subscribe to LevelChangedEventType";
 		EXPECT_STREQ(
-			EventManager::Get()->GetSubscriptions()[SceneChangedEventTypeEventId][0]->GetSubscriberName().c_str(),
+			EventManager::Get()->GetSubscriptions().at(SceneChangedEventTypeEventId)[0]->GetSubscriberName().c_str(),
 			ResourceManager::Get()->GetSubscriberName().c_str()) << "Unexpected subscriber";
 	}
 
@@ -88,4 +92,173 @@ namespace gamelib
 		ResourceManager::Get()->Unload();
 		EXPECT_EQ(0, ResourceManager::Get()->GetCountUnloadedResources()) << "Asset count is not 0 after unload";
 	}
+
+	TEST_F(ResourceManagerTests, MetadataOnlyIndexesButDoesNotLoadMedia)
+	{
+		ResourceManager::Get()->Reset();
+		ResourceManager::Get()->SetMetadataOnly(true);
+		ResourceManager::Get()->IndexResourceFile(resource_file_path);
+
+		ResourceManager::Get()->HandleEvent(std::make_shared<SceneChangedEvent>(1), 0);
+
+		EXPECT_EQ(ResourceManager::Get()->GetCountResources(), 10) << "Expected every asset to still be indexed";
+		for (const auto uid : { 1, 2, 6 })
+		{
+			EXPECT_FALSE(ResourceManager::Get()->GetAssetInfo(uid)->IsLoadedInMemory) << "Expected asset " << uid << " not to be loaded";
+		}
+
+		ResourceManager::Get()->SetMetadataOnly(false);
+		ResourceManager::Get()->Reset();
+	}
+
+	class SceneAssetsReadySubscriber final : public EventSubscriber
+	{
+	public:
+		std::vector<std::shared_ptr<Event>> HandleEvent(const std::shared_ptr<Event>& evt, const unsigned long deltaMs) override
+		{
+			const auto ready = dynamic_pointer_cast<SceneAssetsReadyEvent>(evt);
+			Ready.emplace_back(ready->SceneId, ready->FailedAssets);
+			return {};
+		}
+		std::string GetSubscriberName() override { return "scene_assets_ready_subscriber"; }
+		// Scene and failed asset count of each event
+		std::vector<std::pair<int, unsigned int>> Ready;
+	};
+
+	TEST_F(ResourceManagerTests, LoadSceneAssetsAsync)
+	{
+		ResourceManager::Get()->Reset();
+		ResourceManager::Get()->IndexResourceFile(resource_file_path);
+		ResourceManager::Get()->SetAsyncLoading(2);
+		EventManager::Get()->ProcessAllEvents();
+		SceneAssetsReadySubscriber subscriber;
+		EventManager::Get()->SubscribeToEvent(SceneAssetsReadyEventId, &subscriber);
+
+		// Scene 4's music, and the sound effects and script every scene uses
+		const auto handle = ResourceManager::Get()->LoadSceneAssetsAsync(exp_scene);
+		EXPECT_EQ(handle->GetProgress().Total, 6);
+
+		vector<float> progress;
+		const auto giveUp = chrono::steady_clock::now() + chrono::seconds(5);
+		while (!handle->IsReady() && chrono::steady_clock::now() < giveUp)
+		{
+			if (ResourceManager::Get()->CompleteLoads(1) > 0) { progress.push_back(handle->GetProgress().GetFraction()); }
+			else { this_thread::yield(); }
+		}
+
+		ASSERT_EQ(handle->GetFuture().wait_for(chrono::seconds(0)), future_status::ready);
+		EXPECT_EQ(handle->GetFuture().get().Loaded, 6);
+		ASSERT_EQ(progress.size(), 6) << "Expected one asset to finish per call";
+		EXPECT_FLOAT_EQ(progress[2], 0.5f);
+		EXPECT_FLOAT_EQ(progress[5], 1.0f);
+		EXPECT_TRUE(ResourceManager::Get()->GetAssetInfo(exp_uid)->IsLoadedInMemory);
+		EXPECT_EQ(ResourceManager::Get()->GetCountLoadedResources(), 6);
+
+		EventManager::Get()->ProcessAllEvents();
+		ASSERT_EQ(subscriber.Ready.size(), 1);
+		EXPECT_EQ(subscriber.Ready[0], make_pair(exp_scene, 0U));
+
+		// Everything is loaded already
+		EXPECT_TRUE(ResourceManager::Get()->LoadSceneAssetsAsync(exp_scene)->IsReady());
+		EventManager::Get()->ProcessAllEvents();
+		EXPECT_EQ(subscriber.Ready.size(), 2) << "Expected the scene to be ready straight away";
+
+		EventManager::Get()->Unsubscribe(SceneAssetsReadyEventId, &subscriber);
+		ResourceManager::Get()->SetAsyncLoading(0);
+		ResourceManager::Get()->Reset();
+	}
+
+	TEST_F(ResourceManagerTests, HintedScenesArePrefetchedAndKept)
+	{
+		ResourceManager::Get()->Reset();
+		ResourceManager::Get()->IndexResourceFile(resource_file_path);
+		ResourceManager::Get()->HandleEvent(std::make_shared<SceneChangedEvent>(1), 0);
+		const auto music = ResourceManager::Get()->GetAssetInfo(exp_uid);
+		EXPECT_FALSE(music->IsLoadedInMemory);
+
+		// Scene 4 is likely next, so its music loads in the background while scene 1 plays
+		ResourceManager::Get()->HintNextScenes({ exp_scene });
+		const auto giveUp = chrono::steady_clock::now() + chrono::seconds(5);
+		while (!music->IsLoadedInMemory && chrono::steady_clock::now() < giveUp)
+		{
+			if (ResourceManager::Get()->CompleteLoads() == 0) { this_thread::yield(); }
+		}
+		EXPECT_TRUE(music->IsLoadedInMemory);
+		EXPECT_TRUE(ResourceManager::Get()->GetResidency().IsResident(exp_uid));
+		EXPECT_FALSE(ResourceManager::Get()->IsAsyncLoading()) << "Expected scene changes to still load in place";
+
+		// Still hinted, so changing to another scene keeps it
+		ResourceManager::Get()->HandleEvent(std::make_shared<SceneChangedEvent>(2), 0);
+		EXPECT_TRUE(music->IsLoadedInMemory);
+
+		ResourceManager::Get()->HintNextScenes({});
+		ResourceManager::Get()->HandleEvent(std::make_shared<SceneChangedEvent>(1), 0);
+		EXPECT_FALSE(music->IsLoadedInMemory);
+		EXPECT_FALSE(ResourceManager::Get()->GetResidency().IsResident(exp_uid));
+
+		ResourceManager::Get()->Reset();
+	}
+
+	TEST_F(ResourceManagerTests, ChangingSceneCancelsItsAsyncLoad)
+	{
+		ResourceManager::Get()->Reset();
+		ResourceManager::Get()->IndexResourceFile(resource_file_path);
+		ResourceManager::Get()->SetAsyncLoading(2);
+		EventManager::Get()->ProcessAllEvents();
+		SceneAssetsReadySubscriber subscriber;
+		EventManager::Get()->SubscribeToEvent(SceneAssetsReadyEventId, &subscriber);
+
+		// Scene 3 is started before scene 4's music has finished loading
+		const auto superseded = ResourceManager::Get()->LoadSceneAssetsAsync(exp_scene);
+		const auto handle = ResourceManager::Get()->LoadSceneAssetsAsync(3);
+		EXPECT_TRUE(superseded->IsCancelled());
+		EXPECT_FALSE(superseded->IsReady());
+		ASSERT_EQ(superseded->GetFuture().wait_for(chrono::seconds(0)), future_status::ready);
+		EXPECT_TRUE(superseded->GetFuture().get().Cancelled);
+
+		const auto giveUp = chrono::steady_clock::now() + chrono::seconds(5);
+		while (!handle->IsReady() && chrono::steady_clock::now() < giveUp)
+		{
+			if (ResourceManager::Get()->CompleteLoads() == 0) { this_thread::yield(); }
+		}
+		ResourceManager::Get()->SetAsyncLoading(0);
+
+		EXPECT_TRUE(handle->IsReady());
+		EXPECT_FALSE(ResourceManager::Get()->GetAssetInfo(exp_uid)->IsLoadedInMemory) << "Expected the superseded scene's music not to be kept";
+		EXPECT_FALSE(ResourceManager::Get()->GetResidency().IsResident(exp_uid));
+
+		EventManager::Get()->ProcessAllEvents();
+		ASSERT_EQ(subscriber.Ready.size(), 1);
+		EXPECT_EQ(subscriber.Ready[0].first, 3) << "Expected no SceneAssetsReady for the cancelled load";
+
+		EventManager::Get()->Unsubscribe(SceneAssetsReadyEventId, &subscriber);
+		ResourceManager::Get()->Reset();
+	}
+
+	TEST_F(ResourceManagerTests, UploadsAreSpreadOverFrames)
+	{
+		ResourceManager::Get()->Reset();
+		ResourceManager::Get()->IndexResourceFile(resource_file_path);
+		ResourceManager::Get()->SetAsyncLoading(2);
+		ResourceManager::Get()->SetMaxUploadsPerFrame(1);
+		const auto handle = ResourceManager::Get()->LoadSceneAssetsAsync(2);
+
+		// One per frame, as the game loop finishes them
+		size_t mostInAFrame = 0;
+		const auto giveUp = chrono::steady_clock::now() + chrono::seconds(5);
+		while (!handle->IsReady() && chrono::steady_clock::now() < giveUp)
+		{
+			const auto finished = ResourceManager::Get()->CompleteLoads(ResourceManager::Get()->GetMaxUploadsPerFrame());
+			mostInAFrame = max(mostInAFrame, finished);
+			if (finished == 0) { this_thread::yield(); }
+		}
+
+		EXPECT_TRUE(handle->IsReady());
+		EXPECT_EQ(mostInAFrame, 1);
+
+		ResourceManager::Get()->SetMaxUploadsPerFrame(4);
+		ResourceManager::Get()->SetAsyncLoading(0);
+		ResourceManager::Get()->Reset();
+		EventManager::Get()->ProcessAllEvents();
+	}
 }
@@ -30,7 +30,7 @@ namespace gamelib
 		PingMessage pingMessage;
 		pingMessage.Type = "ping";
 		pingMessage.IsHappy = true;
-		pingMessage.EventType = NetworkTrafficReceivedEventId.PrimaryId;
+		pingMessage.EventType = NetworkTrafficReceivedEventId.GetPrimaryId();
 		pingMessage.Names = { "Stuart", "Jenny", "bruce" };
 		pingMessage.Ages = {1, 2,3 };
 		pingMessage.TheFish = Fish("Neemo", "Mathews");
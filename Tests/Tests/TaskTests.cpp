@@ -0,0 +1,164 @@
+#include "pch.h"
+#include "events/Event.h"
+#include "events/EventManager.h"
+#include "events/EventNumbers.h"
+#include "processes/ProcessManager.h"
+#include "processes/Task.h"
+
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+using namespace std;
+namespace gamelib
+{
+	class TaskTests : public testing::Test
+	{
+	protected:
+		ProcessManager processManager;
+		vector<string> steps;
+
+		void SetUp() override { EventManager::Get()->Reset(); }
+		void TearDown() override { EventManager::Get()->Reset(); }
+
+		Task Countdown(const int from)
+		{
+			for (auto i = from; i > 0; i--)
+			{
+				steps.push_back(to_string(i));
+				co_await NextFrame();
+			}
+		}
+	};
+
+	TEST_F(TaskTests, NextFrameResumesOnTheNextUpdate)
+	{
+		processManager.StartTask(Countdown(3));
+
+		processManager.UpdateProcesses(16);
+		EXPECT_EQ(steps, vector<string>({ "3" }));
+		processManager.UpdateProcesses(16);
+		processManager.UpdateProcesses(16);
+		EXPECT_EQ(steps, vector<string>({ "3", "2", "1" }));
+		EXPECT_EQ(processManager.GetProcessCount(), 1);
+
+		EXPECT_EQ(processManager.UpdateProcesses(16).Succeeded, 1) << "Expected the finished task to succeed";
+		EXPECT_EQ(processManager.GetProcessCount(), 0);
+	}
+
+	TEST_F(TaskTests, DelayWaitsForGameTime)
+	{
+		auto delayed = [this]() -> Task
+		{
+			steps.push_back("start");
+			co_await Delay(100);
+			steps.push_back("after delay");
+		};
+		processManager.StartTask(delayed());
+
+		int updates = 0;
+		while (steps.size() < 2 && updates < 100)
+		{
+			processManager.UpdateProcesses(16);
+			updates++;
+		}
+
+		// Started on the first update, then 7 more updates of 16ms to pass 100ms
+		EXPECT_EQ(updates, 8);
+	}
+
+	TEST_F(TaskTests, EventRaisedResumesWithTheEvent)
+	{
+		const EventId awaitedId(60, "TaskAwaited");
+		const EventId otherId(61, "TaskOther");
+		shared_ptr<Event> received;
+
+		auto waiting = [&]() -> Task
+		{
+			received = co_await EventRaised(awaitedId);
+		};
+		processManager.StartTask(waiting());
+		processManager.UpdateProcesses(16);
+
+		EventManager::Get()->RaiseEventWithNoLogging(make_shared<Event>(otherId));
+		EventManager::Get()->ProcessAllEvents(16);
+		processManager.UpdateProcesses(16);
+		EXPECT_EQ(received, nullptr);
+
+		const auto awaited = make_shared<Event>(awaitedId);
+		EventManager::Get()->RaiseEventWithNoLogging(awaited);
+		EventManager::Get()->ProcessAllEvents(16);
+		EXPECT_EQ(received, nullptr) << "Expected the task to resume on its next update, not during dispatch";
+
+		processManager.UpdateProcesses(16);
+		EXPECT_EQ(received, awaited);
+		EXPECT_TRUE(EventManager::Get()->GetSubscriptions().at(awaitedId).empty()) << "Expected the task to stop listening";
+	}
+
+	TEST_F(TaskTests, AwaitingATaskRunsItWithin)
+	{
+		auto sequence = [this]() -> Task
+		{
+			steps.push_back("before");
+			co_await Countdown(2);
+			steps.push_back("after");
+		};
+		processManager.StartTask(sequence());
+
+		for (int i = 0; i < 3; i++) { processManager.UpdateProcesses(16); }
+
+		EXPECT_EQ(steps, vector<string>({ "before", "2", "1", "after" }));
+	}
+
+	TEST_F(TaskTests, ExceptionsFailTheProcess)
+	{
+		auto failing = []() -> Task
+		{
+			co_await NextFrame();
+			throw runtime_error("task failed");
+		};
+		auto awaiting = [&]() -> Task
+		{
+			try { co_await failing(); }
+			catch (const runtime_error&) { steps.push_back("caught"); }
+			co_await failing();
+		};
+		const auto handle = processManager.StartTask(awaiting());
+		const auto process = dynamic_pointer_cast<TaskProcess>(processManager.GetProcess(handle));
+		ASSERT_NE(process, nullptr);
+
+		unsigned int failures = 0;
+		for (int i = 0; i < 4; i++) { failures += processManager.UpdateProcesses(16).Failed; }
+
+		EXPECT_EQ(steps, vector<string>({ "caught" }));
+		EXPECT_EQ(failures, 1);
+		EXPECT_NE(process->GetError(), nullptr);
+	}
+
+	TEST_F(TaskTests, FramesAreRecycled)
+	{
+		// Warm up the pool with a frame of this size
+		processManager.StartTask(Countdown(1));
+		for (int i = 0; i < 2; i++) { processManager.UpdateProcesses(16); }
+
+		TaskFramePool::Get()->ResetStatistics();
+		for (int round = 0; round < 10; round++)
+		{
+			processManager.StartTask(Countdown(1));
+			for (int i = 0; i < 2; i++) { processManager.UpdateProcesses(16); }
+		}
+
+		const auto statistics = TaskFramePool::Get()->GetStatistics();
+		EXPECT_EQ(statistics.Hits, 10);
+		EXPECT_EQ(statistics.Misses, 0);
+	}
+
+	TEST_F(TaskTests, UnstartedTasksAreDestroyedWithTheirProcess)
+	{
+		{
+			ProcessManager shortLived;
+			shortLived.StartTask(Countdown(5));
+			shortLived.UpdateProcesses(16);
+		}
+		EXPECT_EQ(steps, vector<string>({ "5" }));
+	}
+}
@@ -0,0 +1,183 @@
+#include "pch.h"
+#include "events/EventManager.h"
+#include "events/UpdateAllGameObjectsEvent.h"
+#include "processes/ProcessManager.h"
+#include "time/TimerWheel.h"
+
+#include "gtest/gtest.h"
+#include <random>
+#include <vector>
+using namespace std;
+namespace gamelib
+{
+	TEST(TimerWheelTests, OneShotTimersFireOnceWhenDue)
+	{
+		TimerWheel wheel;
+		vector<uint64_t> firedAt;
+
+		const auto handle = wheel.ScheduleOnce(40, [&] { firedAt.push_back(wheel.GetTimeMs()); });
+		EXPECT_TRUE(wheel.IsScheduled(handle));
+
+		EXPECT_EQ(wheel.Advance(16), 0);
+		EXPECT_EQ(wheel.Advance(16), 0);
+		EXPECT_EQ(wheel.Advance(16), 1);
+		EXPECT_EQ(wheel.Advance(1000), 0);
+
+		EXPECT_EQ(firedAt, vector<uint64_t> { 40 }) << "Expected the callback to see the time it was due";
+		EXPECT_FALSE(wheel.IsScheduled(handle));
+		EXPECT_EQ(wheel.GetTimerCount(), 0);
+		EXPECT_EQ(wheel.GetTimeMs(), 1048);
+	}
+
+	TEST(TimerWheelTests, FarOffTimersFireOnTime)
+	{
+		TimerWheel wheel;
+		vector<pair<unsigned long, uint64_t>> fired;
+
+		// Spread over every level of the wheel, and beyond it
+		const vector<unsigned long> delays { 1, 63, 64, 65, 4095, 4096, 100000, 262144, 5000000, 300000000, 80000000000UL };
+		for (const auto delay : delays)
+		{
+			wheel.ScheduleOnce(delay, [&, delay] { fired.emplace_back(delay, wheel.GetTimeMs()); });
+		}
+
+		// Uneven steps, as frame times are
+		while (wheel.GetTimerCount() > 0) { wheel.Advance(wheel.GetTimeMs() < 1000000 ? 17 : 600000000); }
+
+		ASSERT_EQ(fired.size(), delays.size());
+		for (size_t i = 0; i < delays.size(); i++)
+		{
+			EXPECT_EQ(fired[i].first, delays[i]) << "Expected timers to fire in order";
+			EXPECT_EQ(fired[i].second, delays[i]);
+		}
+	}
+
+	TEST(TimerWheelTests, RandomTimersFireExactlyWhenDue)
+	{
+		TimerWheel wheel;
+		mt19937 random(7);
+		uniform_int_distribution<unsigned long> delay(0, 300000);
+		uniform_int_distribution<unsigned long> step(1, 2000);
+
+		int fired = 0;
+		int late = 0;
+		for (int i = 0; i < 20000; i++)
+		{
+			const auto dueMs = wheel.GetTimeMs() + std::max(delay(random), 1UL);
+			wheel.ScheduleOnce(dueMs - wheel.GetTimeMs(), [&, dueMs]
+			{
+				fired++;
+				if (wheel.GetTimeMs() != dueMs) { late++; }
+			});
+			if (i % 10 == 0) { wheel.Advance(step(random)); }
+		}
+		while (wheel.GetTimerCount() > 0) { wheel.Advance(step(random)); }
+
+		EXPECT_EQ(fired, 20000);
+		EXPECT_EQ(late, 0);
+	}
+
+	TEST(TimerWheelTests, PeriodicTimersCatchUpOnLongSteps)
+	{
+		TimerWheel wheel;
+		int fired = 0;
+		const auto handle = wheel.SchedulePeriodic(100, [&] { fired++; });
+
+		EXPECT_EQ(wheel.Advance(99), 0);
+		EXPECT_EQ(wheel.Advance(1), 1);
+		EXPECT_EQ(wheel.Advance(1000), 10);
+		EXPECT_EQ(fired, 11);
+		EXPECT_TRUE(wheel.IsScheduled(handle));
+
+		EXPECT_TRUE(wheel.Cancel(handle));
+		EXPECT_FALSE(wheel.Cancel(handle));
+		EXPECT_EQ(wheel.Advance(1000), 0);
+		EXPECT_EQ(wheel.GetTimerCount(), 0);
+	}
+
+	TEST(TimerWheelTests, CallbacksCanCancelAndSchedule)
+	{
+		TimerWheel wheel;
+		int periodicFired = 0;
+		int laterFired = 0;
+		TimerHandle periodic;
+		TimerHandle other;
+
+		periodic = wheel.SchedulePeriodic(10, [&]
+		{
+			// Cancels itself on the third go, and another timer due at the same time on the first
+			if (++periodicFired == 3) { EXPECT_TRUE(wheel.Cancel(periodic)); }
+			wheel.Cancel(other);
+			wheel.ScheduleOnce(5, [&] { laterFired++; });
+		});
+		other = wheel.ScheduleOnce(10, [] { FAIL() << "Expected to be cancelled"; });
+
+		wheel.Advance(100);
+
+		EXPECT_EQ(periodicFired, 3);
+		EXPECT_EQ(laterFired, 3);
+		EXPECT_FALSE(wheel.IsScheduled(periodic));
+		EXPECT_EQ(wheel.GetTimerCount(), 0);
+	}
+
+	TEST(TimerWheelTests, StaleHandlesAreIgnored)
+	{
+		TimerWheel wheel;
+		const auto first = wheel.ScheduleOnce(1, [] {});
+		wheel.Advance(1);
+
+		int fired = 0;
+		const auto second = wheel.ScheduleOnce(1, [&] { fired++; });
+		EXPECT_EQ(second.Index, first.Index) << "Expected the fired timer's entry to be reused";
+		EXPECT_FALSE(wheel.Cancel(first));
+		EXPECT_FALSE(wheel.Cancel(TimerHandle()));
+
+		wheel.Advance(1);
+		EXPECT_EQ(fired, 1);
+	}
+
+	TEST(TimerWheelTests, ThrowingCallbacksLeaveTheRestForTheNextAdvance)
+	{
+		TimerWheel wheel;
+		int fired = 0;
+		wheel.ScheduleOnce(5, [] { throw runtime_error("timer failed"); });
+		wheel.ScheduleOnce(5, [&] { fired++; });
+		wheel.ScheduleOnce(5, [&] { fired++; });
+
+		int advances = 0;
+		while (wheel.GetTimerCount() > 0 && advances++ < 5)
+		{
+			try { wheel.Advance(5); }
+			catch (const runtime_error&) {}
+		}
+
+		EXPECT_EQ(fired, 2);
+		EXPECT_EQ(wheel.GetTimerCount(), 0);
+	}
+
+	TEST(TimerWheelTests, RaisesDelayedEvents)
+	{
+		TimerWheel wheel;
+		EventManager::Get()->Reset();
+
+		wheel.ScheduleEvent(50, make_shared<UpdateAllGameObjectsEvent>());
+		wheel.Advance(49);
+		EXPECT_EQ(EventManager::Get()->CountReady(), 0);
+
+		wheel.Advance(1);
+		EXPECT_EQ(EventManager::Get()->CountReady(), 1);
+		EventManager::Get()->Reset();
+	}
+
+	TEST(TimerWheelTests, ProcessManagerAdvancesItsTimers)
+	{
+		ProcessManager processManager;
+		int fired = 0;
+		processManager.GetTimers().SchedulePeriodic(50, [&] { fired++; });
+
+		for (int i = 0; i < 10; i++) { processManager.UpdateProcesses(16); }
+
+		EXPECT_EQ(fired, 3);
+		EXPECT_EQ(processManager.GetTimers().GetTimeMs(), 160);
+	}
+}
@@ -12,6 +12,15 @@ gamelib::ScriptAsset::ScriptAsset(int inUid, const std::string& inName, const st
 
 void gamelib::ScriptAsset::Load()
 {
+	// Copy the script out of the archive it is packed in
+	if (!PackedData.empty())
+	{
+		delete scriptContent;
+		this->scriptContent = new std::string(reinterpret_cast<const char*>(PackedData.data()), PackedData.size());
+		IsLoadedInMemory = true;
+		return;
+	}
+
 	// Load the script from file
 	std::ifstream script(this->FilePath);
 
@@ -46,3 +55,8 @@ std::string* gamelib::ScriptAsset::GetScriptContent() const
 {
 	return scriptContent;
 }
+
+size_t gamelib::ScriptAsset::GetSizeBytes() const
+{
+	return scriptContent ? scriptContent->size() : 0;
+}
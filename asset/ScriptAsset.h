@@ -20,6 +20,8 @@ namespace gamelib
 			[[nodiscard]]
 			std::string* GetScriptContent() const;
 
+			[[nodiscard]] size_t GetSizeBytes() const override;
+
 		private:
 		std::string* scriptContent;
     };
@@ -1,4 +1,5 @@
 #include "asset.h"
+#include <filesystem>
 
 using namespace std;
 
@@ -10,4 +11,13 @@ namespace gamelib
 	{
 		// constructor initializes member only
 	}
+
+	size_t Asset::GetSizeBytes() const
+	{
+		if (!PackedData.empty()) { return PackedData.size(); }
+
+		std::error_code error;
+		const auto size = std::filesystem::file_size(FilePath, error);
+		return error ? 0 : static_cast<size_t>(size);
+	}
 }
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <span>
 #include <string>
 #include <map>
 
@@ -37,6 +39,12 @@ namespace gamelib
 
 		const int SceneId;
 		bool IsLoadedInMemory;
+
+		/// <summary>
+		/// The asset's file inside a mounted archive, see ResourceManager::MountArchive(). When set, the asset loads
+		/// from here instead of FilePath
+		/// </summary>
+		std::span<const std::byte> PackedData;
 		
 		/// <summary>
 		/// All resources can be allowed to load themselves
@@ -49,6 +57,20 @@ namespace gamelib
 		/// <returns></returns>
 		virtual bool Unload() = 0;
 
+		/// <summary>
+		/// Loading split in two, see ResourceManager::LoadSceneAssetsAsync(). Decode() does the slow part, reading and
+		/// decoding the file, and may run on any thread; Upload() then finishes loading on the thread that owns the
+		/// renderer, e.g. by creating a texture. Assets that can't be split load entirely in Upload()
+		/// </summary>
+		virtual void Decode() { }
+		virtual void Upload() { Load(); }
+
+		/// <summary>
+		/// Memory the loaded asset takes up, used to keep within ResourceManager's memory budget.
+		/// Unless an asset knows better, this is the size of its file or packed data
+		/// </summary>
+		[[nodiscard]] virtual size_t GetSizeBytes() const;
+
 		/// <summary>
 		/// An asset can have misc properties attached to it
 		/// </summary>
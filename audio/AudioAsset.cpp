@@ -4,6 +4,7 @@
 #include "resource/ResourceManager.h"
 #include "exceptions/EngineException.h"
 #include <SDL_mixer.h>
+#include <utility>
 
 using namespace std;
 
@@ -43,23 +44,48 @@ namespace gamelib
 
 	void AudioAsset::Load()
 	{
+		Decode();
+		Upload();
+	}
+
+	void AudioAsset::Decode()
+	{
+		// Read from our own path rather than looking ourselves up, as this may not be the game loop thread.
+		// Packed music keeps streaming from the archive, which stays mapped while mounted
+		const auto openPacked = [this] { return SDL_RWFromConstMem(PackedData.data(), static_cast<int>(PackedData.size())); };
 		if (audioAssetType == AudioAssetType::SoundEffect)
 		{
-			SoundEffect = Mix_LoadWAV(resourceManager.GetAssetInfo(Name)->FilePath.c_str());
+			Mix_FreeChunk(decodedSoundEffect);
+			decodedSoundEffect = PackedData.empty() ? Mix_LoadWAV(FilePath.c_str()) : Mix_LoadWAV_RW(openPacked(), 1);
 		}
 		else if (audioAssetType == AudioAssetType::Music)
 		{
-			Music = Mix_LoadMUS(resourceManager.GetAssetInfo(Name)->FilePath.c_str());
+			Mix_FreeMusic(decodedMusic);
+			decodedMusic = PackedData.empty() ? Mix_LoadMUS(FilePath.c_str()) : Mix_LoadMUS_RW(openPacked(), 1);
 		}
 		else
 		{
 			// TODO: Fix
 			THROW(99, string("Unknown audio asset sub type") + Type, "Audio Asset");
 		}
+	}
+
+	void AudioAsset::Upload()
+	{
+		Unload();
+
+		SoundEffect = std::exchange(decodedSoundEffect, nullptr);
+		Music = std::exchange(decodedMusic, nullptr);
 
 		IsLoadedInMemory = true;
 	}
 
+	size_t AudioAsset::GetSizeBytes() const
+	{
+		if (SoundEffect) { return SoundEffect->alen; }
+		return Music ? Asset::GetSizeBytes() : 0;
+	}
+
 	bool AudioAsset::Unload()
 	{
 		if (audioAssetType == AudioAssetType::SoundEffect)
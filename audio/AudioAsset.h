@@ -50,6 +50,21 @@ namespace gamelib
 		/// </summary>
 		void Load() override;
 
+		/// <summary>
+		/// Read and decode the audio, on any thread
+		/// </summary>
+		void Decode() override;
+
+		/// <summary>
+		/// Make the decoded audio the asset's
+		/// </summary>
+		void Upload() override;
+
+		/// <summary>
+		/// Size of a sound effect's samples. Music streams from its file, so its file size is used
+		/// </summary>
+		[[nodiscard]] size_t GetSizeBytes() const override;
+
 		/// <summary>
 		/// Free audio data from memory
 		/// </summary>
@@ -66,6 +81,12 @@ namespace gamelib
 		/// Eg. could be Music or Sound effect
 		/// </summary>
 		AudioAssetType audioAssetType;
+
+		/// <summary>
+		/// Decoded audio waiting for Upload()
+		/// </summary>
+		Mix_Chunk* decodedSoundEffect = nullptr;
+		Mix_Music* decodedMusic = nullptr;
 	};
 }
 
@@ -5,6 +5,7 @@
 #include "character/Direction.h"
 #include "exceptions/EngineException.h"
 #include "file/SettingsManager.h"
+#include "graphic/RenderPacket.h"
 #include <time/time.h>
 
 using namespace std;
@@ -105,6 +106,22 @@ namespace gamelib
 			}
 		}
 	}
+	bool AnimatedSprite::AddRenderItems(std::vector<RenderItem>& items) const
+	{
+		if (!HasGraphic() || GetGraphic()->Type != "graphic") { return false; }
+
+		const auto& frame = KeyFrames[currentFrameNumber];
+		RenderItem item;
+		item.Texture = GetGraphic()->GetTexture();
+		item.Source = { frame.X, frame.Y, frame.W, frame.H };
+		item.Destination = { Position.GetX(), Position.GetY(), frame.W, frame.H };
+		item.GameObjectId = Id;
+		item.FrameIndex = currentFrameNumber;
+		item.IsVisible = IsVisible;
+		items.push_back(item);
+		return true;
+	}
+
 	void AnimatedSprite::LoadSettings() { debug = SettingsManager::Get()->GetBool("sprite", "debug"); }
 	void AnimatedSprite::MoveSprite(const int x, const int y) { Position.SetX(x); Position.SetY(y); }
 	void AnimatedSprite::MoveSprite(const Coordinate<int> position) { Position = position; }
@@ -29,6 +29,7 @@ namespace gamelib
 
 		GameObjectType GetGameObjectType() override { return GameObjectType::animated_sprite; }
 		void Draw(SDL_Renderer* renderer) override;	
+		bool AddRenderItems(std::vector<RenderItem>& items) const override;
 		void LoadSettings() override;
 		void MoveSprite(int x, int y);
 		void MoveSprite(Coordinate<int> position);
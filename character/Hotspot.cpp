@@ -1,5 +1,6 @@
 #include "Hotspot.h"
 #include <SDL.h>
+#include "graphic/RenderPacket.h"
 
 namespace gamelib
 {
@@ -30,4 +31,13 @@ namespace gamelib
 		const auto bounds = GetBounds();
 		DrawFilledRect(renderer, &bounds, { 255, 0 ,0 ,0 });		
 	}
+
+	bool Hotspot::AddRenderItems(std::vector<RenderItem>& items) const
+	{
+		RenderItem item;
+		item.GameObjectId = Id;
+		item.Command = [bounds = GetBounds()](SDL_Renderer* renderer) { DrawFilledRect(renderer, &bounds, { 255, 0 ,0 ,0 }); };
+		items.push_back(item);
+		return true;
+	}
 }
\ No newline at end of file
@@ -22,6 +22,7 @@ namespace gamelib
 		[[nodiscard]] Coordinate<int> GetPosition() const;
 		Coordinate<int> ParentPosition;
 		void Draw(SDL_Renderer* renderer) override;
+		bool AddRenderItems(std::vector<RenderItem>& items) const override;
 		[[nodiscard]] Coordinate<int> CalculateHotspotPosition(int x, int y) const;
 		[[nodiscard]] Coordinate<int> CalculateHotspotPosition() const;
 		void Update(Coordinate<int> parentPosition);
@@ -24,6 +24,11 @@ void gamelib::Npc::Draw(SDL_Renderer* renderer)
 	Status->Draw(renderer);
 }
 
+bool gamelib::Npc::AddRenderItems(std::vector<RenderItem>& items) const
+{
+	return Sprite->AddRenderItems(items) && Status->AddRenderItems(items);
+}
+
 void gamelib::Npc::Update(const unsigned long deltaMs)
 {
 	Status->DrawBounds = {Bounds.x-10, Bounds.y-10, Bounds.w/2, Bounds.h /2};
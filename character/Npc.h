@@ -31,6 +31,7 @@ namespace gamelib
 
 		// NPCs override certain behavior:
 		void Draw(SDL_Renderer* renderer) override;
+		bool AddRenderItems(std::vector<RenderItem>& items) const override;
 		void Update(unsigned long deltaMs) override;
 		GameObjectType GetGameObjectType() override;
 
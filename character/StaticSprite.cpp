@@ -2,6 +2,7 @@
 #include <memory>
 #include <asset/SpriteAsset.h>
 #include "graphic/GraphicAsset.h"
+#include "graphic/RenderPacket.h"
 using namespace std;
 
 namespace gamelib
@@ -85,5 +86,20 @@ namespace gamelib
 			}
 		}
 	}
-}
 
+	bool StaticSprite::AddRenderItems(std::vector<RenderItem>& items) const
+	{
+		if (!HasGraphic() || GetGraphic()->Type != "graphic") { return false; }
+
+		const auto& frame = keyFrames[frameNumber];
+		RenderItem item;
+		item.Texture = GetGraphic()->GetTexture();
+		item.Source = { frame.X, frame.Y, frame.W, frame.H };
+		item.Destination = { Position.GetX(), Position.GetY(), frame.W, frame.H };
+		item.GameObjectId = Id;
+		item.FrameIndex = frameNumber;
+		item.IsVisible = IsVisible;
+		items.push_back(item);
+		return true;
+	}
+}
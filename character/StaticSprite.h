@@ -18,6 +18,7 @@ namespace gamelib
 
     public:
         void Draw(SDL_Renderer* renderer) override;
+        bool AddRenderItems(std::vector<RenderItem>& items) const override;
         ListOfEvents HandleEvent(const std::shared_ptr<Event>& event, unsigned long deltaMs) override;
 
         GameObjectType GetGameObjectType() override;
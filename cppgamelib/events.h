@@ -2,10 +2,15 @@
 #include <events/AddGameObjectToCurrentSceneEvent.h>
 #include <events/ControllerMoveEvent.h>
 #include <events/Event.h>
+#include <events/EventChannel.h>
+#include <events/EventDispatchProfiler.h>
 #include <events/EventFactory.h>
 #include <events/EventId.h>
+#include <events/EventJournal.h>
 #include <events/EventManager.h>
 #include <events/EventNumbers.h>
+#include <events/EventPool.h>
+#include <events/EventReplay.h>
 #include <events/EventSubscriber.h>
 #include <events/GameObjectEvent.h>
 #include <events/IEventSerializationManager.h>
@@ -6,5 +6,6 @@
 #include <graphic/GraphicAsset.h>
 #include <graphic/GraphicAssetFactory.h>
 #include <graphic/KeyFrame.h>
+#include <graphic/RenderPacket.h>
 #include <graphic/SDLGraphicsManager.h>
 
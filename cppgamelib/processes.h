@@ -3,3 +3,4 @@
 #include <processes/DelayProcess.h>
 #include <processes/Process.h>
 #include <processes/ProcessManager.h>
+#include <processes/Task.h>
\ No newline at end of file
@@ -1,4 +1,7 @@
 #pragma once
+#include <resource/AssetArchive.h>
+#include <resource/AssetLoader.h>
+#include <resource/AssetResidency.h>
 #include <resource/ResourceManager.h>
 
 
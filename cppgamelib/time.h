@@ -1,2 +1,3 @@
 #pragma once
-#include <time/Timer.h>
\ No newline at end of file
+#include <time/Timer.h>
+#include <time/TimerWheel.h>
\ No newline at end of file
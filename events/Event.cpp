@@ -3,11 +3,11 @@
 
 namespace gamelib
 {
-	std::string Event::ToString() { return Id.Name; }
+	std::string Event::ToString() { return Id.GetName(); }
 
 	Event::~Event() = default;
 
-	std::string operator+(const std::string& str, const EventId& id) { return str + id.Name; }
+	std::string operator+(const std::string& str, const EventId& id) { return str + id.GetName(); }
 
 	int Event::lastEventId = 0;
 }
@@ -0,0 +1,132 @@
+#pragma once
+#ifndef EVENTCHANNEL_H
+#define EVENTCHANNEL_H
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "EventManager.h"
+#include "exceptions/EngineException.h"
+
+namespace gamelib
+{
+	/// <summary>
+	/// Typed handlers for one event type T, registered as void(const T&).
+	/// Handlers are called directly with the concrete event: there is no dynamic_pointer_cast and no virtual
+	/// HandleEvent per handler. The channel subscribes itself to T's EventId, so T events raised through the
+	/// EventManager queues reach typed handlers alongside any IEventSubscriber subscribed to the same id.
+	/// Every event raised with T's EventId must be a T.
+	/// </summary>
+	template <typename T>
+	class EventChannel
+	{
+	public:
+		using Handler = std::function<void(const T& event)>;
+
+		// The channel for T. The first call fixes the EventId events of type T are raised with
+		static EventChannel& Get(const EventId& eventId)
+		{
+			// Never destroyed, like the EventManager it subscribes to
+			static auto* channel = new EventChannel(eventId);
+			if (channel->eventId != eventId) { THROW(0, "Event channel already bound to " + channel->eventId.GetName(), "EventChannel"); }
+			return *channel;
+		}
+
+		EventChannel(const EventChannel& other) = delete;
+		EventChannel& operator=(const EventChannel& other) = delete;
+
+		// Returns a token to unsubscribe with
+		int Subscribe(Handler handler)
+		{
+			auto owned = std::make_shared<Handler>(std::move(handler));
+			const auto target = owned.get();
+			return Add(target, [](void* handlerTarget, const T& event) { (*static_cast<Handler*>(handlerTarget))(event); }, std::move(owned));
+		}
+
+		// Bind a member function at compile time: Subscribe<&Listener::OnSceneChanged>(this)
+		template <auto Method, typename Listener>
+		int Subscribe(Listener* listener)
+		{
+			return Add(listener, [](void* target, const T& event) { (static_cast<Listener*>(target)->*Method)(event); }, nullptr);
+		}
+
+		void Unsubscribe(const int token)
+		{
+			const auto found = std::find_if(begin(handlers), end(handlers), [&](const Delegate& delegate) { return delegate.Token == token; });
+			if (found == end(handlers)) { return; }
+
+			// Can't reshuffle handlers while they are being called
+			if (publishing > 0) { found->Invoke = nullptr; }
+			else { handlers.erase(found); }
+		}
+
+		// Calls every handler now, bypassing the event queues
+		void Publish(const T& event)
+		{
+			publishing++;
+			for (size_t i = 0; i < handlers.size(); i++)
+			{
+				if (handlers[i].Invoke) { handlers[i].Invoke(handlers[i].Target, event); }
+			}
+			publishing--;
+
+			if (publishing == 0)
+			{
+				handlers.erase(std::remove_if(begin(handlers), end(handlers), [](const Delegate& delegate) { return delegate.Invoke == nullptr; }), end(handlers));
+			}
+		}
+
+		[[nodiscard]] size_t CountHandlers() const { return handlers.size(); }
+
+	private:
+		using InvokeFn = void(*)(void* target, const T& event);
+
+		struct Delegate
+		{
+			void* Target;
+			InvokeFn Invoke;
+			int Token;
+			std::shared_ptr<Handler> Owned;
+		};
+
+		// Bridges queued events from the EventManager to the typed handlers
+		class ChannelSubscriber final : public IEventSubscriber
+		{
+		public:
+			explicit ChannelSubscriber(EventChannel* channel) : channel(channel) {}
+
+			std::vector<std::shared_ptr<Event>> HandleEvent(const std::shared_ptr<Event>& evt, unsigned long deltaMs) override
+			{
+				channel->Publish(static_cast<const T&>(*evt));
+				return {};
+			}
+
+			std::string GetSubscriberName() override { return "EventChannel<" + channel->eventId.GetName() + ">"; }
+			int GetSubscriberId() override { return channel->eventId.GetPrimaryId(); }
+
+		private:
+			EventChannel* channel;
+		};
+
+		explicit EventChannel(EventId eventId) : eventId(std::move(eventId)), subscriber(this) {}
+
+		int Add(void* target, const InvokeFn invoke, std::shared_ptr<Handler> owned)
+		{
+			// Subscribing again is harmless and re-subscribes us if the event manager's subscribers were cleared
+			EventManager::Get()->SubscribeToEvent(eventId, &subscriber);
+
+			handlers.push_back({ target, invoke, ++lastToken, std::move(owned) });
+			return lastToken;
+		}
+
+		const EventId eventId;
+		ChannelSubscriber subscriber;
+		std::vector<Delegate> handlers;
+		int lastToken = 0;
+		int publishing = 0;
+	};
+}
+
+#endif
@@ -0,0 +1,143 @@
+#include "EventDispatchProfiler.h"
+#include <algorithm>
+
+namespace gamelib
+{
+	EventDispatchProfiler::EventDispatchProfiler(const size_t traceCapacity) : epoch(Clock::now()), traceCapacity(traceCapacity)
+	{
+		trace.reserve(traceCapacity);
+	}
+
+	void EventDispatchProfiler::Record(const EventId& eventId, const std::string& subscriberName, const Clock::time_point start, const Clock::time_point end, const size_t events, const size_t secondaryEvents)
+	{
+		const auto durationNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+		const auto eventKey = eventId.GetHandle();
+
+		std::lock_guard lock(mutex);
+
+		auto [found, added] = profileIndexes.try_emplace({ eventKey, subscriberName }, profiles.size());
+		if (added)
+		{
+			profiles.emplace_back();
+			profiles.back().EventName = eventId.GetName();
+			profiles.back().SubscriberName = subscriberName;
+		}
+
+		auto& profile = profiles[found->second];
+		profile.Calls++;
+		profile.Events += static_cast<unsigned long>(events);
+		profile.SecondaryEvents += static_cast<unsigned long>(secondaryEvents);
+		profile.TotalNs += durationNs;
+		profile.HandlerNs.Record(durationNs);
+
+		if (traceCapacity == 0) { return; }
+
+		const DispatchTraceRecord record
+		{
+			found->second,
+			static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(start - epoch).count()),
+			durationNs,
+			GetThreadNumber(std::this_thread::get_id())
+		};
+
+		if (trace.size() < traceCapacity) { trace.push_back(record); }
+		else { trace[nextTraceRecord] = record; }
+		nextTraceRecord = (nextTraceRecord + 1) % traceCapacity;
+	}
+
+	const DispatchProfile* EventDispatchProfiler::FindProfile(const EventId& eventId, const std::string& subscriberName) const
+	{
+		const auto eventKey = eventId.GetHandle();
+
+		std::lock_guard lock(mutex);
+		const auto found = profileIndexes.find({ eventKey, subscriberName });
+		return found != profileIndexes.end() ? &profiles[found->second] : nullptr;
+	}
+
+	std::vector<DispatchTraceRecord> EventDispatchProfiler::GetTrace() const
+	{
+		std::lock_guard lock(mutex);
+
+		// Once full, the oldest record is the next one to be overwritten
+		if (trace.size() < traceCapacity) { return trace; }
+
+		std::vector<DispatchTraceRecord> ordered(trace.begin() + static_cast<std::ptrdiff_t>(nextTraceRecord), trace.end());
+		ordered.insert(ordered.end(), trace.begin(), trace.begin() + static_cast<std::ptrdiff_t>(nextTraceRecord));
+		return ordered;
+	}
+
+	void EventDispatchProfiler::WriteChromeTrace(std::ostream& out) const
+	{
+		const auto records = GetTrace();
+
+		std::lock_guard lock(mutex);
+		out << "{\"traceEvents\":[";
+		for (size_t i = 0; i < records.size(); i++)
+		{
+			const auto& record = records[i];
+			const auto& profile = profiles[record.Profile];
+
+			// Timestamps are in microseconds
+			out << (i == 0 ? "" : ",") << "\n{\"name\":";
+			WriteJsonString(out, profile.SubscriberName);
+			out << ",\"cat\":";
+			WriteJsonString(out, profile.EventName);
+			out << ",\"ph\":\"X\",\"ts\":" << static_cast<double>(record.StartNs) / 1000.0
+			    << ",\"dur\":" << static_cast<double>(record.DurationNs) / 1000.0
+			    << ",\"pid\":1,\"tid\":" << record.Thread << ",\"args\":{\"event\":";
+			WriteJsonString(out, profile.EventName);
+			out << "}}";
+		}
+		out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+	}
+
+	void EventDispatchProfiler::WriteFoldedStacks(std::ostream& out) const
+	{
+		std::lock_guard lock(mutex);
+		for (const auto& profile : profiles)
+		{
+			// Frames are separated by ';' so keep it out of names
+			auto eventName = profile.EventName;
+			auto subscriberName = profile.SubscriberName;
+			std::replace(eventName.begin(), eventName.end(), ';', ':');
+			std::replace(subscriberName.begin(), subscriberName.end(), ';', ':');
+
+			out << "EventManager;" << eventName << ';' << subscriberName << ' ' << profile.TotalNs / 1000 << '\n';
+		}
+	}
+
+	void EventDispatchProfiler::Reset()
+	{
+		std::lock_guard lock(mutex);
+		profiles.clear();
+		profileIndexes.clear();
+		trace.clear();
+		nextTraceRecord = 0;
+		epoch = Clock::now();
+	}
+
+	unsigned int EventDispatchProfiler::GetThreadNumber(const std::thread::id threadId)
+	{
+		// Small stable numbers read better than thread id hashes in trace viewers
+		return threadNumbers.try_emplace(threadId, static_cast<unsigned int>(threadNumbers.size() + 1)).first->second;
+	}
+
+	void EventDispatchProfiler::WriteJsonString(std::ostream& out, const std::string& text)
+	{
+		out << '"';
+		for (const auto character : text)
+		{
+			switch (character)
+			{
+				case '"': out << "\\\""; break;
+				case '\\': out << "\\\\"; break;
+				case '\n': out << "\\n"; break;
+				case '\t': out << "\\t"; break;
+				default:
+					if (static_cast<unsigned char>(character) < 0x20) { out << ' '; }
+					else { out << character; }
+			}
+		}
+		out << '"';
+	}
+}
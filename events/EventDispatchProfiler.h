@@ -0,0 +1,105 @@
+#pragma once
+#ifndef EVENTDISPATCHPROFILER_H
+#define EVENTDISPATCHPROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "EventId.h"
+#include "utils/Histogram.h"
+
+namespace gamelib
+{
+	// Handler timings of one subscriber for one event type
+	struct DispatchProfile
+	{
+		std::string EventName;
+		std::string SubscriberName;
+
+		// Handler calls, and events handled by them (a batch call handles several)
+		unsigned long Calls {};
+		unsigned long Events {};
+		unsigned long SecondaryEvents {};
+		uint64_t TotalNs {};
+		Histogram HandlerNs;
+
+		[[nodiscard]] double GetAverageNs() const { return Calls == 0 ? 0.0 : static_cast<double>(TotalNs) / static_cast<double>(Calls); }
+		[[nodiscard]] uint64_t GetP99Ns() const { return HandlerNs.GetPercentile(99.0); }
+	};
+
+	// One handler call in the trace
+	struct DispatchTraceRecord
+	{
+		// Index into GetProfiles()
+		size_t Profile {};
+
+		// Since the profiler was created
+		uint64_t StartNs {};
+		uint64_t DurationNs {};
+		unsigned int Thread {};
+	};
+
+	/// <summary>
+	/// Records how long each subscriber spends handling each event type, see EventManager::SetDispatchProfiling().
+	/// The most recent handler calls are also kept in a fixed-size trace that can be exported for chrome://tracing
+	/// (or Perfetto), and totals can be exported as folded stacks for flamegraph tools.
+	/// Recording is thread-safe; reading is meant for between frames.
+	/// </summary>
+	class EventDispatchProfiler
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		explicit EventDispatchProfiler(size_t traceCapacity = 65536);
+
+		void Record(const EventId& eventId, const std::string& subscriberName, Clock::time_point start, Clock::time_point end, size_t events, size_t secondaryEvents);
+
+		[[nodiscard]] const std::vector<DispatchProfile>& GetProfiles() const { return profiles; }
+		[[nodiscard]] const DispatchProfile* FindProfile(const EventId& eventId, const std::string& subscriberName) const;
+
+		// Oldest first
+		[[nodiscard]] std::vector<DispatchTraceRecord> GetTrace() const;
+
+		// Chrome trace event format: one complete event per handler call in the trace
+		void WriteChromeTrace(std::ostream& out) const;
+
+		// "EventManager;<event>;<subscriber> <total microseconds>" per profile
+		void WriteFoldedStacks(std::ostream& out) const;
+
+		void Reset();
+
+	private:
+		struct ProfileKey
+		{
+			uint64_t EventKey;
+			std::string SubscriberName;
+			bool operator==(const ProfileKey& other) const { return EventKey == other.EventKey && SubscriberName == other.SubscriberName; }
+		};
+		struct ProfileKeyHash
+		{
+			size_t operator()(const ProfileKey& key) const { return std::hash<uint64_t>()(key.EventKey) ^ std::hash<std::string>()(key.SubscriberName) << 1; }
+		};
+
+		unsigned int GetThreadNumber(std::thread::id threadId);
+		static void WriteJsonString(std::ostream& out, const std::string& text);
+
+		mutable std::mutex mutex;
+		Clock::time_point epoch;
+		std::vector<DispatchProfile> profiles;
+		std::unordered_map<ProfileKey, size_t, ProfileKeyHash> profileIndexes;
+
+		// Ring of the latest handler calls
+		std::vector<DispatchTraceRecord> trace;
+		size_t traceCapacity;
+		size_t nextTraceRecord = 0;
+
+		std::unordered_map<std::thread::id, unsigned int> threadNumbers;
+	};
+}
+
+#endif
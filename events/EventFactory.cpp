@@ -21,6 +21,7 @@
 #include "UpdateAllGameObjectsEvent.h"
 #include "UpdateProcessesEvent.h"
 #include <events/SceneChangedEvent.h>
+#include "EventPool.h"
 
 namespace gamelib
 {
@@ -48,7 +49,7 @@ namespace gamelib
 
 	std::shared_ptr<Event> EventFactory::CreateGenericEvent(const EventId& id, const std::string& origin = "")
 	{
-		auto event = std::make_shared<Event>(id);
+		auto event = EventPool<Event>::Get()->Create(id);
 		event->Origin = origin;
 		return event;
 	}
@@ -57,7 +58,7 @@ namespace gamelib
 	std::shared_ptr<PlayerMovedEvent> EventFactory::CreatePlayerMovedEvent(const Direction direction, const std::string
 	                                                                       & target)
 	{
-		return std::make_shared<PlayerMovedEvent>(direction);
+		return EventPool<PlayerMovedEvent>::Get()->Create(direction);
 	}
 
 	std::shared_ptr<PlayerMovedEvent> EventFactory::CreatePlayerMovedEvent(const std::string& serializedMessage) const
@@ -68,7 +69,7 @@ namespace gamelib
 	std::shared_ptr<NetworkTrafficReceivedEvent> EventFactory::CreateNetworkTrafficReceivedEvent(const std::string&
 		message, const std::string& identifier, const int bytesReceived, const std::string& origin)
 	{
-		auto event = std::make_shared<NetworkTrafficReceivedEvent>();
+		auto event = EventPool<NetworkTrafficReceivedEvent>::Get()->Create();
 		event->Message = message;
 		event->Identifier = identifier;
 		event->BytesReceived = bytesReceived;
@@ -78,76 +79,76 @@ namespace gamelib
 
 	std::shared_ptr<SceneChangedEvent> EventFactory::CreateLevelEvent(const int level)
 	{
-		return std::make_shared<SceneChangedEvent>(level);
+		return EventPool<SceneChangedEvent>::Get()->Create(level);
 	}
 
 	std::shared_ptr<UpdateAllGameObjectsEvent> EventFactory::CreateUpdateAllGameObjectsEvent()
 	{
-		return std::make_shared<UpdateAllGameObjectsEvent>();
+		return EventPool<UpdateAllGameObjectsEvent>::Get()->Create();
 	}
 
 	std::shared_ptr<UpdateProcessesEvent> EventFactory::CreateUpdateProcessesEvent()
 	{
-		return std::make_shared<UpdateProcessesEvent>();
+		return EventPool<UpdateProcessesEvent>::Get()->Create();
 	}
 
 	std::shared_ptr<StartNetworkLevelEvent> EventFactory::CreateStartNetworkLevelEvent(const int level)
 	{
-		return std::make_shared<StartNetworkLevelEvent>(level);
+		return EventPool<StartNetworkLevelEvent>::Get()->Create(level);
 	}
 
 	std::shared_ptr<Event> EventFactory::CreateNetworkPlayerJoinedEvent(const NetworkPlayer& player)
 	{
-		return std::make_shared<NetworkPlayerJoinedEvent>(player);
+		return EventPool<NetworkPlayerJoinedEvent>::Get()->Create(player);
 	}
 
 	std::shared_ptr<ControllerMoveEvent> EventFactory::CreateControllerMoveEvent(Direction direction,
 		ControllerMoveEvent::KeyState keyState)
 	{
-		return std::make_shared<ControllerMoveEvent>(direction, keyState);
+		return EventPool<ControllerMoveEvent>::Get()->Create(direction, keyState);
 	}
 
 	std::shared_ptr<Event> EventFactory::CreateSubscriberHandledEvent(IEventSubscriber* value,
 	                                                                  const std::shared_ptr<Event>& event,
 	                                                                  unsigned long deltaMs)
 	{
-		return std::make_shared<SubscriberHandledEvent>(value, event, deltaMs);
+		return EventPool<SubscriberHandledEvent>::Get()->Create(value, event, deltaMs);
 	}
 
 	std::shared_ptr<ReliableUdpPacketReceivedEvent> EventFactory::CreateReliableUdpPacketReceived(std::shared_ptr<Message> message)
 	{
-		return std::make_shared<ReliableUdpPacketReceivedEvent>(message);
+		return EventPool<ReliableUdpPacketReceivedEvent>::Get()->Create(message);
 	}
 
 	std::shared_ptr<ReliableUdpCheckSumFailedEvent> EventFactory::CreateReliableUdpCheckSumFailedEvent(std::shared_ptr<Message> failedMessage)
 	{
-		return std::make_shared<ReliableUdpCheckSumFailedEvent>(failedMessage);
+		return EventPool<ReliableUdpCheckSumFailedEvent>::Get()->Create(failedMessage);
 	}
 
 	std::shared_ptr<ReliableUdpPacketLossDetectedEvent> EventFactory::CreateReliableUdpPacketLossDetectedEvent(const std::shared_ptr<Message>& messageBundle)
 	{
-		return std::make_shared<ReliableUdpPacketLossDetectedEvent>(messageBundle);
+		return EventPool<ReliableUdpPacketLossDetectedEvent>::Get()->Create(messageBundle);
 	}
 
 	std::shared_ptr<ReliableUdpAckPacketEvent> EventFactory::CreateReliableUdpAckPacketEvent(
 		const std::shared_ptr<Message>& message, bool isSent)
 	{
-		return std::make_shared<ReliableUdpAckPacketEvent>(message, isSent);
+		return EventPool<ReliableUdpAckPacketEvent>::Get()->Create(message, isSent);
 	}
 
 	std::shared_ptr<ReliableUdpPacketRttCalculatedEvent> EventFactory::CreateReliableUdpPacketRttCalculatedEvent(
 		const std::shared_ptr<Message>& message, Rtt rtt)
 	{
-		return std::make_shared<ReliableUdpPacketRttCalculatedEvent>(message, rtt);
+		return EventPool<ReliableUdpPacketRttCalculatedEvent>::Get()->Create(message, rtt);
 	}
 
 	std::shared_ptr<AddGameObjectToCurrentSceneEvent> EventFactory::CreateAddToSceneEvent(const std::shared_ptr<GameObject> & obj)
 	{
-		return std::make_shared<AddGameObjectToCurrentSceneEvent>(obj);
+		return EventPool<AddGameObjectToCurrentSceneEvent>::Get()->Create(obj);
 	}
 
 	std::shared_ptr<SceneChangedEvent> EventFactory::CreateSceneChangedEventEvent(const int newLevel)
 	{
-		return std::make_shared<SceneChangedEvent>(newLevel);
+		return EventPool<SceneChangedEvent>::Get()->Create(newLevel);
 	}
 }
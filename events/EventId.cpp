@@ -1,23 +1,89 @@
 #include "EventId.h"
+#include <array>
+#include <atomic>
+#include <mutex>
 #include <tuple>
+#include <unordered_map>
+#include "exceptions/EngineException.h"
 
-namespace gamelib 
+namespace gamelib
 {
-	EventId::EventId(const int pid, std::string name, const int sid) : PrimaryId(pid), SecondaryId(sid), Name(std::move(name))
-	{}
-
-	bool EventId::operator==(const EventId& other) const
+	namespace
 	{
-		return other.PrimaryId == PrimaryId && other.SecondaryId == SecondaryId;
-	}
+		struct EventIdEntry
+		{
+			int PrimaryId {};
+			int SecondaryId {};
+			std::string Name;
+		};
 
-	bool EventId::operator!=(const EventId& other) const
-	{
-		return !(other == *this);
+		/// <summary>
+		/// Every EventId ever created. Entries are added in fixed-size chunks and never move or change once added,
+		/// so anyone holding a handle can read its entry without locking; only interning a new id locks.
+		/// </summary>
+		class EventIdRegistry
+		{
+		public:
+			static EventIdRegistry* Get()
+			{
+				// Never destroyed, as ids may still be logged while other statics are torn down
+				static auto* instance = new EventIdRegistry();
+				return instance;
+			}
+
+			uint32_t Intern(const int primaryId, const std::string_view name, const int secondaryId)
+			{
+				const auto key = static_cast<uint64_t>(static_cast<uint32_t>(primaryId)) << 32 | static_cast<uint32_t>(secondaryId);
+
+				std::lock_guard lock(mutex);
+				const auto [found, added] = handles.try_emplace(key, count);
+				if (!added) { return found->second; }
+
+				const auto chunk = count >> ChunkBits;
+				if (chunk >= MaxChunks)
+				{
+					handles.erase(found);
+					THROW(0, "Too many event ids", "EventId");
+				}
+
+				auto entries = chunks[chunk].load(std::memory_order_relaxed);
+				if (entries == nullptr)
+				{
+					entries = new EventIdEntry[ChunkSize];
+					chunks[chunk].store(entries, std::memory_order_release);
+				}
+				entries[count & ChunkMask] = { primaryId, secondaryId, std::string(name) };
+
+				return count++;
+			}
+
+			[[nodiscard]] const EventIdEntry& Lookup(const uint32_t handle) const
+			{
+				return chunks[handle >> ChunkBits].load(std::memory_order_acquire)[handle & ChunkMask];
+			}
+
+		private:
+			static constexpr uint32_t ChunkBits = 8;
+			static constexpr uint32_t ChunkSize = 1 << ChunkBits;
+			static constexpr uint32_t ChunkMask = ChunkSize - 1;
+			static constexpr uint32_t MaxChunks = 1024;
+
+			std::mutex mutex;
+			std::unordered_map<uint64_t, uint32_t> handles;
+			std::array<std::atomic<EventIdEntry*>, MaxChunks> chunks {};
+			uint32_t count = 0;
+		};
 	}
 
+	EventId::EventId(const int pid, const std::string_view name, const int sid) : handle(EventIdRegistry::Get()->Intern(pid, name, sid))
+	{}
+
 	bool EventId::operator<(EventId const& other) const
 	{
-		return std::tie(PrimaryId, SecondaryId) < std::tie(other.PrimaryId, other.SecondaryId);
+		return std::make_tuple(GetPrimaryId(), GetSecondaryId()) < std::make_tuple(other.GetPrimaryId(), other.GetSecondaryId());
 	}
+
+	int EventId::GetPrimaryId() const { return EventIdRegistry::Get()->Lookup(handle).PrimaryId; }
+	int EventId::GetSecondaryId() const { return EventIdRegistry::Get()->Lookup(handle).SecondaryId; }
+	const std::string& EventId::GetName() const { return EventIdRegistry::Get()->Lookup(handle).Name; }
 }
@@ -3,21 +3,47 @@
 #ifndef EVENTID_H
 #define EVENTID_H
 
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <string_view>
+#include <type_traits>
 
-namespace gamelib 
+namespace gamelib
 {
+    /// <summary>
+    /// Identifies a type of event by primary and secondary id.
+    /// Ids are interned in a global registry, so an EventId is a 32-bit handle that is cheap to copy, compare and hash.
+    /// Ids with the same primary and secondary id are equal and share the name they were first created with.
+    /// </summary>
     class EventId
     {
     public:
-        EventId(int pid, std::string name, int sid = 0);
-        bool operator== (const EventId& other) const;
-        bool operator!=(const EventId& other) const;
+        EventId(int pid, std::string_view name, int sid = 0);
+        bool operator== (const EventId& other) const { return handle == other.handle; }
+        bool operator!=(const EventId& other) const { return handle != other.handle; }
         bool operator< (EventId const& other) const;
-        const int PrimaryId;
-        const int SecondaryId;
-        const std::string Name;
+
+        [[nodiscard]] int GetPrimaryId() const;
+        [[nodiscard]] int GetSecondaryId() const;
+
+        // Looked up in the registry, so best kept for logging and serialization
+        [[nodiscard]] const std::string& GetName() const;
+
+        // Dense from 0 in order of first use: suitable for indexing
+        [[nodiscard]] uint32_t GetHandle() const { return handle; }
+
+    private:
+        uint32_t handle;
     };
+
+    static_assert(std::is_trivially_copyable_v<EventId> && sizeof(EventId) == sizeof(uint32_t));
 }
 
+template <>
+struct std::hash<gamelib::EventId>
+{
+    size_t operator()(const gamelib::EventId& id) const noexcept { return id.GetHandle(); }
+};
+
 #endif
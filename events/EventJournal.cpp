@@ -0,0 +1,186 @@
+#include "EventJournal.h"
+#include <typeinfo>
+#include "Event.h"
+#include "EventNumbers.h"
+#include "SceneAssetsReadyEvent.h"
+#include "SceneChangedEvent.h"
+#include "SceneLoadedEvent.h"
+#include "UpdateAllGameObjectsEvent.h"
+#include "UpdateProcessesEvent.h"
+#include "exceptions/EngineException.h"
+#include "file/SerializationManager.h"
+
+namespace gamelib
+{
+	EventJournalCodecs::EventJournalCodecs()
+	{
+		// Scene ids are written as text, followed by anything else on their own lines
+		Register(SceneChangedEventTypeEventId,
+		         [](const Event& event)
+		         {
+			         const auto& sceneChanged = static_cast<const SceneChangedEvent&>(event);
+			         return std::to_string(sceneChanged.SceneId) + '\n' + sceneChanged.SceneFilePath;
+		         },
+		         [](const std::string& payload)
+		         {
+			         const auto lineEnd = payload.find('\n');
+			         auto event = std::make_shared<SceneChangedEvent>(std::stoi(payload.substr(0, lineEnd)));
+			         if (lineEnd != std::string::npos) { event->SceneFilePath = payload.substr(lineEnd + 1); }
+			         return event;
+		         });
+		Register(SceneLoadedEventId,
+		         [](const Event& event) { return std::to_string(static_cast<const SceneLoadedEvent&>(event).SceneId); },
+		         [](const std::string& payload) { return std::make_shared<SceneLoadedEvent>(std::stoi(payload)); });
+		Register(SceneAssetsReadyEventId,
+		         [](const Event& event)
+		         {
+			         const auto& ready = static_cast<const SceneAssetsReadyEvent&>(event);
+			         return std::to_string(ready.SceneId) + '\n' + std::to_string(ready.FailedAssets);
+		         },
+		         [](const std::string& payload)
+		         {
+			         const auto lineEnd = payload.find('\n');
+			         return std::make_shared<SceneAssetsReadyEvent>(std::stoi(payload.substr(0, lineEnd)), static_cast<unsigned int>(std::stoul(payload.substr(lineEnd + 1))));
+		         });
+		RegisterStateless<UpdateAllGameObjectsEvent>(UpdateAllGameObjectsEventTypeEventId);
+		RegisterStateless<UpdateProcessesEvent>(UpdateProcessesEventId);
+	}
+
+	void EventJournalCodecs::Register(const EventId& eventId, Encoder encode, Decoder decode)
+	{
+		codecs[eventId.GetPrimaryId()] = { std::move(encode), std::move(decode) };
+	}
+
+	std::string EventJournalCodecs::Encode(const Event& event) const
+	{
+		return codecs.at(event.Id.GetPrimaryId()).first(event);
+	}
+
+	std::shared_ptr<Event> EventJournalCodecs::Decode(const int primaryId, const std::string& payload) const
+	{
+		const auto codec = codecs.find(primaryId);
+		return codec == codecs.end() ? nullptr : codec->second.second(payload);
+	}
+
+	EventJournalWriter::EventJournalWriter(const std::string& fileName, std::shared_ptr<SerializationManager> serializationManager,
+	                                       std::shared_ptr<EventJournalCodecs> codecs)
+		: file(fileName, std::ios::binary | std::ios::trunc),
+		  serializationManager(std::move(serializationManager)),
+		  codecs(codecs ? std::move(codecs) : std::make_shared<EventJournalCodecs>()),
+		  excluded({ DrawCurrentScene })
+	{
+		if (!file.is_open()) { THROW(0, "Could not create event journal " + fileName, "EventJournal"); }
+
+		WriteValue(EventJournalMagic);
+		WriteValue(EventJournalVersion);
+	}
+
+	EventJournalWriter::~EventJournalWriter() { file.flush(); }
+
+	void EventJournalWriter::Write(const JournalRecordType type, const uint32_t frameNumber, const uint32_t deltaMs, const std::shared_ptr<Event>& event)
+	{
+		const auto primaryId = event->Id.GetPrimaryId();
+		if (excluded.contains(primaryId)) { return; }
+
+		EventJournalRecord record;
+		record.Type = type;
+		record.FrameNumber = frameNumber;
+		record.DeltaMs = deltaMs;
+		record.PrimaryId = primaryId;
+		record.SecondaryId = event->Id.GetSecondaryId();
+		record.Name = event->Id.GetName();
+		record.Origin = event->Origin;
+
+		// Only what will be replayed needs its payload
+		if (type == JournalRecordType::Raised || type == JournalRecordType::DispatchedDirectly)
+		{
+			if (codecs->CanEncode(primaryId))
+			{
+				record.PayloadType = JournalPayloadType::Codec;
+				record.Payload = codecs->Encode(*event);
+			}
+			else if (serializationManager && SerializationManager::CanSerialize(event->Id))
+			{
+				record.PayloadType = JournalPayloadType::Serialized;
+				record.Payload = serializationManager->SerializeEvent(event, "");
+			}
+			else if (typeid(*event) == typeid(Event))
+			{
+				record.PayloadType = JournalPayloadType::Plain;
+			}
+		}
+
+		WriteRecord(record);
+	}
+
+	void EventJournalWriter::WriteFrame(const uint32_t frameNumber, const uint32_t deltaMs)
+	{
+		EventJournalRecord record;
+		record.Type = JournalRecordType::Frame;
+		record.FrameNumber = frameNumber;
+		record.DeltaMs = deltaMs;
+		WriteRecord(record);
+	}
+
+	void EventJournalWriter::Flush() { file.flush(); }
+
+	void EventJournalWriter::Exclude(const EventId& eventId) { excluded.insert(eventId.GetPrimaryId()); }
+
+	void EventJournalWriter::WriteRecord(const EventJournalRecord& record)
+	{
+		WriteValue(static_cast<uint8_t>(record.Type));
+		WriteValue(record.FrameNumber);
+		WriteValue(record.DeltaMs);
+		WriteValue(record.PrimaryId);
+		WriteValue(record.SecondaryId);
+		WriteString(record.Name);
+		WriteString(record.Origin);
+		WriteValue(static_cast<uint8_t>(record.PayloadType));
+		WriteString(record.Payload);
+		recordsWritten++;
+	}
+
+	void EventJournalWriter::WriteString(const std::string& text)
+	{
+		WriteValue(static_cast<uint32_t>(text.size()));
+		file.write(text.data(), static_cast<std::streamsize>(text.size()));
+	}
+
+	EventJournalReader::EventJournalReader(const std::string& fileName) : file(fileName, std::ios::binary)
+	{
+		if (!file.is_open()) { THROW(0, "Could not open event journal " + fileName, "EventJournal"); }
+
+		uint32_t magic = 0, version = 0;
+		if (!ReadValue(magic) || magic != EventJournalMagic) { THROW(0, fileName + " is not an event journal", "EventJournal"); }
+		if (!ReadValue(version) || version != EventJournalVersion) { THROW(0, "Unsupported event journal version in " + fileName, "EventJournal"); }
+	}
+
+	bool EventJournalReader::ReadNext(EventJournalRecord& record)
+	{
+		uint8_t type = 0;
+		if (!ReadValue(type)) { return false; }
+		record.Type = static_cast<JournalRecordType>(type);
+
+		uint8_t payloadType = 0;
+		const auto read = ReadValue(record.FrameNumber)
+			&& ReadValue(record.DeltaMs)
+			&& ReadValue(record.PrimaryId)
+			&& ReadValue(record.SecondaryId)
+			&& ReadString(record.Name)
+			&& ReadString(record.Origin)
+			&& ReadValue(payloadType)
+			&& ReadString(record.Payload);
+		record.PayloadType = static_cast<JournalPayloadType>(payloadType);
+		return read;
+	}
+
+	bool EventJournalReader::ReadString(std::string& text)
+	{
+		// A length this large means a damaged journal rather than a real string
+		uint32_t size = 0;
+		if (!ReadValue(size) || size > MaxStringSize) { return false; }
+
+		text.resize(size);
+		return size == 0 || static_cast<bool>(file.read(text.data(), size));
+	}
+}
@@ -0,0 +1,157 @@
+#pragma once
+#ifndef EVENTJOURNAL_H
+#define EVENTJOURNAL_H
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+namespace gamelib
+{
+	class Event;
+	class EventId;
+	class SerializationManager;
+
+	enum class JournalRecordType : uint8_t
+	{
+		// Raised from outside of dispatch: game input, network, timers. Replayed
+		Raised = 1,
+
+		// Raised by a subscriber while handling another event. Replay regenerates these, so they are only informational
+		RaisedWhileDispatching = 2,
+
+		// Dispatched straight to subscribers with DispatchEventToSubscriber(), not through the queues. Replayed
+		DispatchedDirectly = 3,
+
+		// Taken off the queues and dispatched. Informational
+		Dispatched = 4,
+
+		// ProcessAllEvents() was called. Replayed
+		Frame = 5
+	};
+
+	// How a record's event was written, and so how replay rebuilds it
+	enum class JournalPayloadType : uint8_t
+	{
+		// Nothing to rebuild the event from. Replay skips it
+		None = 0,
+
+		// A plain Event, rebuilt from its id
+		Plain = 1,
+
+		// Written by the event type's EventJournalCodecs entry
+		Codec = 2,
+
+		// Written by the serialization manager
+		Serialized = 3
+	};
+
+	struct EventJournalRecord
+	{
+		JournalRecordType Type {};
+		uint32_t FrameNumber {};
+		uint32_t DeltaMs {};
+		int32_t PrimaryId {};
+		int32_t SecondaryId {};
+		std::string Name {};
+		std::string Origin {};
+		JournalPayloadType PayloadType {};
+		std::string Payload {};
+	};
+
+	/// <summary>
+	/// How to write the contents of each event type into a journal and rebuild the event on replay, by primary id.
+	/// Starts out with the engine's own events (scene changes, logic and process updates); games register theirs.
+	/// </summary>
+	class EventJournalCodecs
+	{
+	public:
+		using Encoder = std::function<std::string(const Event& event)>;
+		using Decoder = std::function<std::shared_ptr<Event>(const std::string& payload)>;
+
+		EventJournalCodecs();
+
+		void Register(const EventId& eventId, Encoder encode, Decoder decode);
+
+		// For event types with nothing to record beyond their type
+		template <typename T>
+		void RegisterStateless(const EventId& eventId)
+		{
+			Register(eventId, [](const Event&) { return std::string(); }, [](const std::string&) { return std::make_shared<T>(); });
+		}
+
+		[[nodiscard]] bool CanEncode(int primaryId) const { return codecs.contains(primaryId); }
+		[[nodiscard]] std::string Encode(const Event& event) const;
+
+		// Null when the type has no codec
+		[[nodiscard]] std::shared_ptr<Event> Decode(int primaryId, const std::string& payload) const;
+
+	private:
+		std::map<int, std::pair<Encoder, Decoder>> codecs;
+	};
+
+	/// <summary>
+	/// Appends event records to a compact binary journal, see EventManager::SetEventJournal().
+	/// Replayed events get a payload from their type's codec, else from the serialization manager for types it can
+	/// serialize (e.g. player and controller movement); plain Events need only their id. Events of any other type are
+	/// recorded without one and skipped on replay. Integers are written in the machine's byte order.
+	/// Drawing is presentation rather than game state, so DrawCurrentScene is not journaled.
+	/// </summary>
+	class EventJournalWriter
+	{
+	public:
+		explicit EventJournalWriter(const std::string& fileName, std::shared_ptr<SerializationManager> serializationManager = nullptr,
+		                            std::shared_ptr<EventJournalCodecs> codecs = nullptr);
+		~EventJournalWriter();
+
+		EventJournalWriter(const EventJournalWriter& other) = delete;
+		EventJournalWriter& operator=(const EventJournalWriter& other) = delete;
+
+		void Write(JournalRecordType type, uint32_t frameNumber, uint32_t deltaMs, const std::shared_ptr<Event>& event);
+		void WriteFrame(uint32_t frameNumber, uint32_t deltaMs);
+		void Flush();
+
+		// Leave events of this type out of the journal, e.g. other presentation-only events
+		void Exclude(const EventId& eventId);
+
+		[[nodiscard]] unsigned long GetRecordsWritten() const { return recordsWritten; }
+
+	private:
+		void WriteRecord(const EventJournalRecord& record);
+		template <typename T> void WriteValue(T value) { file.write(reinterpret_cast<const char*>(&value), sizeof(value)); }
+		void WriteString(const std::string& text);
+
+		std::ofstream file;
+		std::shared_ptr<SerializationManager> serializationManager;
+		std::shared_ptr<EventJournalCodecs> codecs;
+		std::set<int> excluded;
+		unsigned long recordsWritten = 0;
+	};
+
+	// Reads back the records of a journal written by EventJournalWriter
+	class EventJournalReader
+	{
+	public:
+		explicit EventJournalReader(const std::string& fileName);
+
+		// False at the end of the journal, or at a record cut short (e.g. by a crash while writing)
+		bool ReadNext(EventJournalRecord& record);
+
+	private:
+		template <typename T> bool ReadValue(T& value) { return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value))); }
+		bool ReadString(std::string& text);
+
+		static constexpr uint32_t MaxStringSize = 16 * 1024 * 1024;
+		std::ifstream file;
+	};
+
+	// First bytes of every journal
+	constexpr uint32_t EventJournalMagic = 0x4A45474C; // "LGEJ"
+	constexpr uint32_t EventJournalVersion = 2;
+}
+
+#endif
@@ -10,18 +10,55 @@
 #include <string>
 #include "EventFactory.h"
 #include "UpdateAllGameObjectsEvent.h"
+#include "EventNumbers.h"
+#include "utils/ThreadPool.h"
+#include "EventJournal.h"
+#include "structure/Profiler.h"
 
 using namespace std;
 
 namespace gamelib
 {	
-	EventManager::EventManager() : logEvents(false), printStatistics(false)
+	namespace
 	{
+		// Subscriptions removed while dispatching are only compacted away once no dispatch is in progress
+		struct DispatchScope
+		{
+			explicit DispatchScope(int& depth) : depth(depth) { depth++; }
+			~DispatchScope() { depth--; }
+			int& depth;
+		};
+	}
+
+
+	EventManager::EventManager() : gameLoopThreadId(std::this_thread::get_id()), logEvents(false), printStatistics(false)
+	{
+	}
+
+	const std::map<const EventId, std::vector<IEventSubscriber*>>& EventManager::GetSubscriptions()
+	{
+		CompactSubscriptions();
+		return eventSubscribers;
 	}
 
-	std::map<const EventId, std::vector<IEventSubscriber*>>& EventManager::GetSubscriptions() { return eventSubscribers; }
 	std::string EventManager::GetSubscriberName() { return "EventManager"; }
-	void EventManager::ClearSubscribers() { this->eventSubscribers.clear(); }
+	void EventManager::ClearSubscribers()
+	{
+		this->eventSubscribers.clear();
+		denseSubscribers.clear();
+
+		// Outstanding handles become stale
+		for (uint32_t index = 0; index < subscriptions.size(); index++)
+		{
+			if (subscriptions[index].Subscriber == nullptr) { continue; }
+			subscriptions[index] = { nullptr, 0, 0, nullptr, 0, subscriptions[index].Generation + 1 };
+			freeSubscriptions.push_back(index);
+		}
+		subscriptionIndexes.clear();
+		subscriptionsBySubscriberId.clear();
+		subscriptionLists.clear();
+		subscriptionListsWithRemovals.clear();
+	}
 
 	EventManager* EventManager::Get()
 	{
@@ -34,15 +71,42 @@ namespace gamelib
 
 	EventManager* EventManager::instance = nullptr;
 
-	size_t EventManager::CountReady() const { return primaryEventQueue.size() + secondaryEventQueue.size(); }
+	size_t EventManager::CountReady() const
+	{
+		size_t count = secondaryEventQueue.size() + ingressEventQueue.Size();
+		for (const auto& queue : primaryEventQueues) { count += queue.size(); }
+		return count;
+	}
 
-	std::queue<shared_ptr<Event>> EventManager::GetEvents() { return primaryEventQueue;}
+	std::queue<shared_ptr<Event>> EventManager::GetEvents()
+	{
+		// In the order they will be dispatched
+		std::queue<shared_ptr<Event>> events;
+		for (auto queue : primaryEventQueues)
+		{
+			for (; !queue.empty(); queue.pop()) { events.push(queue.front().TheEvent); }
+		}
+		return events;
+	}
 
 	void EventManager::Reset()
 	{
-		std::queue<shared_ptr<Event>> empty;
-		std::swap( primaryEventQueue, empty );
+		for (auto& queue : primaryEventQueues)
+		{
+			std::queue<QueuedEvent> empty;
+			std::swap( queue, empty );
+		}
+		std::queue<QueuedEvent> empty;
 		std::swap( secondaryEventQueue, empty );		  
+		framesDeferred.fill(0);
+
+		QueuedEvent discarded;
+		while (ingressEventQueue.TryPop(discarded)) {}
+
+		waitingCoalescedEvents.clear();
+
+		for (const auto key : pendingEventBatches) { eventBatches[key].clear(); }
+		pendingEventBatches.clear();
 	}
 
 	EventManager::~EventManager() { Logger::Get()->LogThis("Event manager dying."); instance = nullptr; }
@@ -60,7 +124,7 @@ namespace gamelib
 		if(!you) { Logger::Get()->LogThis("Invalid sender", true); return; }
 		
 		event->Origin = you->GetSubscriberName();
-		primaryEventQueue.push(event);		
+		Enqueue(event);
 
 		LogEventRaised(you, event);
 	}
@@ -70,46 +134,338 @@ namespace gamelib
 		if (logEvents)
 		{
 			std::stringstream log;
-			log << "EventManager: " << you->GetSubscriberName() << " raised to event " << event->Id.Name;
+			log << "EventManager: " << you->GetSubscriberName() << " raised to event " << event->Id.GetName();
+
+			if (event->Id.GetPrimaryId() != UpdateAllGameObjectsEventTypeEventId.GetPrimaryId()) { Logger::Get()->LogThis(log.str()); }
+		}
+	}
+
+	void EventManager::RaiseEventWithNoLogging(const std::shared_ptr<Event>& event) { Enqueue(event); }
+
+	void EventManager::Enqueue(const std::shared_ptr<Event>& event)
+	{
+		if (std::this_thread::get_id() == gameLoopThreadId.load(std::memory_order_relaxed))
+		{
+			// Events raised by subscribers while handling will be raised again on replay, so only external ones are replayed
+			if (journal) { journal->Write(dispatchDepth > 0 ? JournalRecordType::RaisedWhileDispatching : JournalRecordType::Raised, frameNumber, 0, event); }
+			PushPrimaryEvent({ event, EventClock::now() });
+			return;
+		}
+
+		// Background threads never touch the primary queue. A full ingress queue drops the event (see GetIngressStatistics)
+		ingressEventQueue.TryPush({ event, EventClock::now() });
+	}
+
+	void EventManager::SetGameLoopThread() { gameLoopThreadId.store(std::this_thread::get_id(), std::memory_order_relaxed); }
+
+	void EventManager::DrainIngressQueue()
+	{
+		QueuedEvent queued;
+		while (ingressEventQueue.TryPop(queued))
+		{
+			if (journal) { journal->Write(JournalRecordType::Raised, frameNumber, 0, queued.TheEvent); }
+			PushPrimaryEvent(std::move(queued));
+		}
+	}
+
+	void EventManager::SetEventPriority(const EventId& eventId, const EventPriority priority)
+	{
+		if (priority == EventPriority::Normal)
+		{
+			eventPriorities.erase(GetEventKey(eventId));
+			return;
+		}
+
+		eventPriorities[GetEventKey(eventId)] = priority;
+	}
+
+	EventPriority EventManager::GetEventPriority(const Event& event) const
+	{
+		if (eventPriorities.empty()) { return EventPriority::Normal; }
+
+		const auto found = eventPriorities.find(GetEventKey(event.Id));
+		return found != eventPriorities.end() ? found->second : EventPriority::Normal;
+	}
+
+	void EventManager::SetFrameBudget(const std::chrono::microseconds budget, const unsigned int maxFramesDeferred)
+	{
+		frameBudget = budget;
+		this->maxFramesDeferred = maxFramesDeferred;
+	}
+
+	const Histogram& EventManager::GetEventLatency(EventPriority priority) const { return eventLatency[static_cast<size_t>(priority)]; }
+
+	void EventManager::ResetEventLatency()
+	{
+		for (auto& histogram : eventLatency) { histogram.Reset(); }
+	}
+
+	void EventManager::AgeDeferredEvents()
+	{
+		// Critical events are never deferred
+		for (size_t priority = 1; priority < EventPriorityCount; priority++)
+		{
+			auto& queue = primaryEventQueues[priority];
+			if (queue.empty())
+			{
+				framesDeferred[priority] = 0;
+				continue;
+			}
 
-			if (event->Id.PrimaryId != UpdateAllGameObjectsEventTypeEventId.PrimaryId) { Logger::Get()->LogThis(log.str()); }
+			if (++framesDeferred[priority] < maxFramesDeferred) { continue; }
+
+			// Starved for too long: promote the waiting events one class up
+			for (; !queue.empty(); queue.pop()) { primaryEventQueues[priority - 1].push(std::move(queue.front())); }
+			framesDeferred[priority] = 0;
+		}
+	}
+
+	void EventManager::SetCoalescePolicy(const EventId& eventId, const CoalescePolicy policy, CoalesceKeyFn keyFn, CoalesceMergeFn mergeFn)
+	{
+		if (policy == CoalescePolicy::Merge && !mergeFn) { THROW(0, "Merge coalescing needs a merge function", "EventManager"); }
+
+		if (policy == CoalescePolicy::KeepAll)
+		{
+			coalescePolicies.erase(GetEventKey(eventId));
+			return;
+		}
+
+		coalescePolicies[GetEventKey(eventId)] = { policy, std::move(keyFn), std::move(mergeFn) };
+	}
+
+	unsigned long EventManager::GetCoalescedCount() const { return coalescedEvents; }
+
+	const EventManager::Coalescing* EventManager::FindCoalescing(const Event& event) const
+	{
+		static const Coalescing singleton { CoalescePolicy::KeepLatest, nullptr, nullptr };
+
+		if (!coalescePolicies.empty())
+		{
+			const auto found = coalescePolicies.find(GetEventKey(event.Id));
+			if (found != coalescePolicies.end()) { return &found->second; }
+		}
+
+		return event.IsSingleton ? &singleton : nullptr;
+	}
+
+	EventManager::CoalesceKey EventManager::GetCoalesceKey(const Event& event, const Coalescing& coalescing)
+	{
+		return { GetEventKey(event.Id), coalescing.KeyFn ? coalescing.KeyFn(event) : 0 };
+	}
+
+	void EventManager::PushPrimaryEvent(QueuedEvent queued)
+	{
+		const auto& event = queued.TheEvent;
+		queued.Priority = GetEventPriority(*event);
+		auto& primaryEventQueue = primaryEventQueues[static_cast<size_t>(queued.Priority)];
+
+		const auto coalescing = FindCoalescing(*event);
+		if (coalescing == nullptr)
+		{
+			primaryEventQueue.push(std::move(queued));
+			return;
+		}
+
+		auto& waiting = waitingCoalescedEvents[GetCoalesceKey(*event, *coalescing)];
+		if (waiting == nullptr || waiting->Processed || waiting == event)
+		{
+			waiting = event;
+			primaryEventQueue.push(std::move(queued));
+			return;
+		}
+
+		coalescedEvents++;
+		switch (coalescing->Policy)
+		{
+			case CoalescePolicy::KeepLatest:
+				// The queue skips processed events, so the superseded one is never dispatched
+				waiting->Processed = true;
+				waiting = event;
+				primaryEventQueue.push(std::move(queued));
+				break;
+			case CoalescePolicy::Merge:
+				coalescing->MergeFn(*waiting, *event);
+				break;
+			case CoalescePolicy::KeepFirst:
+			case CoalescePolicy::KeepAll:
+				break;
 		}
 	}
 
-	void EventManager::RaiseEventWithNoLogging(const std::shared_ptr<Event>& event) { primaryEventQueue.push(event); }
+	void EventManager::ForgetWaitingEvent(const std::shared_ptr<Event>& event)
+	{
+		if (waitingCoalescedEvents.empty()) { return; }
+
+		const auto coalescing = FindCoalescing(*event);
+		if (coalescing == nullptr) { return; }
+
+		// A superseded event no longer owns its key
+		const auto found = waitingCoalescedEvents.find(GetCoalesceKey(*event, *coalescing));
+		if (found != waitingCoalescedEvents.end() && found->second == event) { waitingCoalescedEvents.erase(found); }
+	}
+
+	MpscRingBufferStatistics EventManager::GetIngressStatistics() const { return ingressEventQueue.GetStatistics(); }
+
+	void EventManager::SetDispatchProfiling(const bool enabled, const size_t traceCapacity)
+	{
+		profiler = enabled ? std::make_unique<EventDispatchProfiler>(traceCapacity) : nullptr;
+	}
+
+	EventDispatchProfiler* EventManager::GetDispatchProfiler() const { return profiler.get(); }
+
+	void EventManager::SetEventJournal(std::shared_ptr<EventJournalWriter> journal) { this->journal = std::move(journal); }
+
+	unsigned long EventManager::GetFrameNumber() const { return frameNumber; }
 
 	void EventManager::LogEventSubscription(const EventId& eventId, IEventSubscriber* pYou) const
 	{
 		if (logEvents) 
 		{
 			std::stringstream message;
-			message << "EventManager: " << pYou->GetSubscriberName() << " subscribed to event " << eventId.Name;
+			message << "EventManager: " << pYou->GetSubscriberName() << " subscribed to event " << eventId.GetName();
 
 			Logger::Get()->LogThis(message.str());
 		}
 	}
 
-	void EventManager::SubscribeToEvent(const EventId& eventId, IEventSubscriber* pYou)
+	SubscriptionHandle EventManager::SubscribeToEvent(const EventId& eventId, IEventSubscriber* pYou)
+	{
+		if (!pYou) { return {}; }
+
+		LogEventSubscription(eventId, pYou);
+
+		// Prevent same subscriber adding duplicate subscriptions
+		const auto eventKey = GetEventKey(eventId);
+		const auto [found, added] = subscriptionIndexes.try_emplace({ eventKey, pYou }, 0);
+		if (!added) { return { found->second, subscriptions[found->second].Generation }; }
+
+		uint32_t index;
+		if (!freeSubscriptions.empty())
+		{
+			index = freeSubscriptions.back();
+			freeSubscriptions.pop_back();
+		}
+		else
+		{
+			index = static_cast<uint32_t>(subscriptions.size());
+			subscriptions.emplace_back();
+		}
+		found->second = index;
+
+		// Appending is safe during dispatch, which only goes as far as the subscribers there were when it started
+		auto& subscribers = eventSubscribers[eventId];
+		auto& subscription = subscriptions[index];
+		subscription.Subscriber = pYou;
+		subscription.SubscriberId = pYou->GetSubscriberId();
+		subscription.EventKey = eventKey;
+		subscription.Subscribers = &subscribers;
+		subscription.Position = subscribers.size();
+		subscribers.push_back(pYou);
+
+		auto& list = subscriptionLists[eventKey];
+		list.Subscribers = &subscribers;
+		list.Subscriptions.push_back(index);
+		subscriptionsBySubscriberId[subscription.SubscriberId].push_back(index);
+
+		IndexSubscribers(eventId, &subscribers);
+		return { index, subscription.Generation };
+	}
+
+	bool EventManager::IsSubscribed(const SubscriptionHandle handle) const
+	{
+		return handle.Index < subscriptions.size()
+			&& subscriptions[handle.Index].Generation == handle.Generation
+			&& subscriptions[handle.Index].Subscriber != nullptr;
+	}
+
+	bool EventManager::Unsubscribe(const SubscriptionHandle handle)
+	{
+		if (!IsSubscribed(handle)) { return false; }
+
+		RemoveSubscription(handle.Index);
+		return true;
+	}
+
+	void EventManager::Unsubscribe(const EventId& eventId, IEventSubscriber* pYou)
+	{
+		const auto found = subscriptionIndexes.find({ GetEventKey(eventId), pYou });
+		if (found != subscriptionIndexes.end()) { RemoveSubscription(found->second); }
+	}
+
+	void EventManager::RemoveSubscription(const uint32_t index)
 	{
-		if(pYou)
+		auto& subscription = subscriptions[index];
+
+		// Leave a gap so that positions, and any dispatch going through the list, are undisturbed
+		(*subscription.Subscribers)[subscription.Position] = nullptr;
+		subscriptionIndexes.erase({ subscription.EventKey, subscription.Subscriber });
+
+		// A subscriber has a handful of subscriptions at most
+		if (const auto byId = subscriptionsBySubscriberId.find(subscription.SubscriberId); byId != subscriptionsBySubscriberId.end())
+		{
+			std::erase(byId->second, index);
+			if (byId->second.empty()) { subscriptionsBySubscriberId.erase(byId); }
+		}
+
+		auto& list = subscriptionLists[subscription.EventKey];
+		if (!list.HasRemovals)
 		{
-			LogEventSubscription(eventId, pYou);
+			list.HasRemovals = true;
+			subscriptionListsWithRemovals.push_back(subscription.EventKey);
+		}
+
+		subscription = { nullptr, 0, 0, nullptr, 0, subscription.Generation + 1 };
+		freeSubscriptions.push_back(index);
+	}
 
-			// Prevent same subscriber adding duplicate subscriptions
+	void EventManager::CompactSubscriptions()
+	{
+		if (dispatchDepth > 0 || subscriptionListsWithRemovals.empty()) { return; }
+
+		for (const auto eventKey : subscriptionListsWithRemovals)
+		{
+			auto& list = subscriptionLists[eventKey];
+			list.HasRemovals = false;
 
-			auto& subscribers = eventSubscribers[eventId];
-			if (std::find(subscribers.begin(), subscribers.end(), pYou) != subscribers.end())
+			auto& subscribers = *list.Subscribers;
+			size_t kept = 0;
+			for (size_t i = 0; i < subscribers.size(); i++)
 			{
-				return;
-			}
+				if (subscribers[i] == nullptr) { continue; }
 
-			eventSubscribers[eventId].push_back(pYou);
+				subscribers[kept] = subscribers[i];
+				list.Subscriptions[kept] = list.Subscriptions[i];
+				subscriptions[list.Subscriptions[kept]].Position = kept;
+				kept++;
+			}
+			subscribers.resize(kept);
+			list.Subscriptions.resize(kept);
 		}
+		subscriptionListsWithRemovals.clear();
+	}
+
+	uint64_t EventManager::GetEventKey(const EventId& eventId) { return eventId.GetHandle(); }
+
+	void EventManager::IndexSubscribers(const EventId& eventId, std::vector<IEventSubscriber*>* subscribers)
+	{
+		const auto index = eventId.GetHandle();
+		if (index >= denseSubscribers.size()) { denseSubscribers.resize(index + 1, nullptr); }
+		denseSubscribers[index] = subscribers;
+	}
+
+	std::vector<IEventSubscriber*>* EventManager::FindSubscribers(const EventId& eventId) const
+	{
+		const auto index = eventId.GetHandle();
+		return index < denseSubscribers.size() ? denseSubscribers[index] : nullptr;
 	}
 
 	void EventManager::Send(const shared_ptr<Event>& event, IEventSubscriber* pSubscriber, const unsigned long deltaMs)
 	{
-		for(const auto &secondaryEvent : pSubscriber->HandleEvent(event, deltaMs))
+		const auto start = profiler ? EventDispatchProfiler::Clock::now() : EventDispatchProfiler::Clock::time_point();
+		const auto secondaryEvents = pSubscriber->HandleEvent(event, deltaMs);
+		if (profiler) { profiler->Record(event->Id, pSubscriber->GetSubscriberName(), start, EventDispatchProfiler::Clock::now(), 1, secondaryEvents.size()); }
+
+		for(const auto &secondaryEvent : secondaryEvents)
 		{
 			AddToSecondaryEventQueue(secondaryEvent, pSubscriber);
 		}
@@ -119,6 +475,63 @@ namespace gamelib
 			tap(event, pSubscriber);
 	}
 
+	void EventManager::SendBatch(const std::span<const shared_ptr<Event>> events, IEventSubscriber* pSubscriber, const unsigned long deltaMs)
+	{
+		// Take the buffer so that a dispatch made while handling the batch can't clear it under us
+		auto secondaryEvents = std::move(batchSecondaryEvents);
+		secondaryEvents.clear();
+
+		const auto start = profiler ? EventDispatchProfiler::Clock::now() : EventDispatchProfiler::Clock::time_point();
+		pSubscriber->HandleEventBatch(events, deltaMs, secondaryEvents);
+		if (profiler) { profiler->Record(events.front()->Id, pSubscriber->GetSubscriberName(), start, EventDispatchProfiler::Clock::now(), events.size(), secondaryEvents.size()); }
+
+		for (const auto& secondaryEvent : secondaryEvents)
+		{
+			AddToSecondaryEventQueue(secondaryEvent, pSubscriber);
+		}
+		secondaryEvents.clear();
+		batchSecondaryEvents = std::move(secondaryEvents);
+
+		if (tap)
+		{
+			for (const auto& event : events) { tap(event, pSubscriber); }
+		}
+	}
+
+	void EventManager::AddToEventBatch(const std::shared_ptr<Event>& event)
+	{
+		// Several batch subscribers of the event each ask for it to be added
+		auto& batch = eventBatches[GetEventKey(event->Id)];
+		if (!batch.empty() && batch.back() == event) { return; }
+
+		if (batch.empty()) { pendingEventBatches.push_back(GetEventKey(event->Id)); }
+		batch.push_back(event);
+	}
+
+	/// <summary>
+	/// Hands each batch subscriber all of this frame's events of the types it subscribes to, one call per type
+	/// </summary>
+	void EventManager::DispatchEventBatches(const unsigned long deltaMs)
+	{
+		DispatchScope dispatching(dispatchDepth);
+		for (size_t batchIndex = 0; batchIndex < pendingEventBatches.size(); batchIndex++)
+		{
+			auto& events = eventBatches[pendingEventBatches[batchIndex]];
+			const auto subscribers = FindSubscribers(events.front()->Id);
+
+			for (size_t i = 0; subscribers != nullptr; i++)
+			{
+				if (eventSubscribers.empty()) { break; } // if reset()
+				if (i >= subscribers->size()) { break; }
+
+				const auto pSubscriber = (*subscribers)[i];
+				if (pSubscriber && pSubscriber->HandlesEventBatches()) { SendBatch(events, pSubscriber, deltaMs); }
+			}
+			events.clear();
+		}
+		pendingEventBatches.clear();
+	}
+
 	void EventManager::SetEventTap(const std::function<void(const std::shared_ptr<Event>& event, const IEventSubscriber* pSubscriber)>& tapFn)
 	{
 		tap = tapFn;
@@ -132,8 +545,19 @@ namespace gamelib
 	/// <param name="deltaMs">delta time</param>
 	void EventManager::DispatchEventToSubscriber(const shared_ptr<Event>& event, const unsigned long deltaMs)
 	{
-		// Go through each subscriber of the event and have the subscriber handle it
-		for (const auto& pSubscriber :  eventSubscribers[event->Id])
+		// Called by the game rather than by ProcessAllEvents() or a subscriber
+		if (journal && dispatchDepth == 0 && !batchingEvents) { journal->Write(JournalRecordType::DispatchedDirectly, frameNumber, deltaMs, event); }
+
+		DispatchScope dispatching(dispatchDepth);
+		const auto subscribers = FindSubscribers(event->Id);
+		if (subscribers == nullptr) { noSubscribersDuringDispatch++; }
+
+		// Go through each subscriber of the event and have the subscriber handle it.
+		// Index rather than iterate, as a subscriber may subscribe others while handling the event (they get the next one)
+		int dispatched = 0;
+		const auto subscriberCount = subscribers != nullptr ? subscribers->size() : 0;
+		const auto dispatchedInParallel = subscribers != nullptr && TryDispatchInParallel(event, *subscribers, deltaMs, dispatched);
+		for (size_t i = 0; i < subscriberCount && !dispatchedInParallel; i++)
 		{
 			if (eventSubscribers.empty())
 			{
@@ -141,22 +565,24 @@ namespace gamelib
 				return;
 			}
 
-			if (!pSubscriber)
-			{
-				badSubscribersDuringDispatch++;
-				continue;
-			}					
+			if (i >= subscribers->size()) { break; }
+
+			// Unsubscribed
+			const auto pSubscriber = (*subscribers)[i];
+			if (!pSubscriber) { continue; }
 			
 			// allow subscriber to process the event
-			Send(event, pSubscriber, deltaMs);
-
-			eventsDispatched[event->Id]++;			
+			if (!pSubscriber->HandlesEventBatches()) { Send(event, pSubscriber, deltaMs); }
+			else if (batchingEvents) { AddToEventBatch(event); }
+			else { SendBatch({ &event, 1 }, pSubscriber, deltaMs); }
+			dispatched++;
 		}	
 
 		event->Processed = true;
 		
 		if(printStatistics)
 		{			
+			eventsDispatched[event->Id] += dispatched;
 			elapsedTimeMs += deltaMs;
 			dispatchCalledTimes++;
 			if(std::isgreater(elapsedTimeMs, 1000))
@@ -165,62 +591,195 @@ namespace gamelib
 				std::stringstream str;
 				for(const auto& [eventId, count] : eventsDispatched)
 				{
-					str << eventId.Name << " " << count << "/s ";
+					str << eventId.GetName() << " " << count << "/s ";
 					totalPrimaryEvents += count;
 				}
-				std::cout << totalPrimaryEvents  << " events/s over " << dispatchCalledTimes << " dispatches. " << str.str() << '\n';
+				const auto ingress = ingressEventQueue.GetStatistics();
+				std::cout << totalPrimaryEvents  << " events/s over " << dispatchCalledTimes << " dispatches. " << str.str()
+				          << "ingress dropped " << ingress.Dropped << " high-water " << ingress.HighWaterMark << '\n';
 				eventsDispatched.clear();
 				elapsedTimeMs = 0;
-				noSubscribersDuringDispatch = badSubscribersDuringDispatch = dispatchCalledTimes = 0;
+				noSubscribersDuringDispatch = dispatchCalledTimes = 0;
 			}
  		}
 	}
 
+	void EventManager::SetParallelDispatch(const bool enabled, const size_t workerThreads)
+	{
+		dispatchWorkers = enabled ? std::make_unique<ThreadPool>(workerThreads) : nullptr;
+	}
+
+	bool EventManager::IsParallelDispatch() const { return dispatchWorkers != nullptr; }
+
+	/// <summary>
+	/// Runs the AnyThread subscribers of an event on the dispatch workers while the MainThread subscribers run on this thread.
+	/// Returns false, having done nothing, if the event should rather be dispatched serially.
+	/// </summary>
+	bool EventManager::TryDispatchInParallel(const std::shared_ptr<Event>& event, const std::vector<IEventSubscriber*>& subscribers, const unsigned long deltaMs, int& dispatched)
+	{
+		// Nested dispatch (a main thread subscriber dispatching while handling) can't reuse the workers
+		if (dispatchWorkers == nullptr || dispatchingInParallel || subscribers.size() < 2) { return false; }
+
+		workerSubscriberIndexes.clear();
+		mainThreadSubscriberIndexes.clear();
+		for (size_t i = 0; i < subscribers.size(); i++)
+		{
+			if (!subscribers[i]) { continue; }
+			if (subscribers[i]->HandlesEventBatches())
+			{
+				// Only queued events are batched, so a batch subscriber can't be left out of a direct dispatch
+				if (!batchingEvents) { return false; }
+				continue;
+			}
+			auto& indexes = subscribers[i]->GetSubscriberAffinity() == SubscriberAffinity::AnyThread
+				                ? workerSubscriberIndexes
+				                : mainThreadSubscriberIndexes;
+			indexes.push_back(i);
+		}
+
+		if (workerSubscriberIndexes.empty()) { return false; }
+
+		// Work from a snapshot as subscribers may (un)subscribe while handling the event
+		parallelSubscribers.assign(subscribers.begin(), subscribers.end());
+		if (parallelResults.size() < parallelSubscribers.size()) { parallelResults.resize(parallelSubscribers.size()); }
+
+		auto handle = [&](const size_t index)
+		{
+			const auto start = profiler ? EventDispatchProfiler::Clock::now() : EventDispatchProfiler::Clock::time_point();
+			parallelResults[index] = parallelSubscribers[index]->HandleEvent(event, deltaMs);
+			if (profiler) { profiler->Record(event->Id, parallelSubscribers[index]->GetSubscriberName(), start, EventDispatchProfiler::Clock::now(), 1, parallelResults[index].size()); }
+		};
+		auto handleOnWorker = [&](const size_t item) { handle(workerSubscriberIndexes[item]); };
+		auto handleOnMainThread = [&]()
+		{
+			for (const auto index : mainThreadSubscriberIndexes) { handle(index); }
+		};
+
+		dispatchingInParallel = true;
+		try
+		{
+			dispatchWorkers->ParallelFor(workerSubscriberIndexes.size(), handleOnWorker, handleOnMainThread);
+		}
+		catch (...)
+		{
+			dispatchingInParallel = false;
+			for (auto& results : parallelResults) { results.clear(); }
+			throw;
+		}
+		dispatchingInParallel = false;
+
+		// Merge in subscription order so the secondary queue is the same as after a serial dispatch
+		for (size_t i = 0; i < parallelSubscribers.size(); i++)
+		{
+			const auto pSubscriber = parallelSubscribers[i];
+			if (!pSubscriber) { continue; }
+
+			if (pSubscriber->HandlesEventBatches())
+			{
+				AddToEventBatch(event);
+				dispatched++;
+				continue;
+			}
+
+			for (const auto& secondaryEvent : parallelResults[i])
+			{
+				AddToSecondaryEventQueue(secondaryEvent, pSubscriber);
+			}
+			parallelResults[i].clear();
+
+			if (tap)
+				tap(event, pSubscriber);
+
+			dispatched++;
+		}
+
+		return true;
+	}
+
 	void EventManager::AddToSecondaryEventQueue(const std::shared_ptr<Event>& secondaryEvent, IEventSubscriber* originSubscriber)
 	{
 		// any results from processing are put onto the secondary queue
 		secondaryEvent->Origin = originSubscriber->GetSubscriberName();
-		secondaryEventQueue.push(secondaryEvent);
+		secondaryEventQueue.push({ secondaryEvent, EventClock::now() });
 	}
 
 	void EventManager::DispatchEventToSubscriber(const shared_ptr<Event>& event, const std::string& target)
 	{
+		DispatchScope dispatching(dispatchDepth);
+		const auto subscribers = FindSubscribers(event->Id);
+
 		// Go through each subscriber of the event and have the subscriber handle it
-		for (const auto& pSubscriber :  eventSubscribers[event->Id])
+		for (size_t i = 0; subscribers != nullptr; i++)
 		{
 			if (eventSubscribers.empty()) { return; } // if reset()
+			if (i >= subscribers->size()) { break; }
+			const auto pSubscriber = (*subscribers)[i];
 			if (!pSubscriber) { continue; }
 			if (pSubscriber->GetSubscriberName() != target) { return; }
 						
 			// allow subscriber to process the event
-			Send(event, pSubscriber);
+			if (pSubscriber->HandlesEventBatches()) { SendBatch({ &event, 1 }, pSubscriber); }
+			else { Send(event, pSubscriber); }
 		}
 		event->Processed = true;
 	}
 
 	void EventManager::ProcessAllEvents(const unsigned long deltaMs)
 	{			
-		while(!primaryEventQueue.empty())
+		PROFILE_ZONE("EventManager::ProcessAllEvents");
+
+		// Whichever thread processes events is the game loop thread
+		SetGameLoopThread();
+
+		// Pick up events raised from other threads since the last frame
+		DrainIngressQueue();
+		CompactSubscriptions();
+
+		// Events raised before the frame marker are the ones this frame dispatches
+		frameNumber++;
+		if (journal) { journal->WriteFrame(frameNumber, deltaMs); }
+
+		const auto frameStart = EventClock::now();
+		batchingEvents = true;
+		while (true)
 		{
-			const auto& event = primaryEventQueue.front();
+			// Highest priority first
+			size_t priority = 0;
+			while (priority < EventPriorityCount && primaryEventQueues[priority].empty()) { priority++; }
+			if (priority == EventPriorityCount) { break; }
+
+			// Over budget: everything left is non-critical and waits for the next frame
+			const auto now = EventClock::now();
+			if (priority != static_cast<size_t>(EventPriority::Critical) && frameBudget.count() > 0 && now - frameStart >= frameBudget) { break; }
+
+			auto& queue = primaryEventQueues[priority];
+			const auto queued = std::move(queue.front());
+			queue.pop();
+
+			const auto& event = queued.TheEvent;
+			ForgetWaitingEvent(event);
 							
-			if (event->Processed)
-			{
-				primaryEventQueue.pop();
-				continue;
-			}
+			if (event->Processed) { continue; }
+
+			eventLatency[static_cast<size_t>(queued.Priority)].Record(std::chrono::duration_cast<std::chrono::microseconds>(now - queued.QueuedAt).count());
+			if (journal) { journal->Write(JournalRecordType::Dispatched, frameNumber, deltaMs, event); }
 			
 			// Ask each subscriber to deal with event			
 			DispatchEventToSubscriber(event, deltaMs);
-
-			if (!primaryEventQueue.empty()) { primaryEventQueue.pop(); }
 		}
 
+		// Events dispatched directly while handling batches go straight to their subscribers
+		batchingEvents = false;
+		DispatchEventBatches(deltaMs);
+
+		AgeDeferredEvents();
+		CompactSubscriptions();
+
 		// Process the secondary queue once primary queue is processed
 		while(!secondaryEventQueue.empty())
 		{
 			// put the secondary queue onto the back of the the primary queue for next cycle of processing
-			primaryEventQueue.push(secondaryEventQueue.front());
+			PushPrimaryEvent(std::move(secondaryEventQueue.front()));
 			secondaryEventQueue.pop();
 		}
 	}
@@ -234,49 +793,30 @@ namespace gamelib
 		return {};
 	}
 
-	bool IsSameSubscriber(IEventSubscriber* candidate, const int subscriptionId) 
-	{
-		if(candidate)
-		{
-			const auto foundMatch = candidate == nullptr 
-				                         ? true 
-				                         : candidate->GetSubscriberId() == subscriptionId;
-			return foundMatch;
-		}
-		return false;
-	};
-		
 	void EventManager::RemoveEventSubscription(const int subscriptionId, const EventId& id)
 	{
-		for(auto & [eventId, subscribers] : eventSubscribers )
-		{
-			// We only remove subscriptions for the specific event type provided
-			if(eventId != id) { continue; }
-
-			// The subscriber's id must match what we have in our subscriptions
-			auto matchFn = [&](IEventSubscriber* candidate) { return IsSameSubscriber(candidate, subscriptionId); };
+		// We only remove subscriptions for the specific event type provided
+		const auto found = subscriptionsBySubscriberId.find(subscriptionId);
+		if (found == subscriptionsBySubscriberId.end()) { return; }
 
-			// Look for the subscriber in list of subscribers for this event type
-			auto findResult = std::find_if(begin(subscribers), end(subscribers), matchFn);
-			
-			// Remove if found
-			if(findResult != std::end(subscribers)) { subscribers.erase(findResult); }
-		}		
+		const auto eventKey = GetEventKey(id);
+		for (const auto index : found->second)
+		{
+			if (subscriptions[index].EventKey == eventKey)
+			{
+				RemoveSubscription(index);
+				return;
+			}
+		}
 	}
 
 	void EventManager::Unsubscribe(const int subscriptionId)
 	{
-		for(auto & [eventId, subscribers] : eventSubscribers )
-		{
-			auto matchFn = [&](IEventSubscriber* candidate) { return IsSameSubscriber(candidate, subscriptionId); };
-
-			// Look for the subscriber in list of subscribers for this event type
-			auto findResult = std::find_if(begin(subscribers), end(subscribers), matchFn);
+		const auto found = subscriptionsBySubscriberId.find(subscriptionId);
+		if (found == subscriptionsBySubscriberId.end()) { return; }
 
-			if(findResult != std::end(subscribers))
-			{
-				subscribers.erase(findResult);
-			}
-		}
+		// Removing each subscription updates the list, so go through a copy
+		const auto indexes = found->second;
+		for (const auto index : indexes) { RemoveSubscription(index); }
 	}
 }
@@ -8,10 +8,66 @@
 #include <map>
 #include <queue>
 #include <functional>
+#include <unordered_map>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <array>
+#include <chrono>
+#include <span>
+#include <limits>
+#include "utils/MpscRingBuffer.h"
+#include "utils/Histogram.h"
+#include "EventDispatchProfiler.h"
 
 namespace gamelib
 {
 	class Event;
+	class ThreadPool;
+	class EventJournalWriter;
+
+	// How repeated raises of one event type are folded together while they wait in the primary queue
+	enum class CoalescePolicy
+	{
+		// Every raised event is dispatched
+		KeepAll,
+
+		// While an event is waiting, further raises with the same key are dropped
+		KeepFirst,
+
+		// A later raise with the same key supersedes the waiting event
+		KeepLatest,
+
+		// A later raise with the same key is merged into the waiting event and then dropped
+		Merge
+	};
+
+	// Order in which queued events are dispatched. Critical events are dispatched every frame, whatever the frame budget
+	enum class EventPriority
+	{
+		Critical,
+		High,
+		Normal,
+		Low
+	};
+
+	// Distinguishes events of one type that must not be coalesced together, e.g. by game object id
+	using CoalesceKeyFn = std::function<uint64_t(const Event& event)>;
+
+	// Folds the incoming event into the one already waiting
+	using CoalesceMergeFn = std::function<void(Event& waiting, const Event& incoming)>;
+
+	/// <summary>
+	/// Identifies one subscription made with EventManager::SubscribeToEvent().
+	/// Handles stay safe to use after the subscription is removed: the generation no longer matches and they are ignored.
+	/// </summary>
+	struct SubscriptionHandle
+	{
+		uint32_t Index = std::numeric_limits<uint32_t>::max();
+		uint32_t Generation = 0;
+
+		[[nodiscard]] bool IsValid() const { return Index != std::numeric_limits<uint32_t>::max(); }
+	};
 
 	// Raises and dispatches events to subscribers	
 	class EventManager : public EventSubscriber
@@ -24,12 +80,23 @@ namespace gamelib
 		
 		void RemoveEventSubscription(int subscriptionId, const EventId& id);
 		void Unsubscribe(int subscriptionId);
+
+		// Remove a subscription in constant time. Safe during dispatch: a subscriber removed while an event is being
+		// dispatched is not called for it. Returns false if the handle is stale
+		bool Unsubscribe(SubscriptionHandle handle);
+		void Unsubscribe(const EventId& eventId, IEventSubscriber* pYou);
+		[[nodiscard]] bool IsSubscribed(SubscriptionHandle handle) const;
 		void Reset(); // Clears subscribers, primary and secondary queues		
 		void ClearSubscribers();
+		// Events may be raised from any thread. Events raised off the game loop thread go via the ingress queue
+		// and join the primary queue at the start of the next ProcessAllEvents()
 		void RaiseEvent(const std::shared_ptr<Event>& event, IEventSubscriber* you);
+		// Makes the calling thread the game loop thread, as ProcessAllEvents() does, e.g. before a simulation thread's first frame
+		void SetGameLoopThread();
 		void RaiseEventWithNoLogging(const std::shared_ptr<Event>& event);
 		void LogEventSubscription(const EventId& eventId, IEventSubscriber* pYou) const;
-		void SubscribeToEvent(const EventId& eventId, IEventSubscriber* pYou);
+		// Subscribing again returns the existing subscription. Subscribers added during dispatch don't receive the event being dispatched
+		SubscriptionHandle SubscribeToEvent(const EventId& eventId, IEventSubscriber* pYou);
 		void DispatchEventToSubscriber(const std::shared_ptr<Event>& event, unsigned long deltaMs);
 		void DispatchEventToSubscriber(const std::shared_ptr<Event>& event, const std::string& target);
 
@@ -41,28 +108,190 @@ namespace gamelib
 		bool Initialize();
 		std::vector<std::shared_ptr<Event>> HandleEvent(const std::shared_ptr<Event>& evt, unsigned long deltaMs) override;
 		std::string GetSubscriberName() override;
-		std::map<const EventId, std::vector<IEventSubscriber*>>& GetSubscriptions();
+		// Subscriptions by event type. Add/remove subscriptions through SubscribeToEvent()/Unsubscribe() so the dispatch index stays in sync
+		// (removed subscriptions are left as null entries until the next ProcessAllEvents() or GetSubscriptions()). Read-only
+		const std::map<const EventId, std::vector<IEventSubscriber*>>& GetSubscriptions();
 		[[nodiscard]] size_t CountReady() const;
 		std::queue<std::shared_ptr<Event>> GetEvents();
 		void SetEventTap(const std::function<void(const std::shared_ptr<Event>& event, const IEventSubscriber* pSubscriber)>& tapFn);
+
+		// Opt-in: let AnyThread subscribers of an event handle it on worker threads while MainThread subscribers run here.
+		// Secondary events are merged back in subscription order, so the queues end up as they would in serial dispatch.
+		// workerThreads = 0 uses one worker per spare hardware thread.
+		void SetParallelDispatch(bool enabled, size_t workerThreads = 0);
+		[[nodiscard]] bool IsParallelDispatch() const;
+
+		// Coalesce raises of eventId while they are queued. Without a key function all events of the type share one key.
+		// Events raised with IsSingleton set and no policy of their own are treated as KeepLatest.
+		void SetCoalescePolicy(const EventId& eventId, CoalescePolicy policy, CoalesceKeyFn keyFn = nullptr, CoalesceMergeFn mergeFn = nullptr);
+
+		// Number of raised events that were dropped, superseded or merged by coalescing
+		[[nodiscard]] unsigned long GetCoalescedCount() const;
+
+		// Queued events are dispatched highest priority first. Events default to Normal
+		void SetEventPriority(const EventId& eventId, EventPriority priority);
+
+		// Limit time spent dispatching queued events per ProcessAllEvents(); zero means no limit.
+		// Events left over wait for the next frame, and a priority class left waiting for maxFramesDeferred frames
+		// in a row is promoted to the next class up so that it eventually runs
+		void SetFrameBudget(std::chrono::microseconds budget, unsigned int maxFramesDeferred = 10);
+
+		// Microseconds from an event being queued to being dispatched, by the priority it was queued with
+		[[nodiscard]] const Histogram& GetEventLatency(EventPriority priority) const;
+		void ResetEventLatency();
+
+		// Drops and high-water mark of events raised from other threads
+		[[nodiscard]] MpscRingBufferStatistics GetIngressStatistics() const;
+
+		// Time every handler call by event type and subscriber, keeping the latest traceCapacity calls as a trace.
+		// Disabling discards what was recorded
+		void SetDispatchProfiling(bool enabled, size_t traceCapacity = 65536);
+
+		// Null unless dispatch profiling is enabled
+		[[nodiscard]] EventDispatchProfiler* GetDispatchProfiler() const;
+
+		// Record raised and dispatched events, and each ProcessAllEvents(), so the session can be replayed (see EventReplay).
+		// Pass null to stop journaling
+		void SetEventJournal(std::shared_ptr<EventJournalWriter> journal);
+
+		// Number of times ProcessAllEvents() has run
+		[[nodiscard]] unsigned long GetFrameNumber() const;
 	protected:
 		static EventManager* instance;
 	private:
 		EventManager();		
 		void Send(const std::shared_ptr<Event>& event, IEventSubscriber* pSubscriber, unsigned long deltaMs = 0);		
+		void SendBatch(std::span<const std::shared_ptr<Event>> events, IEventSubscriber* pSubscriber, unsigned long deltaMs = 0);
+		void AddToEventBatch(const std::shared_ptr<Event>& event);
+		void DispatchEventBatches(unsigned long deltaMs);
+		bool TryDispatchInParallel(const std::shared_ptr<Event>& event, const std::vector<IEventSubscriber*>& subscribers, unsigned long deltaMs, int& dispatched);
 		void AddToSecondaryEventQueue(const std::shared_ptr<Event>& secondaryEvent, IEventSubscriber* originSubscriber);
 		void LogEventRaised(IEventSubscriber* you, const std::shared_ptr<Event>& event) const;
-		std::queue<std::shared_ptr<Event>> primaryEventQueue; // Primary queue used for event processing 		
-		std::queue<std::shared_ptr<Event>> secondaryEventQueue; // used to hold events occurring out of processing of primary events
+		using EventClock = std::chrono::steady_clock;
+		static constexpr size_t EventPriorityCount = 4;
+
+		// An event waiting in one of the queues
+		struct QueuedEvent
+		{
+			std::shared_ptr<Event> TheEvent;
+			EventClock::time_point QueuedAt;
+			EventPriority Priority = EventPriority::Normal;
+		};
+
+		void Enqueue(const std::shared_ptr<Event>& event);
+		void PushPrimaryEvent(QueuedEvent queued);
+		[[nodiscard]] EventPriority GetEventPriority(const Event& event) const;
+		void AgeDeferredEvents();
+		void ForgetWaitingEvent(const std::shared_ptr<Event>& event);
+		void DrainIngressQueue();
+		[[nodiscard]] std::vector<IEventSubscriber*>* FindSubscribers(const EventId& eventId) const;
+		void IndexSubscribers(const EventId& eventId, std::vector<IEventSubscriber*>* subscribers);
+		static uint64_t GetEventKey(const EventId& eventId);
+		void RemoveSubscription(uint32_t index);
+		void CompactSubscriptions();
+		std::array<std::queue<QueuedEvent>, EventPriorityCount> primaryEventQueues; // Primary queues used for event processing, one per priority
+		std::queue<QueuedEvent> secondaryEventQueue; // used to hold events occurring out of processing of primary events
+		MpscRingBuffer<QueuedEvent> ingressEventQueue {IngressQueueCapacity}; // events raised from threads other than the game loop
+		std::atomic<std::thread::id> gameLoopThreadId; // the thread that processes events
+		static constexpr size_t IngressQueueCapacity = 4096;
+
+		// Coalescing: policies by event key, and the event currently waiting in the primary queue for each coalescing key
+		struct Coalescing
+		{
+			CoalescePolicy Policy;
+			CoalesceKeyFn KeyFn;
+			CoalesceMergeFn MergeFn;
+		};
+		struct CoalesceKey
+		{
+			uint64_t EventKey;
+			uint64_t Key;
+			bool operator==(const CoalesceKey& other) const { return EventKey == other.EventKey && Key == other.Key; }
+		};
+		struct CoalesceKeyHash
+		{
+			size_t operator()(const CoalesceKey& key) const { return std::hash<uint64_t>()(key.EventKey * 31 + key.Key); }
+		};
+		[[nodiscard]] const Coalescing* FindCoalescing(const Event& event) const;
+		static CoalesceKey GetCoalesceKey(const Event& event, const Coalescing& coalescing);
+		std::unordered_map<uint64_t, Coalescing> coalescePolicies;
+		std::unordered_map<CoalesceKey, std::shared_ptr<Event>, CoalesceKeyHash> waitingCoalescedEvents;
+		unsigned long coalescedEvents {};
+
+		// Priorities and frame budget
+		std::unordered_map<uint64_t, EventPriority> eventPriorities;
+		std::chrono::microseconds frameBudget {0};
+		unsigned int maxFramesDeferred = 10;
+		std::array<unsigned int, EventPriorityCount> framesDeferred {};
+		std::array<Histogram, EventPriorityCount> eventLatency;
 		std::map<const EventId, std::vector<IEventSubscriber*>> eventSubscribers;
+
+		// Dispatch index into eventSubscribers by EventId handle (map nodes are stable so we can point at their subscriber lists)
+		std::vector<std::vector<IEventSubscriber*>*> denseSubscribers;
+
+		// Where each subscription lives. A removed subscription leaves a null entry in its subscriber list (so removal is
+		// constant time and dispatch in progress can carry on), and the lists are compacted when nothing is being dispatched
+		struct Subscription
+		{
+			IEventSubscriber* Subscriber = nullptr;
+			int SubscriberId = 0;
+			uint64_t EventKey = 0;
+			std::vector<IEventSubscriber*>* Subscribers = nullptr;
+			size_t Position = 0;
+			uint32_t Generation = 0;
+		};
+		struct SubscriptionKey
+		{
+			uint64_t EventKey;
+			const IEventSubscriber* Subscriber;
+			bool operator==(const SubscriptionKey& other) const { return EventKey == other.EventKey && Subscriber == other.Subscriber; }
+		};
+		struct SubscriptionKeyHash
+		{
+			size_t operator()(const SubscriptionKey& key) const { return std::hash<uint64_t>()(key.EventKey) ^ std::hash<const void*>()(key.Subscriber) << 1; }
+		};
+		// Subscription indexes in step with an event's subscriber list
+		struct SubscriptionList
+		{
+			std::vector<IEventSubscriber*>* Subscribers = nullptr;
+			std::vector<uint32_t> Subscriptions;
+			bool HasRemovals = false;
+		};
+		std::vector<Subscription> subscriptions;
+		std::vector<uint32_t> freeSubscriptions;
+		std::unordered_map<SubscriptionKey, uint32_t, SubscriptionKeyHash> subscriptionIndexes;
+		// Subscriptions by the subscriber id they were made with, for removal by id
+		std::unordered_map<int, std::vector<uint32_t>> subscriptionsBySubscriberId;
+		std::unordered_map<uint64_t, SubscriptionList> subscriptionLists;
+		std::vector<uint64_t> subscriptionListsWithRemovals;
+		int dispatchDepth = 0;
+
 		std::map<EventId, int> eventsDispatched {};
-		int badSubscribersDuringDispatch {};
 		int noSubscribersDuringDispatch {};
 		int dispatchCalledTimes {};
 		unsigned long elapsedTimeMs {};
 		bool logEvents;
 		bool printStatistics;
 		std::function<void(const std::shared_ptr<Event>& event, IEventSubscriber* pSubscriber)> tap = nullptr;
+
+		// Parallel dispatch state, reused between events to avoid allocating
+		std::unique_ptr<ThreadPool> dispatchWorkers;
+		bool dispatchingInParallel = false;
+		std::vector<IEventSubscriber*> parallelSubscribers;
+		std::vector<size_t> workerSubscriberIndexes;
+		std::vector<size_t> mainThreadSubscriberIndexes;
+		std::vector<std::vector<std::shared_ptr<Event>>> parallelResults;
+
+		// Batched dispatch: while ProcessAllEvents() runs, events for batch subscribers are collected by event key
+		// and delivered per type at the end of the primary queue. Buffers are kept between frames
+		bool batchingEvents = false;
+		std::unordered_map<uint64_t, std::vector<std::shared_ptr<Event>>> eventBatches;
+		std::vector<uint64_t> pendingEventBatches; // keys in order of each type's first event this frame
+		std::vector<std::shared_ptr<Event>> batchSecondaryEvents;
+
+		std::unique_ptr<EventDispatchProfiler> profiler;
+		std::shared_ptr<EventJournalWriter> journal;
+		unsigned long frameNumber = 0;
 	};
 }
 
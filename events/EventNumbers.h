@@ -31,7 +31,8 @@ namespace gamelib
 		ReliableUdpCheckSumFailed,
 		ReliableUdpPacketLossDetected,
 		ReliableUdpAckPacket,
-		ReliableUdpPacketRttCalculated
+		ReliableUdpPacketRttCalculated,
+		SceneAssetsReady
 	};
 }
 
@@ -0,0 +1,169 @@
+#pragma once
+#ifndef EVENTPOOL_H
+#define EVENTPOOL_H
+
+#include <memory>
+#include <mutex>
+#include <new>
+#include <cstddef>
+#include <vector>
+
+namespace gamelib
+{
+	// Counters used to size event pools in production
+	struct EventPoolStatistics
+	{
+		// Allocations served from a recycled block
+		unsigned long Hits {};
+
+		// Allocations that had to go to the heap
+		unsigned long Misses {};
+
+		// Blocks currently waiting to be reused
+		size_t FreeBlocks {};
+	};
+
+	/// <summary>
+	/// Free list of equally sized memory blocks.
+	/// The block size is fixed by the first allocation, which for a pooled event type is always the same size.
+	/// </summary>
+	class EventBlockPool
+	{
+	public:
+		EventBlockPool() = default;
+		EventBlockPool(const EventBlockPool& other) = delete;
+		EventBlockPool& operator=(const EventBlockPool& other) = delete;
+
+		~EventBlockPool()
+		{
+			while (freeList != nullptr)
+			{
+				const auto next = freeList->Next;
+				::operator delete(freeList);
+				freeList = next;
+			}
+		}
+
+		void* Allocate(const size_t size)
+		{
+			std::lock_guard lock(mutex);
+
+			if (blockSize == 0) { blockSize = size < sizeof(FreeBlock) ? sizeof(FreeBlock) : size; }
+
+			if (size <= blockSize && freeList != nullptr)
+			{
+				const auto block = freeList;
+				freeList = block->Next;
+				statistics.FreeBlocks--;
+				statistics.Hits++;
+				return block;
+			}
+
+			statistics.Misses++;
+			return ::operator new(size <= blockSize ? blockSize : size);
+		}
+
+		void Release(void* block, const size_t size)
+		{
+			std::lock_guard lock(mutex);
+
+			if (size > blockSize)
+			{
+				// Not one of ours to keep
+				::operator delete(block);
+				return;
+			}
+
+			freeList = new (block) FreeBlock { freeList };
+			statistics.FreeBlocks++;
+		}
+
+		[[nodiscard]] EventPoolStatistics GetStatistics()
+		{
+			std::lock_guard lock(mutex);
+			return statistics;
+		}
+
+		void ResetStatistics()
+		{
+			std::lock_guard lock(mutex);
+			statistics.Hits = statistics.Misses = 0;
+		}
+
+	private:
+		// Released blocks are linked through their own storage so recycling never allocates
+		struct FreeBlock { FreeBlock* Next; };
+
+		FreeBlock* freeList = nullptr;
+		size_t blockSize = 0;
+		EventPoolStatistics statistics;
+		std::mutex mutex;
+	};
+
+	// Allocator handed to std::allocate_shared so the event and its reference count share one pooled block
+	template <typename T>
+	class EventPoolAllocator
+	{
+	public:
+		using value_type = T;
+
+		explicit EventPoolAllocator(EventBlockPool* blocks) : blocks(blocks) {}
+
+		template <typename U>
+		EventPoolAllocator(const EventPoolAllocator<U>& other) : blocks(other.blocks) {}
+
+		T* allocate(const size_t count) { return static_cast<T*>(blocks->Allocate(count * sizeof(T))); }
+		void deallocate(T* pointer, const size_t count) { blocks->Release(pointer, count * sizeof(T)); }
+
+		template <typename U>
+		bool operator==(const EventPoolAllocator<U>& other) const { return blocks == other.blocks; }
+
+		template <typename U>
+		bool operator!=(const EventPoolAllocator<U>& other) const { return blocks != other.blocks; }
+
+		EventBlockPool* blocks;
+	};
+
+	/// <summary>
+	/// Recycles the memory of events of type T so that steady-state event creation does not touch the heap.
+	/// Pooled events are ordinary std::shared_ptr so they can be raised, queued and handled like any other event.
+	/// </summary>
+	template <typename T>
+	class EventPool
+	{
+	public:
+		static EventPool* Get()
+		{
+			// Never destroyed: pooled events may outlive static destruction
+			static auto* instance = new EventPool();
+			return instance;
+		}
+
+		EventPool(const EventPool& other) = delete;
+		EventPool& operator=(const EventPool& other) = delete;
+
+		template <typename... Args>
+		std::shared_ptr<T> Create(Args&&... args)
+		{
+			return std::allocate_shared<T>(EventPoolAllocator<T>(&blocks), std::forward<Args>(args)...);
+		}
+
+		// Pre-allocate blocks for count events so that the first frames don't miss
+		template <typename... Args>
+		void Reserve(const size_t count, const Args&... args)
+		{
+			std::vector<std::shared_ptr<T>> warmUp;
+			warmUp.reserve(count);
+			for (size_t i = 0; i < count; i++) { warmUp.push_back(Create(args...)); }
+		}
+
+		[[nodiscard]] EventPoolStatistics GetStatistics() { return blocks.GetStatistics(); }
+		void ResetStatistics() { blocks.ResetStatistics(); }
+
+	private:
+		EventPool() = default;
+		EventBlockPool blocks;
+	};
+}
+
+#endif
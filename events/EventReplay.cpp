@@ -0,0 +1,88 @@
+#include "EventReplay.h"
+#include "Event.h"
+#include "EventJournal.h"
+#include "EventManager.h"
+#include "file/SerializationManager.h"
+#include "file/Logger.h"
+#include <stdexcept>
+
+namespace gamelib
+{
+	EventReplay::EventReplay(std::shared_ptr<SerializationManager> serializationManager, std::shared_ptr<EventJournalCodecs> codecs)
+		: serializationManager(std::move(serializationManager)), codecs(codecs ? std::move(codecs) : std::make_shared<EventJournalCodecs>()) {}
+
+	EventReplayResult EventReplay::Run(const std::string& journalFileName, EventManager& eventManager) const
+	{
+		EventJournalReader reader(journalFileName);
+		EventReplayResult result;
+		EventJournalRecord record;
+
+		const auto start = std::chrono::steady_clock::now();
+		while (reader.ReadNext(record))
+		{
+			switch (record.Type)
+			{
+				case JournalRecordType::Raised:
+				case JournalRecordType::DispatchedDirectly:
+				{
+					const auto event = RecreateEvent(record);
+					if (!event)
+					{
+						if (result.EventsSkipped++ == 0) { Logger::Get()->LogThis("EventReplay: skipping events that can't be rebuilt, starting with " + record.Name); }
+						break;
+					}
+
+					if (record.Type == JournalRecordType::Raised)
+					{
+						eventManager.RaiseEventWithNoLogging(event);
+						result.EventsRaised++;
+					}
+					else
+					{
+						eventManager.DispatchEventToSubscriber(event, record.DeltaMs);
+						result.EventsDispatchedDirectly++;
+					}
+					break;
+				}
+				case JournalRecordType::Frame:
+					eventManager.ProcessAllEvents(record.DeltaMs);
+					result.Frames++;
+					break;
+				case JournalRecordType::RaisedWhileDispatching:
+				case JournalRecordType::Dispatched:
+					// Happen again by themselves
+					break;
+			}
+		}
+		result.Elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+		return result;
+	}
+
+	std::shared_ptr<Event> EventReplay::RecreateEvent(const EventJournalRecord& record) const
+	{
+		std::shared_ptr<Event> event;
+		try
+		{
+			switch (record.PayloadType)
+			{
+				case JournalPayloadType::Plain:
+					event = std::make_shared<Event>(EventId(record.PrimaryId, record.Name, record.SecondaryId));
+					break;
+				case JournalPayloadType::Codec:
+					event = codecs->Decode(record.PrimaryId, record.Payload);
+					break;
+				case JournalPayloadType::Serialized:
+					// Message headers can only be read from some encodings
+					if (serializationManager) { event = serializationManager->Deserialize(SerializationManager::GetMessageHeader(record.Payload), record.Payload); }
+					break;
+				case JournalPayloadType::None:
+					break;
+			}
+		}
+		catch (const std::exception&) { event = nullptr; }
+
+		if (event) { event->Origin = record.Origin; }
+		return event;
+	}
+}
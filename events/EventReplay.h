@@ -0,0 +1,52 @@
+#pragma once
+#ifndef EVENTREPLAY_H
+#define EVENTREPLAY_H
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace gamelib
+{
+	class Event;
+	class EventJournalCodecs;
+	class EventManager;
+	class SerializationManager;
+	struct EventJournalRecord;
+
+	struct EventReplayResult
+	{
+		unsigned long Frames {};
+		unsigned long EventsRaised {};
+		unsigned long EventsDispatchedDirectly {};
+
+		// Raised or dispatched events that could not be rebuilt, see EventReplay::RecreateEvent()
+		unsigned long EventsSkipped {};
+		std::chrono::nanoseconds Elapsed {};
+	};
+
+	/// <summary>
+	/// Feeds a journal written by EventJournalWriter back through an event manager at full speed, without a window or
+	/// renderer: external events are raised, direct dispatches repeated and ProcessAllEvents() called once per recorded frame
+	/// with the recorded deltaMs. Subscribers should be set up as they were in the recorded session.
+	/// Events that can't be rebuilt, having no payload or one that no longer reads, are skipped rather than replayed
+	/// as something their subscribers don't expect.
+	/// </summary>
+	class EventReplay
+	{
+	public:
+		// Use the same codecs and serialization as the journal was written with
+		explicit EventReplay(std::shared_ptr<SerializationManager> serializationManager = nullptr, std::shared_ptr<EventJournalCodecs> codecs = nullptr);
+
+		EventReplayResult Run(const std::string& journalFileName, EventManager& eventManager) const;
+
+		// Null when the event can't be rebuilt
+		[[nodiscard]] std::shared_ptr<Event> RecreateEvent(const EventJournalRecord& record) const;
+
+	private:
+		std::shared_ptr<SerializationManager> serializationManager;
+		std::shared_ptr<EventJournalCodecs> codecs;
+	};
+}
+
+#endif
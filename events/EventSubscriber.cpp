@@ -21,7 +21,7 @@ void gamelib::EventSubscriber::SubscribeToEvent(const EventId& eventId)
 
 void gamelib::EventSubscriber::UnsubscribeSubscribeToEvent(const EventId& eventId)
 {		
-	EventManager::Get()->Unsubscribe(eventId.PrimaryId);
+	EventManager::Get()->Unsubscribe(eventId, this);
 	EventSubscriptions.remove(eventId);
 }
 
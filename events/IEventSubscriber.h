@@ -2,12 +2,25 @@
 #ifndef IEVENTSUBSCRIBER_H
 #define IEVENTSUBSCRIBER_H
 #include <memory>
+#include <span>
 #include <vector>
 #include <string>
 #include "Event.h"
 
 namespace gamelib
 {
+	/// <summary>
+	/// Where a subscriber's HandleEvent may run when the event manager dispatches in parallel
+	/// </summary>
+	enum class SubscriberAffinity
+	{
+		// Always handled on the thread processing events (the game loop)
+		MainThread,
+
+		// Safe to handle on an event dispatch worker thread
+		AnyThread
+	};
+
 	/// <summary>
 	/// Objects that can subscribe and raise events but implement this interface
 	/// </summary>
@@ -35,6 +48,32 @@ namespace gamelib
 		/// <param name="deltaMs"></param>
 		/// <returns>List of generated events while handling current event</returns>
 		virtual std::vector<std::shared_ptr<Event>> HandleEvent(const std::shared_ptr<Event>& evt, unsigned long deltaMs) = 0;
+
+		/// <summary>
+		/// Subscribers are pinned to the main thread unless they declare otherwise.
+		/// AnyThread subscribers should return secondary events rather than raising them while handling an event.
+		/// </summary>
+		virtual SubscriberAffinity GetSubscriberAffinity() { return SubscriberAffinity::MainThread; }
+
+		/// <summary>
+		/// Subscribers that return true receive queued events through HandleEventBatch() instead of HandleEvent():
+		/// once per event type per ProcessAllEvents(), after the primary queue has been dispatched to everyone else.
+		/// </summary>
+		virtual bool HandlesEventBatches() { return false; }
+
+		/// <summary>
+		/// Handle every queued event of one type at once
+		/// </summary>
+		/// <param name="events">This frame's events of one EventId, in the order they were dispatched</param>
+		/// <param name="deltaMs"></param>
+		/// <param name="secondaryEvents">Append events generated while handling. Owned and cleared by the event manager</param>
+		virtual void HandleEventBatch(const std::span<const std::shared_ptr<Event>> events, const unsigned long deltaMs, std::vector<std::shared_ptr<Event>>& secondaryEvents)
+		{
+			for (const auto& event : events)
+			{
+				for (auto& secondaryEvent : HandleEvent(event, deltaMs)) { secondaryEvents.push_back(std::move(secondaryEvent)); }
+			}
+		}
 	};
 }
 
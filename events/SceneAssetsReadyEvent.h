@@ -0,0 +1,25 @@
+#pragma once
+#ifndef SCENEASSETSREADYEVENT_H
+#define SCENEASSETSREADYEVENT_H
+
+#include "Event.h"
+#include "EventNumbers.h"
+
+namespace gamelib
+{
+	const static EventId SceneAssetsReadyEventId(SceneAssetsReady, "SceneAssetsReady");
+
+	// Raised once the assets of a scene loaded in the background have all loaded or failed to
+	class SceneAssetsReadyEvent final : public Event
+	{
+	public:
+		SceneAssetsReadyEvent(const int sceneId, const unsigned int failedAssets) : Event(SceneAssetsReadyEventId), SceneId(sceneId), FailedAssets(failedAssets)
+		{
+		}
+
+		int SceneId;
+		unsigned int FailedAssets;
+	};
+}
+
+#endif
@@ -67,14 +67,21 @@ namespace gamelib
 	{
 		// TODO: Update the list of events that can be sent over the network
 
-		if(evt->Id.PrimaryId == PlayerMovedEventTypeEventId.PrimaryId) { return CreatePlayerMovedEventMessage(evt, target);}
-		if(evt->Id.PrimaryId == ControllerMoveEventId.PrimaryId) { return CreateControllerMoveEventMessage(evt, target);}
-		if(evt->Id.PrimaryId == StartNetworkLevelEventId.PrimaryId) { return CreateStartNetworkLevelMessage(evt, target);}
+		if(evt->Id.GetPrimaryId() == PlayerMovedEventTypeEventId.GetPrimaryId()) { return CreatePlayerMovedEventMessage(evt, target);}
+		if(evt->Id.GetPrimaryId() == ControllerMoveEventId.GetPrimaryId()) { return CreateControllerMoveEventMessage(evt, target);}
+		if(evt->Id.GetPrimaryId() == StartNetworkLevelEventId.GetPrimaryId()) { return CreateStartNetworkLevelMessage(evt, target);}
 
 		return CreateUnknownEventMessage(evt, target);
 		
 	}
 
+	bool SerializationManager::CanSerialize(const EventId& eventId)
+	{
+		return eventId.GetPrimaryId() == PlayerMovedEventTypeEventId.GetPrimaryId()
+			|| eventId.GetPrimaryId() == ControllerMoveEventId.GetPrimaryId()
+			|| eventId.GetPrimaryId() == StartNetworkLevelEventId.GetPrimaryId();
+	}
+
 	std::shared_ptr<Event> SerializationManager::Deserialize(const MessageHeader& messageHeader, const std::string&
 	                                                         serializedMessage) const
 	{
@@ -82,12 +89,12 @@ namespace gamelib
 
 		// TODO: Update the list of messages (serialised events) that we can be consumed by the network clients, i.e., deserialized
 		
-		if(messageHeader.TheMessageType == StartNetworkLevelEventId.Name)
+		if(messageHeader.TheMessageType == StartNetworkLevelEventId.GetName())
 		{
 			return To<Event>(eventSerialization->DeserializeStartNetworkLevel(serializedMessage));
 		}
 
-		if(messageHeader.TheMessageType == PlayerMovedEventTypeEventId.Name)
+		if(messageHeader.TheMessageType == PlayerMovedEventTypeEventId.GetName())
 		{
 			return To<Event>(eventSerialization->DeserializePlayerMovedEvent(serializedMessage));
 		}
@@ -7,6 +7,7 @@
 namespace gamelib
 {
 	class Event;
+	class EventId;
 	class IEventSerializationManager;
 
 	enum class Encoding : uint8_t
@@ -35,6 +36,9 @@ namespace gamelib
 		[[nodiscard]] static MessageHeader GetMessageHeader(const std::string& serializedMessage);
 		[[nodiscard]] std::shared_ptr<Event> Deserialize(const MessageHeader& messageHeader, const std::string& serializedMessage) const;
 		[[nodiscard]] std::string SerializeEvent(const std::shared_ptr<Event>& evt, const std::string& target) const;
+
+		// Whether SerializeEvent() writes the event's contents rather than an "unknown" message
+		[[nodiscard]] static bool CanSerialize(const EventId& eventId);
 		[[nodiscard]] std::string CreateUnknownEventMessage(const std::shared_ptr<Event>& evt, const std::string& target) const;
 		[[nodiscard]] std::string CreateRequestPlayerDetailsMessage() const;
 		[[nodiscard]] std::string CreateRequestPlayerDetailsMessageResponse(const std::string& target) const;
@@ -17,13 +17,17 @@ namespace gamelib
 	
 	void FontAsset::Load()
 	{
-		font =  TTF_OpenFont(FilePath.c_str(), 28);
+		font = PackedData.empty()
+			? TTF_OpenFont(FilePath.c_str(), 28)
+			: TTF_OpenFontRW(SDL_RWFromConstMem(PackedData.data(), static_cast<int>(PackedData.size())), 1, 28);
+		IsLoadedInMemory = font != nullptr;
 	}
 	
 	bool FontAsset::Unload()
 	{
 		TTF_CloseFont(font);
 	    font = nullptr;
+		IsLoadedInMemory = false;
 		return true;
 	}
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "DrawableText.h"
 
 #include "graphic/RectDebugging.h"
+#include "graphic/RenderPacket.h"
 
 gamelib::DrawableText::DrawableText(const SDL_Rect bounds, std::string text, const SDL_Color color = {0,0,0, 0})
 	: DrawBounds(bounds), Text(std::move(text)), Color(color)
@@ -21,3 +22,15 @@ void gamelib::DrawableText::Draw(SDL_Renderer* renderer)
 {
 	RectDebugging::PrintInRect(renderer, Text, &DrawBounds, Color);	
 }
+
+bool gamelib::DrawableText::AddRenderItems(std::vector<RenderItem>& items) const
+{
+	RenderItem item;
+	item.GameObjectId = Id;
+	item.Command = [text = Text, bounds = DrawBounds, color = Color](SDL_Renderer* renderer)
+	{
+		RectDebugging::PrintInRect(renderer, text, &bounds, color);
+	};
+	items.push_back(item);
+	return true;
+}
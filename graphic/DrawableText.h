@@ -25,6 +25,9 @@ namespace gamelib
 		/// <param name="renderer"></param>
 		void Draw(SDL_Renderer* renderer) override;
 
+		// Draws a copy of the text as it is now
+		bool AddRenderItems(std::vector<RenderItem>& items) const override;
+
 		/// <summary>
 		/// Every game Object needs to identify what type of game object it is
 		/// </summary>
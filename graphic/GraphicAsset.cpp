@@ -21,32 +21,54 @@ namespace gamelib
 	// Load into memory
 	void GraphicAsset::Load()
 	{
-		Unload();
-			  
+		Decode();
+		Upload();
+	}
+
+	void GraphicAsset::Decode()
+	{
+		SDL_FreeSurface(decodedSurface);
+		decodeError.clear();
+
 		// Load image at specified path
+		decodedSurface = PackedData.empty()
+			? IMG_Load(FilePath.c_str())
+			: IMG_Load_RW(SDL_RWFromConstMem(PackedData.data(), static_cast<int>(PackedData.size())), 1);
+		if (!decodedSurface)
+		{
+			// Logged by Upload(), on the game loop thread
+			decodeError = IMG_GetError();
+			return;
+		}
 
-		if(const auto loadedSurface = IMG_Load(FilePath.c_str()))
-		{				
-			if (HasColourKey())
-			{
-				SDL_SetColorKey(loadedSurface, SDL_TRUE, SDL_MapRGB(loadedSurface->format, static_cast<Uint8>(colourKey.Red), static_cast<Uint8>(colourKey.Green), static_cast<Uint8>(colourKey.Blue)));
-			}
-
-			// Create texture from surface pixels
-			texture = SDL_CreateTextureFromSurface(SdlGraphicsManager::Get()->GetMainWindow()->GetRenderer(), loadedSurface);
-						
-			// Get rid of old loaded surface (we have the texture pixels)
-			SDL_FreeSurface(loadedSurface);
-			
-			// Mark the asset as having been loaded
-			if (texture)
-			{
-				IsLoadedInMemory = true;
-			}
+		if (HasColourKey())
+		{
+			SDL_SetColorKey(decodedSurface, SDL_TRUE, SDL_MapRGB(decodedSurface->format, static_cast<Uint8>(colourKey.Red), static_cast<Uint8>(colourKey.Green), static_cast<Uint8>(colourKey.Blue)));
+		}
+	}
+
+	void GraphicAsset::Upload()
+	{
+		Unload();
+
+		if (!decodedSurface)
+		{
+			Logger::Get()->LogThis(std::string("Unable to load image:") + FilePath + std::string(" Error:") + decodeError);
+			return;
 		}
-		else
+
+		// Create texture from surface pixels
+		texture = SDL_CreateTextureFromSurface(SdlGraphicsManager::Get()->GetMainWindow()->GetRenderer(), decodedSurface);
+		textureBytes = static_cast<size_t>(decodedSurface->pitch) * static_cast<size_t>(decodedSurface->h);
+
+		// Get rid of old loaded surface (we have the texture pixels)
+		SDL_FreeSurface(decodedSurface);
+		decodedSurface = nullptr;
+
+		// Mark the asset as having been loaded
+		if (texture)
 		{
-			Logger::Get()->LogThis(std::string("Unable to load image:") + FilePath + std::string(" Error:") + IMG_GetError());
+			IsLoadedInMemory = true;
 		}
 	}
 
@@ -59,8 +81,8 @@ namespace gamelib
 		bool isSuccess;
 		try
 		{
-			// Free texture in memory
-			SDL_DestroyTexture(texture);
+			// Free texture in memory, once nothing waiting to be drawn uses it
+			if (texture) { SdlGraphicsManager::Get()->DestroyTexture(texture); }
 
 			// make it clear that these are not used now
 			texture = nullptr;
@@ -91,6 +113,11 @@ namespace gamelib
 		return texture;
 	}
 
+	size_t GraphicAsset::GetSizeBytes() const
+	{
+		return texture ? textureBytes : 0;
+	}
+
 	void GraphicAsset::SetColourKey(int red, int green, int blue)
 	{
 		colourKey = { red, green, blue };
@@ -114,5 +141,6 @@ namespace gamelib
 		Logger::Get()->LogThis(string("GraphicAsset: Unloading asset: " + this->FilePath));
 
 		GraphicAsset::Unload();
+		SDL_FreeSurface(decodedSurface);
 	}
 }
\ No newline at end of file
@@ -29,6 +29,16 @@ namespace gamelib
 		/// </summary>
 		void Load() override;
 
+		/// <summary>
+		/// Read and decode the image into a surface, on any thread
+		/// </summary>
+		void Decode() override;
+
+		/// <summary>
+		/// Create the texture from the decoded surface. Needs the renderer's thread
+		/// </summary>
+		void Upload() override;
+
 		/// <summary>
 		/// a Resource can unload itself from memory
 		/// </summary>
@@ -46,6 +56,11 @@ namespace gamelib
 		/// </summary>
 		/// <returns></returns>
 		[[nodiscard]] SDL_Texture* GetTexture() const;
+
+		/// <summary>
+		/// Size of the decoded image the texture was made from
+		/// </summary>
+		[[nodiscard]] size_t GetSizeBytes() const override;
 				
 		AbcdRectangle Dimensions;
 
@@ -65,6 +80,13 @@ namespace gamelib
 		/// The binary data that will represent the resource once its loaded.
 		/// </summary>
 		SDL_Texture* texture = nullptr;
+		size_t textureBytes = 0;
+
+		/// <summary>
+		/// Decoded image waiting for Upload(), or why it couldn't be decoded
+		/// </summary>
+		SDL_Surface* decodedSurface = nullptr;
+		std::string decodeError;
 
 		/// <summary>
 		/// Observable area of the graphic
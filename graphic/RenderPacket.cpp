@@ -0,0 +1,159 @@
+#include "RenderPacket.h"
+#include <algorithm>
+#include <iterator>
+#include "exceptions/EngineException.h"
+
+namespace gamelib
+{
+	void RenderPacket::Draw(SDL_Renderer* renderer) const
+	{
+		for (const auto& item : Items)
+		{
+			if (!item.IsVisible) { continue; }
+
+			if (item.Command) { item.Command(renderer); }
+			else if (item.Texture != nullptr) { SDL_RenderCopy(renderer, item.Texture, &item.Source, &item.Destination); }
+		}
+	}
+
+	RenderPacketBuffer::RenderPacketBuffer(const size_t packetCount) : packets(packetCount)
+	{
+		if (packetCount < 2) { THROW(0, "A render packet buffer needs at least 2 packets", "RenderPacketBuffer"); }
+	}
+
+	RenderPacket* RenderPacketBuffer::BeginWrite()
+	{
+		std::unique_lock lock(mutex);
+		changed.wait(lock, [this] { return closed || filled < packets.size(); });
+
+		return closed ? nullptr : &packets[writeIndex];
+	}
+
+	void RenderPacketBuffer::EndWrite()
+	{
+		{
+			std::lock_guard lock(mutex);
+			writeIndex = (writeIndex + 1) % packets.size();
+			filled++;
+			ready++;
+		}
+		changed.notify_all();
+	}
+
+	const RenderPacket* RenderPacketBuffer::BeginRead(const bool wait)
+	{
+		std::unique_lock lock(mutex);
+		if (wait) { changed.wait(lock, [this] { return closed || ready > 0; }); }
+		if (ready == 0) { return nullptr; }
+
+		ready--;
+		return &packets[readIndex];
+	}
+
+	const RenderPacket* RenderPacketBuffer::BeginReadFor(const std::chrono::microseconds timeout)
+	{
+		std::unique_lock lock(mutex);
+		changed.wait_for(lock, timeout, [this] { return closed || ready > 0; });
+		if (ready == 0) { return nullptr; }
+
+		ready--;
+		return &packets[readIndex];
+	}
+
+	void RenderPacketBuffer::EndRead()
+	{
+		{
+			std::lock_guard lock(mutex);
+			readIndex = (readIndex + 1) % packets.size();
+			filled--;
+		}
+		changed.notify_all();
+	}
+
+	void RenderPacketBuffer::Close()
+	{
+		{
+			std::lock_guard lock(mutex);
+			closed = true;
+		}
+		changed.notify_all();
+	}
+
+	void RenderPacketBuffer::Reset()
+	{
+		std::lock_guard lock(mutex);
+		writeIndex = readIndex = ready = filled = 0;
+		closed = false;
+	}
+
+	size_t RenderPacketBuffer::GetReadyCount() const
+	{
+		std::lock_guard lock(mutex);
+		return ready;
+	}
+
+	bool RenderPacketBuffer::IsClosed() const
+	{
+		std::lock_guard lock(mutex);
+		return closed;
+	}
+
+	void RenderRetireQueue::SetDeferring(const bool isDeferring)
+	{
+		std::vector<Retired> releasing;
+		{
+			std::lock_guard lock(mutex);
+			deferring = isDeferring;
+			if (!deferring) { releasing.swap(retired); }
+		}
+
+		for (const auto& item : releasing) { item.Release(); }
+	}
+
+	bool RenderRetireQueue::IsDeferring() const
+	{
+		std::lock_guard lock(mutex);
+		return deferring;
+	}
+
+	void RenderRetireQueue::SetSimulatedFrame(const uint64_t frameNumber)
+	{
+		std::lock_guard lock(mutex);
+		simulatedFrame = frameNumber;
+	}
+
+	void RenderRetireQueue::Retire(std::function<void()> release)
+	{
+		{
+			std::lock_guard lock(mutex);
+			if (deferring)
+			{
+				retired.push_back({ simulatedFrame, std::move(release) });
+				return;
+			}
+		}
+
+		release();
+	}
+
+	void RenderRetireQueue::ReleaseDrawn(const uint64_t drawnFrameNumber)
+	{
+		std::vector<Retired> releasing;
+		{
+			std::lock_guard lock(mutex);
+
+			// Retired while simulating frame N, so only packets before N can refer to it
+			const auto firstKept = std::stable_partition(retired.begin(), retired.end(), [&](const Retired& item) { return item.FrameNumber <= drawnFrameNumber + 1; });
+			std::move(retired.begin(), firstKept, std::back_inserter(releasing));
+			retired.erase(retired.begin(), firstKept);
+		}
+
+		for (const auto& item : releasing) { item.Release(); }
+	}
+
+	size_t RenderRetireQueue::GetRetiredCount() const
+	{
+		std::lock_guard lock(mutex);
+		return retired.size();
+	}
+}
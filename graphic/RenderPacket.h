@@ -0,0 +1,141 @@
+#pragma once
+#ifndef RENDERPACKET_H
+#define RENDERPACKET_H
+
+#include <SDL.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace gamelib
+{
+	/// <summary>
+	/// What to draw for one game object, copied out of the object at the end of an update so that it can be drawn
+	/// while the object is being updated again
+	/// </summary>
+	struct RenderItem
+	{
+		// Stays valid until the packet is drawn: textures unloaded meanwhile are retired (see RenderRetireQueue)
+		SDL_Texture* Texture = nullptr;
+		SDL_Rect Source {};
+		SDL_Rect Destination {};
+		int GameObjectId {};
+		uint32_t FrameIndex {};
+		uint16_t Layer {};
+		bool IsVisible = true;
+
+		// Drawn instead of a texture, for objects that draw themselves. Must hold copies of what it draws rather
+		// than refer to the object, which may be updated meanwhile
+		std::function<void(SDL_Renderer* renderer)> Command;
+	};
+
+	/// <summary>
+	/// Everything needed to draw one simulated frame. Packets are reused, so their items keep their capacity
+	/// </summary>
+	struct RenderPacket
+	{
+		uint64_t FrameNumber {};
+		unsigned long DeltaMs {};
+		std::vector<RenderItem> Items;
+
+		void Clear() { Items.clear(); }
+
+		// Draws the visible items in order
+		void Draw(SDL_Renderer* renderer) const;
+	};
+
+	/// <summary>
+	/// Hands render packets from one simulation thread to one render thread.
+	/// Packets are read in the order they were written. The writer can be up to all packets ahead of the reader: with
+	/// two packets, frame N+1 is simulated while frame N is drawn, and a third lets the simulation run one more frame
+	/// ahead. Beyond that the writer waits for the reader to finish with a packet.
+	/// </summary>
+	class RenderPacketBuffer
+	{
+	public:
+		explicit RenderPacketBuffer(size_t packetCount = 2);
+
+		RenderPacketBuffer(const RenderPacketBuffer& other) = delete;
+		RenderPacketBuffer& operator=(const RenderPacketBuffer& other) = delete;
+
+		// Waits for a free packet to write into. Null once closed
+		RenderPacket* BeginWrite();
+
+		// Hands the packet being written to the reader
+		void EndWrite();
+
+		// The oldest packet not yet read. Waits for one unless told not to; null when there is none and, if waiting,
+		// the buffer has been closed. Packets written before closing can still be read
+		const RenderPacket* BeginRead(bool wait = true);
+
+		// As BeginRead(), waiting no longer than the timeout, e.g. to do other work on the render thread meanwhile
+		const RenderPacket* BeginReadFor(std::chrono::microseconds timeout);
+
+		// Frees the packet being read for writing
+		void EndRead();
+
+		// Wakes and turns away anyone waiting, e.g. when either side stops
+		void Close();
+
+		// Drops any unread packets and allows writing again
+		void Reset();
+
+		[[nodiscard]] size_t GetPacketCount() const { return packets.size(); }
+		[[nodiscard]] size_t GetReadyCount() const;
+		[[nodiscard]] bool IsClosed() const;
+
+	private:
+		std::vector<RenderPacket> packets;
+		mutable std::mutex mutex;
+		std::condition_variable changed;
+		size_t writeIndex = 0;
+		size_t readIndex = 0;
+
+		// Written and not yet read
+		size_t ready = 0;
+
+		// Written and not yet finished with by the reader
+		size_t filled = 0;
+		bool closed = false;
+	};
+
+	/// <summary>
+	/// Render resources the simulation has finished with but a packet not yet drawn may still use, e.g. the textures
+	/// of unloaded assets. While deferring, they are released by the render thread once every packet snapshotted
+	/// before they were retired has been drawn; otherwise they are released straight away
+	/// </summary>
+	class RenderRetireQueue
+	{
+	public:
+		// Turning deferral off releases everything retired so far
+		void SetDeferring(bool isDeferring);
+		[[nodiscard]] bool IsDeferring() const;
+
+		// The frame being simulated: resources retired from now on can only be in packets of earlier frames
+		void SetSimulatedFrame(uint64_t frameNumber);
+
+		void Retire(std::function<void()> release);
+
+		// Releases what no packet after the drawn one can refer to. Render thread only
+		void ReleaseDrawn(uint64_t drawnFrameNumber);
+
+		[[nodiscard]] size_t GetRetiredCount() const;
+
+	private:
+		struct Retired
+		{
+			uint64_t FrameNumber;
+			std::function<void()> Release;
+		};
+
+		mutable std::mutex mutex;
+		std::vector<Retired> retired;
+		uint64_t simulatedFrame = 0;
+		bool deferring = false;
+	};
+}
+
+#endif
@@ -133,6 +133,11 @@ namespace gamelib
 		IMG_Quit();
 	}
 	
+	void SdlGraphicsManager::DestroyTexture(SDL_Texture* texture)
+	{
+		retireQueue.Retire([texture] { SDL_DestroyTexture(texture); });
+	}
+
 	std::shared_ptr<GraphicAsset> SdlGraphicsManager::ToGraphicAsset(const std::shared_ptr<Asset>& asset)
 	{
 		return AsAsset<GraphicAsset>(asset);
@@ -7,6 +7,7 @@
 
 #include <functional>
 
+#include "RenderPacket.h"
 #include "Window.h"
 #include "events/EventSubscriber.h"
 #include "objects/GameObject.h"
@@ -53,6 +54,12 @@ namespace gamelib
 		// Casts a standard Asset to a Graphics Asset
 		static std::shared_ptr<GraphicAsset> ToGraphicAsset(const std::shared_ptr<Asset>& asset);
 
+		// Destroys the texture, or leaves it to the render thread while packets that may draw it are waiting
+		void DestroyTexture(SDL_Texture* texture);
+
+		// Deferred by a PipelinedGameLoop while it runs
+		RenderRetireQueue& GetRetireQueue() { return retireQueue; }
+
 		const char* MainWindowName = "main";
 	protected:		
 		static SdlGraphicsManager* instance;
@@ -61,6 +68,7 @@ namespace gamelib
 		SdlGraphicsManager();	
 		std::shared_ptr<Window> mainWindow; //The window we'll be rendering to
 		std::map<std::string, std::shared_ptr<Window>> windows;
+		RenderRetireQueue retireQueue;
 		ListOfEvents HandleEvent(const std::shared_ptr<Event>& event, unsigned long deltaMs) override;
 	};
 }
@@ -195,7 +195,7 @@ namespace gamelib
 		const auto event = serializationManager->Deserialize(msgHeader, buffer);
 		
 		// Some events are known not to have a specific subscriber target
-		const bool noTarget = messageType == StartNetworkLevelEventId.Name;
+		const bool noTarget = messageType == StartNetworkLevelEventId.GetName();
 
 		if(event)
 		{			
@@ -1,7 +1,5 @@
 #include "GameStatePusher.h"
 
-#include "processes/Action.h"
-
 namespace gamelib
 {
 	GameStatePusher::GameStatePusher(const std::function<void()>& sendGameStateFunc, const int sendRateMs, const bool isGameServer,
@@ -10,37 +8,31 @@ namespace gamelib
 	{
 	}
 
+	GameStatePusher::~GameStatePusher()
+	{
+		processManager.GetTimers().Cancel(sendTimer);
+	}
+
 	void GameStatePusher::Initialise()
 	{
-		if (isGameServer)
+		// Nothing to prepare: sending is scheduled by Run()
+	}
+
+	void GameStatePusher::Run()
+	{
+		if (isGameServer || sendTimer.IsValid())
 		{
 			// We won't send out periodic state to the game server if we are the game server
 			return;
 		}
 
 		// Send game state every sendRateMs
-		gameStateSendInterval.SetFrequency(sendRateMs);
-
-		// create task to send the game state as a background task
-		sendTask = std::dynamic_pointer_cast<Process>(std::make_shared<Action>([&](const unsigned long deltaMs)
+		sendTimer = processManager.GetTimers().SchedulePeriodic(static_cast<unsigned long>(sendRateMs), [this]()
 		{
-			// Update timers
-			gameStateSendInterval.Update(deltaMs);
-
-			// Send game state of sending interval is elapsed
-			gameStateSendInterval.DoIfReady([&]()
+			if (sendGameStateFunc)
 			{
-					if (sendGameStateFunc) 
-					{
-						sendGameStateFunc();
-					}
-			});
-		}, false));
-	}
-
-	void GameStatePusher::Run() const
-	{
-		// Add as a background task
-		processManager.AttachProcess(sendTask);
+				sendGameStateFunc();
+			}
+		});
 	}
 }
@@ -4,7 +4,6 @@
 
 #include <functional>
 #include "processes/ProcessManager.h"
-#include "time/PeriodicTimer.h"
 
 namespace gamelib
 {
@@ -14,7 +13,10 @@ namespace gamelib
 		void Initialise();
 		GameStatePusher(const std::function<void()>& sendGameStateFunc, int sendRateMs, bool isGameServer,
 		                ProcessManager& processManager);
-		void Run() const;
+		~GameStatePusher();
+		GameStatePusher(const GameStatePusher& other) = delete;
+		GameStatePusher& operator=(const GameStatePusher& other) = delete;
+		void Run();
 
 	private:
 		bool isGameServer;
@@ -22,9 +24,9 @@ namespace gamelib
 		// Periodically send game state to the game server
 		int sendRateMs;
 
-		std::shared_ptr<Process> sendTask;
+		// Scheduled on the process manager's timers
+		TimerHandle sendTimer;
 
-		PeriodicTimer gameStateSendInterval;
 		ProcessManager& processManager;  // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
 		std::function<void()> sendGameStateFunc;
 	};
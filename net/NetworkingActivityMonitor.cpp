@@ -27,10 +27,13 @@ namespace gamelib
 		statisticsFile = std::make_shared<TextFile>("statistics.txt");
 	}
 
-	void NetworkingActivityMonitor::Initialise()
+	NetworkingActivityMonitor::~NetworkingActivityMonitor()
 	{
-		constexpr auto saveIntervalMs = 1000; // every second
+		processManager.GetTimers().Cancel(saveStatisticsTimer);
+	}
 
+	void NetworkingActivityMonitor::Initialise()
+	{
 		// Subscribe to Network Events
 		eventManager.SubscribeToEvent(NetworkTrafficReceivedEventId, this);
 		eventManager.SubscribeToEvent(ReliableUdpPacketReceivedEventId, this);
@@ -39,25 +42,22 @@ namespace gamelib
 		eventManager.SubscribeToEvent(ReliableUdpAckPacketEventId, this);
 		eventManager.SubscribeToEvent(ReliableUdpPacketRttCalculatedEventId, this);
 
-		// Schedule save operation to run periodically
-		statisticsSampleInterval.SetFrequency(saveIntervalMs);
-
 		InitialiseStatisticsFile();
 
-		// Schedule sampler to run as a background process
+		// Schedule sampler to run periodically in the background
 		ScheduleSaveStatistics();
 	}
 
 	// Handle events
 	ListOfEvents NetworkingActivityMonitor::HandleEvent(const std::shared_ptr<Event>& evt, const unsigned long inDeltaMs)
 	{
-		if (evt->Id.PrimaryId == NetworkPlayerJoinedEventId.PrimaryId) { OnNetworkPlayerJoinedEvent(evt); }
-		if (evt->Id.PrimaryId == ReliableUdpPacketReceivedEventId.PrimaryId) { OnReliableUdpPacketReceivedEvent(evt); }
-		if (evt->Id.PrimaryId == ReliableUdpCheckSumFailedEventId.PrimaryId) { OnReliableUdpCheckSumFailedEvent(evt); }
-		if (evt->Id.PrimaryId == ReliableUdpPacketLossDetectedEventId.PrimaryId) { OnReliableUdpPacketLossDetectedEvent(evt); }
-		if (evt->Id.PrimaryId == ReliableUdpAckPacketEventId.PrimaryId) { OnReliableUdpAckPacketEvent(evt); }
-		if (evt->Id.PrimaryId == ReliableUdpPacketRttCalculatedEventId.PrimaryId) { OnReliableUdpPacketRttCalculatedEvent(evt); }
-		if (evt->Id.PrimaryId == NetworkTrafficReceivedEventId.PrimaryId) { OnNetworkTrafficReceivedEvent(evt); }
+		if (evt->Id.GetPrimaryId() == NetworkPlayerJoinedEventId.GetPrimaryId()) { OnNetworkPlayerJoinedEvent(evt); }
+		if (evt->Id.GetPrimaryId() == ReliableUdpPacketReceivedEventId.GetPrimaryId()) { OnReliableUdpPacketReceivedEvent(evt); }
+		if (evt->Id.GetPrimaryId() == ReliableUdpCheckSumFailedEventId.GetPrimaryId()) { OnReliableUdpCheckSumFailedEvent(evt); }
+		if (evt->Id.GetPrimaryId() == ReliableUdpPacketLossDetectedEventId.GetPrimaryId()) { OnReliableUdpPacketLossDetectedEvent(evt); }
+		if (evt->Id.GetPrimaryId() == ReliableUdpAckPacketEventId.GetPrimaryId()) { OnReliableUdpAckPacketEvent(evt); }
+		if (evt->Id.GetPrimaryId() == ReliableUdpPacketRttCalculatedEventId.GetPrimaryId()) { OnReliableUdpPacketRttCalculatedEvent(evt); }
+		if (evt->Id.GetPrimaryId() == NetworkTrafficReceivedEventId.GetPrimaryId()) { OnNetworkTrafficReceivedEvent(evt); }
 		return {};
 	}
 
@@ -104,38 +104,22 @@ namespace gamelib
 		statisticsFile->Append(message.str(), false);
 	}
 
-	void NetworkingActivityMonitor::SaveAndReset(const unsigned long deltaMs)
+	void NetworkingActivityMonitor::SaveStatistics()
 	{
-		// Progress the interval
-		statisticsSampleInterval.Update(deltaMs);
-
-		// Will only write statistics to file if the statistics sampling interval has elapsed (ready)
-		statisticsSampleInterval.DoIfReady([&]()
-		{
-			// Record the current second we are in since game was started, this will be the independent variable
-			const auto tNowSecs = elapsedTimeProvider->GetElapsedTime();
+		// Record the current second we are in since game was started, this will be the independent variable
+		const auto tNowSecs = elapsedTimeProvider->GetElapsedTime();
 
-			AppendStatsToFile(tNowSecs);
+		AppendStatsToFile(tNowSecs);
 
-			// Reset statistics to zero.
-			stats.Reset();
-		});
+		// Reset statistics to zero.
+		stats.Reset();
 	}
 
 	void NetworkingActivityMonitor::ScheduleSaveStatistics()
 	{
-		// Schedule process to write statistics to file
-
-		const auto process = std::make_shared<Action>([this](auto&& deltaMs) { SaveAndReset(deltaMs); }, false);
-
-		ScheduleProcess(process);
-	}
-
-	// ReSharper disable once CppPassValueParameterByConstReference
-	void NetworkingActivityMonitor::ScheduleProcess(shared_ptr<Process> process) const
-	{
-		// Add this process to the process manager - schedules process to receive updates
-		processManager.AttachProcess(std::static_pointer_cast<Process>(process));
+		// Schedule timer to write statistics to file: fires only when due, unlike a process updated every tick
+		processManager.GetTimers().Cancel(saveStatisticsTimer);
+		saveStatisticsTimer = processManager.GetTimers().SchedulePeriodic(SaveIntervalMs, [this]() { SaveStatistics(); });
 	}
 
 	std::string NetworkingActivityMonitor::GetSubscriberName()
@@ -2,8 +2,6 @@
 #ifndef NETWORKING_ACTIVITY_MONITOR_H
 #define NETWORKING_ACTIVITY_MONITOR_H
 
-#include <processes/Action.h>
-#include <processes/Process.h>
 #include <utils/Utils.h>
 #include <file/TextFile.h>
 
@@ -11,7 +9,7 @@
 #include <events/EventManager.h>
 #include <events/EventSubscriber.h>
 #include "objects/GameObject.h"
-#include "time/PeriodicTimer.h"
+#include "time/TimerWheel.h"
 
 namespace gamelib
 {
@@ -23,11 +21,11 @@ namespace gamelib
 	public:
 	
 		NetworkingActivityMonitor(ProcessManager& processManager, EventManager& eventManager, std::shared_ptr<IElapsedTimeProvider> elapsedTimeProvider, bool verbose);
+		~NetworkingActivityMonitor() override;
 		void ScheduleSaveStatistics();
-		void ScheduleProcess(std::shared_ptr<Process> process) const;
 		void InitialiseStatisticsFile() const;
 		void AppendStatsToFile(int tSeconds) const;
-		void SaveAndReset(unsigned long deltaMs);
+		void SaveStatistics();
 		void Initialise();
 		ListOfEvents HandleEvent(const std::shared_ptr<Event>& evt, unsigned long inDeltaMs) override;
 		std::string GetSubscriberName() override;
@@ -38,7 +36,8 @@ namespace gamelib
 
 		NetworkingStatistics stats;
 		std::shared_ptr<gamelib::TextFile> statisticsFile;
-		gamelib::PeriodicTimer statisticsSampleInterval;
+		TimerHandle saveStatisticsTimer;
+		static constexpr auto SaveIntervalMs = 1000; // every second
 		ProcessManager& processManager;
 		EventManager& eventManager;
 		bool verbose;
@@ -2,6 +2,7 @@
 #include <SDL.h>
 #include <geometry/Coordinate.h>
 #include "graphic/GraphicAsset.h"
+#include "graphic/RenderPacket.h"
 #include "file/Logger.h"
 
 using namespace std;
@@ -151,6 +152,22 @@ namespace gamelib
 		}
 	}
 	
+	bool DrawableGameObject::AddRenderItems(std::vector<RenderItem>& items) const
+	{
+		if (!HasGraphic() || graphic->Type != "graphic") { return false; }
+
+		const auto& viewPort = graphic->GetViewPort();
+		RenderItem item;
+		item.Texture = graphic->GetTexture();
+		item.Source = viewPort;
+		item.Destination = { Position.GetX(), Position.GetY(), viewPort.w, viewPort.h };
+		item.GameObjectId = Id;
+		item.FrameIndex = 0;
+		item.IsVisible = IsVisible;
+		items.push_back(item);
+		return true;
+	}
+
 	std::shared_ptr<GraphicAsset> DrawableGameObject::GetGraphic() const
 	{
 		return graphic;
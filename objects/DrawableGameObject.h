@@ -25,6 +25,7 @@ namespace gamelib
 		bool SupportsColourKey(bool yesNo);
 		static void DrawFilledRect(SDL_Renderer* renderer, const SDL_Rect* dimensions, SDL_Color colour);
 		void Draw(SDL_Renderer* renderer) override;
+		bool AddRenderItems(std::vector<RenderItem>& items) const override;
 		void DrawGraphic(SDL_Renderer* renderer) const;
 		void SetColourKey(const ColourKey& key);
 		void SetColourKey(Uint8 r, Uint8 g, Uint8 b);
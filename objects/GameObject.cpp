@@ -29,6 +29,8 @@ namespace gamelib
 
 	void GameObject::Draw(SDL_Renderer* renderer) { }
 
+	bool GameObject::AddRenderItems(std::vector<RenderItem>& items) const { return false; }
+
 	SDL_Rect GameObject::CalculateBounds(const Coordinate<int> position, const int width, const int height)
 	{
 		return {position.GetX(), position.GetY(), width, height};
@@ -17,6 +17,7 @@
 namespace gamelib
 {
 	class Event;
+	struct RenderItem;
 	typedef std::vector<std::shared_ptr<Event>> ListOfEvents;
 
 
@@ -56,6 +57,10 @@ namespace gamelib
 		// All game objects must draw
 		virtual void Draw(SDL_Renderer* renderer) = 0;
 
+		// Adds what Draw() would draw, for drawing later on another thread. False if it can't be described, e.g. the
+		// object does its own drawing with state that can't be copied
+		virtual bool AddRenderItems(std::vector<RenderItem>& items) const;
+
 		// Game objects can contain string and number properties
 
 		std::map<std::string, std::string> StringProperties;
@@ -7,7 +7,9 @@ namespace gamelib
 	class Action final : public Process
 	{
 	public:
-		explicit Action(std::function<void(unsigned long deltaMs)> action, const bool succeedAfterExecution = true) : Process(), action(std::move(action)), succeedAfterExecution(succeedAfterExecution) {}
+		explicit Action(std::function<void(unsigned long deltaMs)> action, const bool succeedAfterExecution = true, const ProcessAffinity affinity = ProcessAffinity::OwnerThread)
+			: Process(), action(std::move(action)), succeedAfterExecution(succeedAfterExecution), affinity(affinity) {}
+		[[nodiscard]] ProcessAffinity GetAffinity() const override { return affinity; }
 		void OnUpdate(const unsigned long deltaMs) override
 		{
 			action(deltaMs);
@@ -21,5 +23,6 @@ namespace gamelib
 	private:
 		std::function<void(unsigned long)> action;
 		bool succeedAfterExecution;
+		ProcessAffinity affinity;
 	};
 }
\ No newline at end of file
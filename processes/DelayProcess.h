@@ -7,6 +7,7 @@ namespace gamelib
 	{
 	public:
 		explicit DelayProcess(const unsigned long delayMs) : Process(), delayTargetMs(delayMs), delayedMs(0) {}
+		[[nodiscard]] ProcessAffinity GetAffinity() const override { return ProcessAffinity::AnyThread; }
 	protected:
 		void OnUpdate(const unsigned long deltaMs) override
 		{
@@ -1,8 +1,30 @@
 #pragma once
 #include <memory>
+#include <cstdint>
 
 namespace gamelib
 {
+	/// <summary>
+	/// Where a process's OnUpdate may run when the process manager updates in parallel
+	/// </summary>
+	enum class ProcessAffinity : std::uint8_t
+	{
+		// Always updated on the thread calling UpdateProcesses (the game loop)
+		OwnerThread,
+
+		// Only touches its own state while updating, so is safe to update on a worker thread alongside other processes
+		AnyThread
+	};
+
+	// Order in which processes are updated under a frame budget. Critical processes are updated every frame, whatever the budget
+	enum class ProcessPriority : std::uint8_t
+	{
+		Critical,
+		High,
+		Normal,
+		Low
+	};
+
 	class Process
 	{
 		friend class ProcessManager;
@@ -45,8 +67,19 @@ namespace gamelib
 	std::shared_ptr<Process> GetChild() { return child; }
 	std::shared_ptr<Process> PeekChild() { return child; }
 
+	/// <summary>
+	/// Processes are updated on the owner thread unless they declare otherwise.
+	/// OnInit, OnSuccess, OnFail and OnAbort always run on the owner thread; AnyThread processes must not attach processes from OnUpdate.
+	/// </summary>
+	[[nodiscard]] virtual ProcessAffinity GetAffinity() const { return ProcessAffinity::OwnerThread; }
+
+	// Processes default to Normal, see ProcessManager::SetFrameBudget()
+	[[nodiscard]] ProcessPriority GetPriority() const { return priority; }
+	void SetPriority(const ProcessPriority newPriority) { priority = newPriority; }
+
 	private:
 		State state;
+		ProcessPriority priority = ProcessPriority::Normal;
 		std::shared_ptr<Process> child;
 		void SetState(const State newState) { state = newState; }
 	protected:
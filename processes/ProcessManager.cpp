@@ -1,57 +1,258 @@
 #include <processes/ProcessManager.h>
+#include "exceptions/EngineException.h"
+#include "structure/Profiler.h"
+#include <algorithm>
 
 using namespace std;
 
 namespace gamelib
 {
-	unsigned int ProcessManager::UpdateProcesses(const unsigned long deltaMs)
+	ProcessUpdateStats ProcessManager::UpdateProcesses(const unsigned long deltaMs)
 	{
-		unsigned short int successCount = 0;
-		unsigned short int failCount = 0;
+		PROFILE_ZONE("ProcessManager::UpdateProcesses");
+		ProcessUpdateStats stats;
 
-		auto it = processes.begin();
-		while (it != processes.end())
+		timers.Advance(deltaMs);
+
+		const auto start = Clock::now();
+		updating = true;
+		try { UpdateAll(deltaMs, stats); }
+		catch (...)
 		{
-			const shared_ptr<Process> currentProcess = (*it);
-			const auto thisIt = it;
-			++it;
-			if (currentProcess->GetState() == Process::State::uninitialized) { currentProcess->OnInit(); }
-			if (currentProcess->GetState() == Process::State::running) { currentProcess->OnUpdate(deltaMs); }
+			AddAttachedWhileUpdating();
+			throw;
+		}
+		AddAttachedWhileUpdating();
+
+		stats.Elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+		if (frameBudget.count() > 0 && stats.Elapsed > frameBudget) { stats.Overrun = stats.Elapsed - frameBudget; }
+
+		RemoveDeadProcesses(stats);
+
+		return stats;
+	}
+
+	void ProcessManager::UpdateAll(const unsigned long deltaMs, ProcessUpdateStats& stats)
+	{
+		const auto start = Clock::now();
+		const auto count = processes.size();
+		const auto parallel = updateWorkers && updateWorkers->GetThreadCount() > 0;
+		const auto budgeted = frameBudget.count() > 0;
+		anyThreadProcesses.clear();
+		ownerThreadProcesses.clear();
+		for (auto& waiting : budgetedProcesses) { waiting.clear(); }
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const auto process = processes[i].get();
+			if (process->GetState() == Process::State::uninitialized) { process->OnInit(); }
+
+			states[i] = process->GetState();
+			if (states[i] != Process::State::running) { continue; }
 
-			if (currentProcess->IsDead())
+			pendingDeltaMs[i] += deltaMs;
+			const auto index = static_cast<uint32_t>(i);
+
+			if (parallel && process->GetAffinity() == ProcessAffinity::AnyThread) { anyThreadProcesses.push_back(index); }
+			else if (budgeted && process->GetPriority() != ProcessPriority::Critical && framesDeferred[i] < maxFramesDeferred)
+			{
+				const auto priority = static_cast<size_t>(process->GetPriority()) - 1;
+				budgetedProcesses[priority * 2 + (framesDeferred[i] > 0 ? 0 : 1)].push_back(index);
+			}
+			else if (parallel) { ownerThreadProcesses.push_back(index); }
+			else
 			{
-				switch (currentProcess->GetState())
+				UpdateAt(index);
+				stats.Ran++;
+			}
+		}
+
+		auto updateAnyThread = [&](const size_t index) { UpdateAt(anyThreadProcesses[index]); };
+		auto updateOnCallingThread = [&]
+		{
+			for (const auto index : ownerThreadProcesses) { UpdateAt(index); }
+			if (budgeted) { UpdateWithinBudget(start, stats); }
+		};
+		stats.Ran += static_cast<unsigned int>(anyThreadProcesses.size() + ownerThreadProcesses.size());
+
+		// Not worth waking the workers for a handful of processes
+		if (anyThreadProcesses.size() < 2)
+		{
+			updateOnCallingThread();
+			for (size_t i = 0; i < anyThreadProcesses.size(); i++) { updateAnyThread(i); }
+			return;
+		}
+
+		updateWorkers->ParallelFor(anyThreadProcesses.size(), updateAnyThread, updateOnCallingThread);
+	}
+
+	void ProcessManager::UpdateWithinBudget(const Clock::time_point start, ProcessUpdateStats& stats)
+	{
+		// Longest deferred first, so each priority is worked through round-robin
+		for (size_t deferred = 0; deferred < budgetedProcesses.size(); deferred += 2)
+		{
+			std::sort(budgetedProcesses[deferred].begin(), budgetedProcesses[deferred].end(), [this](const uint32_t a, const uint32_t b)
+			{
+				return framesDeferred[a] != framesDeferred[b] ? framesDeferred[a] > framesDeferred[b] : a < b;
+			});
+		}
+
+		auto overBudget = false;
+		for (const auto& waiting : budgetedProcesses)
+		{
+			for (const auto index : waiting)
+			{
+				overBudget = overBudget || Clock::now() - start >= frameBudget;
+				if (overBudget)
 				{
-					case Process::State::succeeded:
+					// Keeps its pending deltaMs for next time
+					framesDeferred[index]++;
+					stats.Deferred++;
+					continue;
+				}
+
+				UpdateAt(index);
+				stats.Ran++;
+			}
+		}
+	}
+
+	void ProcessManager::UpdateAt(const uint32_t index)
+	{
+		const auto process = processes[index].get();
+		process->OnUpdate(pendingDeltaMs[index]);
+		states[index] = process->GetState();
+		pendingDeltaMs[index] = 0;
+		framesDeferred[index] = 0;
+	}
+
+	void ProcessManager::SetFrameBudget(const std::chrono::microseconds budget, const unsigned int maxFramesDeferred)
+	{
+		frameBudget = budget;
+
+		// Counted per process in 16 bits
+		this->maxFramesDeferred = std::min(maxFramesDeferred, 0xFFFFu);
+	}
+
+	void ProcessManager::RemoveDeadProcesses(ProcessUpdateStats& stats)
+	{
+		size_t i = 0;
+		while (i < states.size())
+		{
+			const auto state = states[i];
+			if (state != Process::State::succeeded && state != Process::State::failed && state != Process::State::aborted)
+			{
+				++i;
+				continue;
+			}
+
+			// Callbacks may attach processes, growing the arrays
+			const auto process = processes[i];
+			switch (state)
+			{
+				case Process::State::succeeded:
+				{
+					process->OnSuccess();
+					shared_ptr<Process> child = process->GetChild();
+					if (child)
 					{
-						currentProcess->OnSuccess();
-						shared_ptr<Process> child = currentProcess->GetChild();
-						if (child)
-						{
-							AttachProcess(child);
-						}
-						else
-						{
-							++successCount;
-						}
-						break;
+						AttachProcess(child);
 					}
-					case Process::State::failed:
+					else
 					{
-						currentProcess->OnFail();
-						++failCount;
-						break;
+						++stats.Succeeded;
 					}
+					break;
 				}
-				processes.erase(thisIt);
+				case Process::State::failed:
+				{
+					process->OnFail();
+					++stats.Failed;
+					break;
+				}
+				default: break;
 			}
+
+			// Swaps the last process in, which is looked at next
+			RemoveAt(i);
+		}
+	}
+
+	ProcessHandle ProcessManager::AttachProcess(const std::shared_ptr<Process>& process)
+	{
+		const auto dense = processes.size() + attachedWhileUpdating.size();
+		if (dense >= std::numeric_limits<uint32_t>::max()) { THROW(0, "Too many processes", "ProcessManager"); }
+
+		uint32_t slot;
+		if (!freeSlots.empty())
+		{
+			slot = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		else
+		{
+			slot = static_cast<uint32_t>(slots.size());
+			slots.emplace_back();
+		}
+		slots[slot].Dense = static_cast<uint32_t>(dense);
+
+		// Gets the dense index reserved above once the update is over
+		if (updating) { attachedWhileUpdating.push_back(process); }
+		else { AddProcess(process); }
+		slotOfProcess.push_back(slot);
+
+		return { slot, slots[slot].Generation };
+	}
+
+	void ProcessManager::AddAttachedWhileUpdating()
+	{
+		updating = false;
+		for (auto& process : attachedWhileUpdating) { AddProcess(std::move(process)); }
+		attachedWhileUpdating.clear();
+	}
+
+	void ProcessManager::AddProcess(std::shared_ptr<Process> process)
+	{
+		states.push_back(process->GetState());
+		framesDeferred.push_back(0);
+		pendingDeltaMs.push_back(0);
+		processes.push_back(std::move(process));
+	}
+
+	void ProcessManager::RemoveAt(const size_t dense)
+	{
+		auto& removed = slots[slotOfProcess[dense]];
+		removed.Generation++;
+		freeSlots.push_back(slotOfProcess[dense]);
+
+		const auto last = processes.size() - 1;
+		if (dense != last)
+		{
+			processes[dense] = std::move(processes[last]);
+			states[dense] = states[last];
+			framesDeferred[dense] = framesDeferred[last];
+			pendingDeltaMs[dense] = pendingDeltaMs[last];
+			slotOfProcess[dense] = slotOfProcess[last];
+			slots[slotOfProcess[dense]].Dense = static_cast<uint32_t>(dense);
 		}
-		return ((successCount << 16 | failCount));
+
+		processes.pop_back();
+		states.pop_back();
+		framesDeferred.pop_back();
+		pendingDeltaMs.pop_back();
+		slotOfProcess.pop_back();
+	}
+
+	std::shared_ptr<Process> ProcessManager::GetProcess(const ProcessHandle handle) const
+	{
+		if (handle.Index >= slots.size() || slots[handle.Index].Generation != handle.Generation) { return nullptr; }
+
+		const auto dense = slots[handle.Index].Dense;
+		return dense < processes.size() ? processes[dense] : attachedWhileUpdating[dense - processes.size()];
 	}
 
-	std::weak_ptr<Process> ProcessManager::AttachProcess(const std::shared_ptr<Process>& process)
+	void ProcessManager::SetParallelUpdate(const bool enabled, const size_t workerThreads)
 	{
-		processes.push_back(process);
-		return std::weak_ptr(process);
+		updateWorkers = enabled ? std::make_unique<ThreadPool>(workerThreads) : nullptr;
 	}
 }
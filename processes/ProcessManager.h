@@ -1,24 +1,142 @@
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
 #include <memory>
-#include <list>
+#include <vector>
 #include <processes/Process.h>
+#include <processes/Task.h>
+#include <time/TimerWheel.h>
+#include <utils/ThreadPool.h>
 
 namespace gamelib
 {
+	/// <summary>
+	/// Identifies a process attached with ProcessManager::AttachProcess().
+	/// Handles stay safe to use after the process is removed: the generation no longer matches and they are ignored.
+	/// </summary>
+	struct ProcessHandle
+	{
+		uint32_t Index = std::numeric_limits<uint32_t>::max();
+		uint32_t Generation = 0;
+
+		[[nodiscard]] bool IsValid() const { return Index != std::numeric_limits<uint32_t>::max(); }
+	};
+
+	// What one UpdateProcesses() call did
+	struct ProcessUpdateStats
+	{
+		// Processes updated
+		unsigned int Ran {};
+
+		// Running processes left for a later update by the frame budget
+		unsigned int Deferred {};
+
+		// Processes removed having succeeded (without a child to carry on) or failed
+		unsigned int Succeeded {};
+		unsigned int Failed {};
+
+		// Time spent updating processes, and how far that went past the frame budget
+		std::chrono::microseconds Elapsed {};
+		std::chrono::microseconds Overrun {};
+	};
+
+	/// <summary>
+	/// Updates attached processes each UpdateProcesses() call until they succeed or fail, then runs their callbacks and
+	/// starts their children. Processes are kept in contiguous arrays and removed by swapping in the last process,
+	/// so they are not updated in the order they were attached.
+	/// </summary>
 	class ProcessManager
 	{
 	public:
 		~ProcessManager() = default;
 		ProcessManager() = default;
 
-		unsigned int UpdateProcesses(unsigned long deltaMs);
-		std::weak_ptr<Process> AttachProcess(const std::shared_ptr<Process>& process);
+		/// <summary>
+		/// Advances the timers, updates every process, then runs the success or fail callbacks of those that finished and attaches their children.
+		/// Chained children, and any processes attached during the update, start on the next UpdateProcesses() call.
+		/// </summary>
+		ProcessUpdateStats UpdateProcesses(unsigned long deltaMs);
+		ProcessHandle AttachProcess(const std::shared_ptr<Process>& process);
+
+		// Runs a coroutine as a process, starting on the next update
+		ProcessHandle StartTask(Task task) { return AttachProcess(TaskProcess::Create(std::move(task))); }
 		void AbortAllProcesses(bool immediate) const { for (auto& process : processes) process->OnAbort(); }
 
-		[[nodiscard]] unsigned int GetProcessCount() const { return static_cast<unsigned int>(processes.size()); }
+		// Timers advanced by UpdateProcesses(): prefer these to processes that only wait for time to pass
+		[[nodiscard]] TimerWheel& GetTimers() { return timers; }
+
+		// Null once the process has been removed
+		[[nodiscard]] std::shared_ptr<Process> GetProcess(ProcessHandle handle) const;
+		[[nodiscard]] bool IsAttached(const ProcessHandle handle) const { return GetProcess(handle) != nullptr; }
+
+		/// <summary>
+		/// When enabled, UpdateProcesses() updates AnyThread processes on worker threads while OwnerThread processes are
+		/// updated on the calling thread. Callbacks and child chaining still happen on the calling thread.
+		/// workerThreads = 0 uses one worker per hardware thread, less the calling thread.
+		/// </summary>
+		void SetParallelUpdate(bool enabled, size_t workerThreads = 0);
+		[[nodiscard]] bool IsParallelUpdate() const { return updateWorkers != nullptr; }
+
+		/// <summary>
+		/// Limits time spent updating processes per UpdateProcesses(); zero means no limit.
+		/// Critical processes are always updated. The rest are updated highest priority first, those deferred last time
+		/// ahead of the others in their priority, until the budget is spent; the rest are deferred to the next update.
+		/// A process deferred maxFramesDeferred updates in a row is updated next time whatever the budget, and deferred
+		/// processes are given the deltaMs they missed when they are next updated.
+		/// With parallel update enabled, AnyThread processes are always updated: the budget applies to the calling thread.
+		/// </summary>
+		void SetFrameBudget(std::chrono::microseconds budget, unsigned int maxFramesDeferred = 10);
+
+		[[nodiscard]] unsigned int GetProcessCount() const { return static_cast<unsigned int>(processes.size() + attachedWhileUpdating.size()); }
 	private:
+		using Clock = std::chrono::steady_clock;
+		static constexpr size_t ProcessPriorityCount = 4;
+
+		void UpdateAll(unsigned long deltaMs, ProcessUpdateStats& stats);
+		void UpdateAt(uint32_t index);
+		void UpdateWithinBudget(Clock::time_point start, ProcessUpdateStats& stats);
+		void AddAttachedWhileUpdating();
+		void AddProcess(std::shared_ptr<Process> process);
+		void RemoveDeadProcesses(ProcessUpdateStats& stats);
+		void RemoveAt(size_t dense);
+
+		struct Slot
+		{
+			uint32_t Dense = 0;
+			uint32_t Generation = 0;
+		};
+
+		// Dense arrays, one entry per process. States are refreshed as processes are updated, so finding the dead ones
+		// doesn't touch the processes themselves
+		std::vector<std::shared_ptr<Process>> processes;
+		std::vector<Process::State> states;
+		std::vector<uint32_t> slotOfProcess;
+
+		// Updates in a row each process has been deferred for, and the deltaMs it has yet to be given
+		std::vector<uint16_t> framesDeferred;
+		std::vector<unsigned long> pendingDeltaMs;
+
+		// Handles index slots, which point into the dense arrays
+		std::vector<Slot> slots;
+		std::vector<uint32_t> freeSlots;
+
+		// Attached while processes are being updated, added afterwards so nothing moves under the update
+		bool updating = false;
+		std::vector<std::shared_ptr<Process>> attachedWhileUpdating;
+
+		TimerWheel timers;
+
+		// Frame budget. Processes waiting on it, by priority and then those deferred last time ahead of the others
+		std::chrono::microseconds frameBudget {0};
+		unsigned int maxFramesDeferred = 10;
+		std::array<std::vector<uint32_t>, (ProcessPriorityCount - 1) * 2> budgetedProcesses;
 
-		std::list <std::shared_ptr<Process>> processes;
+		// Parallel updates
+		std::unique_ptr<ThreadPool> updateWorkers;
+		std::vector<uint32_t> anyThreadProcesses;
+		std::vector<uint32_t> ownerThreadProcesses;
 	};
 }
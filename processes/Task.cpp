@@ -0,0 +1,191 @@
+#include "Task.h"
+#include "events/Event.h"
+
+namespace gamelib
+{
+	namespace
+	{
+		EventBlockPool* GetTaskProcessBlocks()
+		{
+			// Never destroyed, like the frame pool
+			static auto* blocks = new EventBlockPool();
+			return blocks;
+		}
+	}
+
+	void* TaskFramePool::Allocate(const size_t size)
+	{
+		if (size == 0 || size > MaxPooledSize) { return ::operator new(size); }
+
+		// Every block of a size class is the class's full size, see EventBlockPool
+		const auto sizeClass = (size - 1) / Granularity;
+		return sizeClasses[sizeClass].Allocate((sizeClass + 1) * Granularity);
+	}
+
+	void TaskFramePool::Release(void* frame, const size_t size)
+	{
+		if (size == 0 || size > MaxPooledSize)
+		{
+			::operator delete(frame);
+			return;
+		}
+
+		const auto sizeClass = (size - 1) / Granularity;
+		sizeClasses[sizeClass].Release(frame, (sizeClass + 1) * Granularity);
+	}
+
+	EventPoolStatistics TaskFramePool::GetStatistics()
+	{
+		EventPoolStatistics total;
+		for (auto& sizeClass : sizeClasses)
+		{
+			const auto statistics = sizeClass.GetStatistics();
+			total.Hits += statistics.Hits;
+			total.Misses += statistics.Misses;
+			total.FreeBlocks += statistics.FreeBlocks;
+		}
+		return total;
+	}
+
+	void TaskFramePool::ResetStatistics()
+	{
+		for (auto& sizeClass : sizeClasses) { sizeClass.ResetStatistics(); }
+	}
+
+	Task& Task::operator=(Task&& other) noexcept
+	{
+		if (this != &other)
+		{
+			if (handle) { handle.destroy(); }
+			handle = std::exchange(other.handle, nullptr);
+		}
+		return *this;
+	}
+
+	std::coroutine_handle<> Task::await_suspend(const Handle awaiting) noexcept
+	{
+		auto& promise = handle.promise();
+		promise.State = awaiting.promise().State;
+		promise.Continuation = awaiting;
+		promise.State->Current = handle;
+
+		// Start the awaited task straight away
+		return handle;
+	}
+
+	void Task::await_resume() const
+	{
+		if (handle.promise().Error) { std::rethrow_exception(handle.promise().Error); }
+	}
+
+	void Delay::await_suspend(const Task::Handle awaiting) const noexcept
+	{
+		auto& state = *awaiting.promise().State;
+		state.Wait = TaskWaitState::Reason::Delay;
+		state.RemainingMs = Ms;
+		state.Current = awaiting;
+	}
+
+	void NextFrame::await_suspend(const Task::Handle awaiting) const noexcept
+	{
+		auto& state = *awaiting.promise().State;
+		state.Wait = TaskWaitState::Reason::NextFrame;
+		state.Current = awaiting;
+	}
+
+	void EventRaised::await_suspend(const Task::Handle awaiting) noexcept
+	{
+		State = awaiting.promise().State;
+		State->Wait = TaskWaitState::Reason::Event;
+		State->WaitEventId = Id;
+		State->RaisedEvent = nullptr;
+		State->Current = awaiting;
+	}
+
+	std::shared_ptr<Event> EventRaised::await_resume() const
+	{
+		return std::exchange(State->RaisedEvent, nullptr);
+	}
+
+	std::shared_ptr<TaskProcess> TaskProcess::Create(Task task)
+	{
+		return std::allocate_shared<TaskProcess>(EventPoolAllocator<TaskProcess>(GetTaskProcessBlocks()), std::move(task));
+	}
+
+	TaskProcess::TaskProcess(Task task) : task(std::move(task))
+	{
+		if (this->task.handle)
+		{
+			this->task.handle.promise().State = &state;
+			state.Current = this->task.handle;
+		}
+	}
+
+	TaskProcess::~TaskProcess()
+	{
+		StopWaitingForEvent();
+	}
+
+	void TaskProcess::OnUpdate(const unsigned long deltaMs)
+	{
+		if (task.IsDone())
+		{
+			Succeed();
+			return;
+		}
+
+		if (!IsReady(deltaMs)) { return; }
+
+		StopWaitingForEvent();
+		state.Wait = TaskWaitState::Reason::None;
+		state.Current.resume();
+
+		if (task.IsDone())
+		{
+			if (task.handle.promise().Error) { Fail(); }
+			else { Succeed(); }
+			return;
+		}
+
+		// Subscribed only now, as nothing is dispatched while the task runs
+		if (state.Wait == TaskWaitState::Reason::Event)
+		{
+			eventSubscription = EventManager::Get()->SubscribeToEvent(*state.WaitEventId, this);
+		}
+	}
+
+	bool TaskProcess::IsReady(const unsigned long deltaMs)
+	{
+		switch (state.Wait)
+		{
+			case TaskWaitState::Reason::None:
+			case TaskWaitState::Reason::NextFrame:
+				return true;
+			case TaskWaitState::Reason::Delay:
+				if (state.RemainingMs <= deltaMs) { return true; }
+				state.RemainingMs -= deltaMs;
+				return false;
+			case TaskWaitState::Reason::Event:
+				return state.RaisedEvent != nullptr;
+		}
+		return false;
+	}
+
+	std::vector<std::shared_ptr<Event>> TaskProcess::HandleEvent(const std::shared_ptr<Event>& evt, unsigned long deltaMs)
+	{
+		// The first one wins if several are raised before the task resumes
+		if (state.Wait == TaskWaitState::Reason::Event && !state.RaisedEvent && evt->Id == *state.WaitEventId)
+		{
+			state.RaisedEvent = evt;
+		}
+		return {};
+	}
+
+	void TaskProcess::StopWaitingForEvent()
+	{
+		if (!eventSubscription.IsValid()) { return; }
+
+		EventManager::Get()->Unsubscribe(eventSubscription);
+		eventSubscription = {};
+	}
+}
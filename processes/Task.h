@@ -0,0 +1,190 @@
+#pragma once
+#ifndef TASK_H
+#define TASK_H
+
+#include <array>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <events/EventId.h>
+#include <events/EventManager.h>
+#include <events/EventPool.h>
+#include <events/EventSubscriber.h>
+#include <processes/Process.h>
+
+namespace gamelib
+{
+	class Event;
+
+	/// <summary>
+	/// Recycles coroutine frames by size class, so starting a task doesn't touch the heap once a frame of its size has been freed.
+	/// Frames bigger than MaxPooledSize go straight to the heap.
+	/// </summary>
+	class TaskFramePool
+	{
+	public:
+		static TaskFramePool* Get()
+		{
+			// Never destroyed: frames may be freed during static destruction
+			static auto* instance = new TaskFramePool();
+			return instance;
+		}
+
+		TaskFramePool(const TaskFramePool& other) = delete;
+		TaskFramePool& operator=(const TaskFramePool& other) = delete;
+
+		void* Allocate(size_t size);
+		void Release(void* frame, size_t size);
+
+		// Summed over all size classes
+		[[nodiscard]] EventPoolStatistics GetStatistics();
+		void ResetStatistics();
+
+		static constexpr size_t Granularity = 64;
+		static constexpr size_t MaxPooledSize = 4096;
+
+	private:
+		TaskFramePool() = default;
+		std::array<EventBlockPool, MaxPooledSize / Granularity> sizeClasses;
+	};
+
+	// What a suspended task is waiting for. Shared by a task and the tasks it awaits, and read by the TaskProcess running them
+	struct TaskWaitState
+	{
+		enum class Reason : std::uint8_t { None, NextFrame, Delay, Event };
+
+		Reason Wait = Reason::None;
+		unsigned long RemainingMs = 0;
+		std::optional<EventId> WaitEventId;
+		std::shared_ptr<Event> RaisedEvent;
+
+		// Innermost suspended task, resumed when the wait is over
+		std::coroutine_handle<> Current;
+	};
+
+	/// <summary>
+	/// Coroutine that runs as a process: return Task from a function using co_await and start it with ProcessManager::StartTask().
+	/// A task can co_await Delay(), NextFrame(), EventRaised() or another Task, which then runs to completion within it.
+	/// Tasks start on the process manager's next update and are resumed on the thread calling UpdateProcesses().
+	/// An exception escaping the task fails its process.
+	/// </summary>
+	class Task
+	{
+	public:
+		struct promise_type;
+		using Handle = std::coroutine_handle<promise_type>;
+
+		struct FinalAwaiter
+		{
+			[[nodiscard]] bool await_ready() const noexcept { return false; }
+
+			// Carries on with the awaiting task, if any
+			std::coroutine_handle<> await_suspend(const Handle finished) noexcept
+			{
+				const auto continuation = finished.promise().Continuation;
+				return continuation ? continuation : std::noop_coroutine();
+			}
+			void await_resume() const noexcept {}
+		};
+
+		struct promise_type
+		{
+			TaskWaitState* State = nullptr;
+			std::coroutine_handle<> Continuation;
+			std::exception_ptr Error;
+
+			Task get_return_object() { return Task(Handle::from_promise(*this)); }
+			std::suspend_always initial_suspend() const noexcept { return {}; }
+			FinalAwaiter final_suspend() const noexcept { return {}; }
+			void return_void() const noexcept {}
+			void unhandled_exception() { Error = std::current_exception(); }
+
+			static void* operator new(const size_t size) { return TaskFramePool::Get()->Allocate(size); }
+			static void operator delete(void* frame, const size_t size) { TaskFramePool::Get()->Release(frame, size); }
+		};
+
+		Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+		Task& operator=(Task&& other) noexcept;
+		Task(const Task& other) = delete;
+		Task& operator=(const Task& other) = delete;
+		~Task() { if (handle) { handle.destroy(); } }
+
+		[[nodiscard]] bool IsDone() const { return !handle || handle.done(); }
+
+		// Awaiting a task runs it within the awaiting one
+		[[nodiscard]] bool await_ready() const noexcept { return IsDone(); }
+		std::coroutine_handle<> await_suspend(Handle awaiting) noexcept;
+		void await_resume() const;
+
+	private:
+		friend class TaskProcess;
+		explicit Task(const Handle handle) : handle(handle) {}
+		Handle handle;
+	};
+
+	// co_await Delay(ms): resumes once ms of game time has passed. Delay(0) resumes on the next update
+	struct Delay
+	{
+		explicit Delay(const unsigned long ms) : Ms(ms) {}
+		[[nodiscard]] bool await_ready() const noexcept { return false; }
+		void await_suspend(Task::Handle awaiting) const noexcept;
+		void await_resume() const noexcept {}
+
+		unsigned long Ms;
+	};
+
+	// co_await NextFrame(): resumes on the next update
+	struct NextFrame
+	{
+		[[nodiscard]] bool await_ready() const noexcept { return false; }
+		void await_suspend(Task::Handle awaiting) const noexcept;
+		void await_resume() const noexcept {}
+	};
+
+	// co_await EventRaised(id): resumes on the update after an event of that id is dispatched, returning the event
+	struct EventRaised
+	{
+		explicit EventRaised(const EventId& eventId) : Id(eventId) {}
+		[[nodiscard]] bool await_ready() const noexcept { return false; }
+		void await_suspend(Task::Handle awaiting) noexcept;
+		std::shared_ptr<Event> await_resume() const;
+
+		EventId Id;
+		TaskWaitState* State = nullptr;
+	};
+
+	/// <summary>
+	/// Process driving a Task. Waiting for an event subscribes to it on the global EventManager only until it arrives.
+	/// </summary>
+	class TaskProcess final : public Process, public EventSubscriber
+	{
+	public:
+		// Allocated from a pool, like the task's frame
+		static std::shared_ptr<TaskProcess> Create(Task task);
+
+		explicit TaskProcess(Task task);
+		~TaskProcess() override;
+
+		// Exception that escaped the task, if it failed
+		[[nodiscard]] std::exception_ptr GetError() const { return task.handle.promise().Error; }
+
+		std::vector<std::shared_ptr<Event>> HandleEvent(const std::shared_ptr<Event>& evt, unsigned long deltaMs) override;
+		std::string GetSubscriberName() override { return "Task"; }
+
+	protected:
+		void OnUpdate(unsigned long deltaMs) override;
+
+	private:
+		bool IsReady(unsigned long deltaMs);
+		void StopWaitingForEvent();
+
+		Task task;
+		TaskWaitState state;
+		SubscriptionHandle eventSubscription;
+	};
+}
+
+#endif
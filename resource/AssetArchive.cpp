@@ -0,0 +1,186 @@
+#include "AssetArchive.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include "exceptions/EngineException.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gamelib
+{
+	namespace
+	{
+		uint64_t AlignUp(const uint64_t offset) { return (offset + AssetArchive::Alignment - 1) / AssetArchive::Alignment * AssetArchive::Alignment; }
+	}
+
+	AssetArchive::AssetArchive(const std::string& filePath) : filePath(filePath)
+	{
+		Map();
+
+		const auto throwInvalid = [&](const std::string& reason)
+		{
+			Unmap();
+			THROW(static_cast<int>(ErrorNumbers::InvalidArchive), "Invalid asset archive '" + filePath + "': " + reason, "AssetArchive");
+		};
+
+		if (size < sizeof(AssetArchiveHeader)) { throwInvalid("too small"); }
+
+		AssetArchiveHeader header {};
+		std::memcpy(&header, data, sizeof header);
+		if (std::memcmp(header.Magic, Magic, sizeof Magic) != 0) { throwInvalid("not an asset archive"); }
+		if (header.Version != Version) { throwInvalid("unsupported version " + std::to_string(header.Version)); }
+		if (header.EntryCount > (size - sizeof header) / sizeof(AssetArchiveEntry)) { throwInvalid("index is truncated"); }
+
+		// Entries are 8-byte aligned as the header is 16 bytes and the mapping page aligned
+		entries = { reinterpret_cast<const AssetArchiveEntry*>(data + sizeof header), header.EntryCount };
+		for (const auto& entry : entries)
+		{
+			if (entry.Offset > size || entry.Size > size - entry.Offset) { throwInvalid("asset " + std::to_string(entry.Uid) + " is out of bounds"); }
+		}
+	}
+
+	AssetArchive::~AssetArchive()
+	{
+		Unmap();
+	}
+
+	const AssetArchiveEntry* AssetArchive::Find(const int uid) const
+	{
+		const auto entry = std::ranges::lower_bound(entries, static_cast<uint32_t>(uid), {}, &AssetArchiveEntry::Uid);
+		return entry != entries.end() && entry->Uid == static_cast<uint32_t>(uid) ? &*entry : nullptr;
+	}
+
+	const AssetArchiveEntry* AssetArchive::Find(const std::string& name) const
+	{
+		const auto hash = HashName(name);
+		const auto entry = std::ranges::find(entries, hash, &AssetArchiveEntry::NameHash);
+		return entry != entries.end() ? &*entry : nullptr;
+	}
+
+	std::span<const std::byte> AssetArchive::GetData(const AssetArchiveEntry& entry) const
+	{
+		return { data + entry.Offset, static_cast<size_t>(entry.Size) };
+	}
+
+	uint32_t AssetArchive::HashName(const std::string& name)
+	{
+		uint32_t hash = 2166136261u;
+		for (const auto character : name)
+		{
+			hash ^= static_cast<uint8_t>(character);
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	void AssetArchive::Pack(const std::string& archivePath, std::vector<Source> sources)
+	{
+		std::ranges::sort(sources, {}, &Source::Uid);
+		if (const auto duplicate = std::ranges::adjacent_find(sources, {}, &Source::Uid); duplicate != sources.end())
+		{
+			THROW(static_cast<int>(ErrorNumbers::DuplicateUid), "Asset uid " + std::to_string(duplicate->Uid) + " is packed twice", "AssetArchive");
+		}
+
+		std::vector<std::vector<char>> files;
+		std::vector<AssetArchiveEntry> index;
+		auto offset = AlignUp(sizeof(AssetArchiveHeader) + sources.size() * sizeof(AssetArchiveEntry));
+		for (const auto& source : sources)
+		{
+			std::ifstream file(source.FilePath, std::ios::binary);
+			if (!file)
+			{
+				THROW(static_cast<int>(ErrorNumbers::FailedToRead), "Could not read asset file '" + source.FilePath + "'", "AssetArchive");
+			}
+
+			auto& contents = files.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+			index.push_back({ static_cast<uint32_t>(source.Uid), HashName(source.Name), offset, contents.size(), static_cast<uint32_t>(source.Type), 0 });
+			offset = AlignUp(offset + contents.size());
+		}
+
+		std::ofstream archive(archivePath, std::ios::binary | std::ios::trunc);
+		if (!archive)
+		{
+			THROW(static_cast<int>(ErrorNumbers::FailedToOpen), "Could not create asset archive '" + archivePath + "'", "AssetArchive");
+		}
+
+		AssetArchiveHeader header {};
+		std::memcpy(header.Magic, Magic, sizeof Magic);
+		header.Version = Version;
+		header.EntryCount = static_cast<uint32_t>(index.size());
+		archive.write(reinterpret_cast<const char*>(&header), sizeof header);
+		archive.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(AssetArchiveEntry)));
+
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			// Pad up to the file's offset
+			const std::vector<char> padding(index[i].Offset - static_cast<uint64_t>(archive.tellp()), 0);
+			archive.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+			archive.write(files[i].data(), static_cast<std::streamsize>(files[i].size()));
+		}
+
+		if (!archive)
+		{
+			THROW(static_cast<int>(ErrorNumbers::FailedToOpen), "Could not write asset archive '" + archivePath + "'", "AssetArchive");
+		}
+	}
+
+	void AssetArchive::Map()
+	{
+		const auto throwFailed = [&]
+		{
+			THROW(static_cast<int>(ErrorNumbers::FailedToOpen), "Could not map asset archive '" + filePath + "'", "AssetArchive");
+		};
+
+#if defined(_WIN32)
+		file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) { file = nullptr; throwFailed(); }
+
+		LARGE_INTEGER fileSize {};
+		GetFileSizeEx(file, &fileSize);
+		size = static_cast<size_t>(fileSize.QuadPart);
+		if (size == 0) { return; }
+
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping) { data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)); }
+		if (!data) { Unmap(); throwFailed(); }
+#else
+		const auto descriptor = open(filePath.c_str(), O_RDONLY);
+		if (descriptor < 0) { throwFailed(); }
+
+		struct stat status {};
+		if (fstat(descriptor, &status) != 0) { close(descriptor); throwFailed(); }
+		size = static_cast<size_t>(status.st_size);
+		if (size == 0) { close(descriptor); return; }
+
+		// The mapping outlives the descriptor
+		auto* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		close(descriptor);
+		if (mapped == MAP_FAILED) { size = 0; throwFailed(); }
+		data = static_cast<const std::byte*>(mapped);
+#endif
+	}
+
+	void AssetArchive::Unmap()
+	{
+#if defined(_WIN32)
+		if (data) { UnmapViewOfFile(data); }
+		if (mapping) { CloseHandle(mapping); }
+		if (file) { CloseHandle(file); }
+		mapping = file = nullptr;
+#else
+		if (data) { munmap(const_cast<std::byte*>(data), size); }
+#endif
+		data = nullptr;
+		size = 0;
+		entries = {};
+	}
+}
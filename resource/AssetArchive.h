@@ -0,0 +1,99 @@
+#pragma once
+#ifndef ASSETARCHIVE_H
+#define ASSETARCHIVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include "asset/asset.h"
+
+namespace gamelib
+{
+	// Start of an archive file
+	struct AssetArchiveHeader
+	{
+		char Magic[4];
+		uint32_t Version;
+		uint32_t EntryCount;
+		uint32_t Reserved;
+	};
+
+	// Where one asset's file is in the archive. Entries follow the header, sorted by uid
+	struct AssetArchiveEntry
+	{
+		uint32_t Uid;
+		uint32_t NameHash;
+		uint64_t Offset;
+		uint64_t Size;
+		uint32_t Type;
+		uint32_t Reserved;
+	};
+
+	static_assert(sizeof(AssetArchiveHeader) == 16 && sizeof(AssetArchiveEntry) == 32, "Archive layout must not change");
+
+	/// <summary>
+	/// Many asset files packed into one, see Pack() and the AssetPacker tool. The archive is memory-mapped and asset
+	/// data is read in place, so its spans stay valid for as long as the archive is open.
+	/// Layout, in the platform's (little-endian) byte order: header, index entries, then each file, 16-byte aligned
+	/// </summary>
+	class AssetArchive
+	{
+	public:
+		static constexpr char Magic[4] = { 'G', 'L', 'P', 'K' };
+		static constexpr uint32_t Version = 1;
+		static constexpr uint64_t Alignment = 16;
+
+		explicit AssetArchive(const std::string& filePath);
+		~AssetArchive();
+
+		AssetArchive(const AssetArchive& other) = delete;
+		AssetArchive& operator=(const AssetArchive& other) = delete;
+
+		[[nodiscard]] const AssetArchiveEntry* Find(int uid) const;
+		[[nodiscard]] const AssetArchiveEntry* Find(const std::string& name) const;
+		[[nodiscard]] std::span<const std::byte> GetData(const AssetArchiveEntry& entry) const;
+		[[nodiscard]] std::span<const AssetArchiveEntry> GetEntries() const { return entries; }
+		[[nodiscard]] const std::string& GetFilePath() const { return filePath; }
+
+		// FNV-1a
+		static uint32_t HashName(const std::string& name);
+
+		// An asset file to pack
+		struct Source
+		{
+			int Uid;
+			std::string Name;
+			enum Asset::AssetType Type;
+			std::string FilePath;
+		};
+
+		// Writes an archive of the sources' files
+		static void Pack(const std::string& archivePath, std::vector<Source> sources);
+
+		enum class ErrorNumbers
+		{
+			FailedToOpen,
+			InvalidArchive,
+			FailedToRead,
+			DuplicateUid
+		};
+
+	private:
+		void Map();
+		void Unmap();
+
+		const std::string filePath;
+		const std::byte* data = nullptr;
+		size_t size = 0;
+		std::span<const AssetArchiveEntry> entries;
+
+#if defined(_WIN32)
+		void* file = nullptr;
+		void* mapping = nullptr;
+#endif
+	};
+}
+
+#endif
@@ -0,0 +1,173 @@
+#include "AssetLoader.h"
+#include "asset/asset.h"
+#include "exceptions/EngineException.h"
+
+namespace gamelib
+{
+	AssetLoadHandle::AssetLoadHandle(const int sceneId, const unsigned int total)
+		: sceneId(sceneId), total(total), future(promise.get_future().share())
+	{
+		if (total == 0) { promise.set_value(GetProgress()); }
+	}
+
+	AssetLoadProgress AssetLoadHandle::GetProgress() const
+	{
+		return { total, loaded.load(), failed.load(), cancelled.load() };
+	}
+
+	bool AssetLoadHandle::AssetDone(const bool failed)
+	{
+		if (cancelled) { return false; }
+
+		(failed ? this->failed : loaded)++;
+		if (const auto progress = GetProgress(); progress.IsComplete())
+		{
+			promise.set_value(progress);
+			return true;
+		}
+		return false;
+	}
+
+	void AssetLoadHandle::Cancel()
+	{
+		if (cancelled || GetProgress().IsComplete()) { return; }
+
+		cancelled = true;
+		promise.set_value(GetProgress());
+	}
+
+	AssetLoader::AssetLoader(const size_t threadCount)
+	{
+		if (threadCount == 0)
+		{
+			THROW(1, "An asset loader needs at least one thread", "AssetLoader");
+		}
+
+		workers.reserve(threadCount);
+		for (size_t i = 0; i < threadCount; i++)
+		{
+			workers.emplace_back([this] { WorkerLoop(); });
+		}
+	}
+
+	AssetLoader::~AssetLoader()
+	{
+		{
+			std::lock_guard lock(mutex);
+			stopping = true;
+		}
+		submitted.notify_all();
+
+		for (auto& worker : workers) { worker.join(); }
+	}
+
+	void AssetLoader::Submit(std::shared_ptr<Asset> asset)
+	{
+		{
+			std::lock_guard lock(mutex);
+			toDecode.push_back(std::move(asset));
+			pending++;
+		}
+		submitted.notify_one();
+	}
+
+	bool AssetLoader::TryTakeDecoded(DecodedAsset& decodedAsset)
+	{
+		std::lock_guard lock(mutex);
+		if (decoded.empty()) { return false; }
+
+		decodedAsset = std::move(decoded.front());
+		decoded.pop_front();
+		pending--;
+		return true;
+	}
+
+	size_t AssetLoader::GetPendingCount() const
+	{
+		std::lock_guard lock(mutex);
+		return pending;
+	}
+
+	void AssetLoader::WorkerLoop()
+	{
+		while (true)
+		{
+			std::shared_ptr<Asset> asset;
+			{
+				std::unique_lock lock(mutex);
+				submitted.wait(lock, [this] { return stopping || !toDecode.empty(); });
+				if (stopping) { return; }
+
+				asset = std::move(toDecode.front());
+				toDecode.pop_front();
+			}
+
+			DecodedAsset result { asset, nullptr };
+			try
+			{
+				asset->Decode();
+			}
+			catch (...)
+			{
+				result.Error = std::current_exception();
+			}
+
+			std::lock_guard lock(mutex);
+			decoded.push_back(std::move(result));
+		}
+	}
+
+	void AssetUploadQueue::Add(std::shared_ptr<Asset> asset)
+	{
+		std::lock_guard lock(mutex);
+		toUpload.push_back(std::move(asset));
+	}
+
+	size_t AssetUploadQueue::Upload(const size_t maxUploads)
+	{
+		size_t uploads = 0;
+		while (uploads < maxUploads)
+		{
+			std::shared_ptr<Asset> asset;
+			{
+				std::lock_guard lock(mutex);
+				if (toUpload.empty()) { break; }
+
+				asset = std::move(toUpload.front());
+				toUpload.pop_front();
+			}
+
+			DecodedAsset result { asset, nullptr };
+			try
+			{
+				asset->Upload();
+			}
+			catch (...)
+			{
+				result.Error = std::current_exception();
+			}
+
+			std::lock_guard lock(mutex);
+			uploaded.push_back(std::move(result));
+			uploads++;
+		}
+		return uploads;
+	}
+
+	bool AssetUploadQueue::TryTakeUploaded(DecodedAsset& uploadedAsset)
+	{
+		std::lock_guard lock(mutex);
+		if (uploaded.empty()) { return false; }
+
+		uploadedAsset = std::move(uploaded.front());
+		uploaded.pop_front();
+		return true;
+	}
+
+	void AssetUploadQueue::Clear()
+	{
+		std::lock_guard lock(mutex);
+		toUpload.clear();
+		uploaded.clear();
+	}
+}
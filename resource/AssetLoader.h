@@ -0,0 +1,135 @@
+#pragma once
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gamelib
+{
+	class Asset;
+
+	// How far a background load has got, e.g. to draw a loading bar
+	struct AssetLoadProgress
+	{
+		unsigned int Total = 0;
+		unsigned int Loaded = 0;
+		unsigned int Failed = 0;
+
+		// Superseded, e.g. by a change of scene, before it completed
+		bool Cancelled = false;
+
+		// 0 to 1, counting failed assets as done
+		[[nodiscard]] float GetFraction() const { return Total == 0 ? 1.0f : static_cast<float>(Loaded + Failed) / static_cast<float>(Total); }
+		[[nodiscard]] bool IsComplete() const { return Loaded + Failed >= Total; }
+	};
+
+	/// <summary>
+	/// Tracks the assets of one scene loading in the background, see ResourceManager::LoadSceneAssetsAsync().
+	/// Progress may be read from any thread; the future is ready once every asset has loaded or failed to, or the load
+	/// was cancelled.
+	/// </summary>
+	class AssetLoadHandle
+	{
+	public:
+		AssetLoadHandle(int sceneId, unsigned int total);
+
+		[[nodiscard]] int GetSceneId() const { return sceneId; }
+		[[nodiscard]] AssetLoadProgress GetProgress() const;
+		[[nodiscard]] bool IsReady() const { return !cancelled && GetProgress().IsComplete(); }
+		[[nodiscard]] bool IsCancelled() const { return cancelled; }
+		[[nodiscard]] std::shared_future<AssetLoadProgress> GetFuture() const { return future; }
+
+		// Counts an asset as finished. Returns true when it was the last one of a load not cancelled
+		bool AssetDone(bool failed);
+
+		// Stops counting and sets the future with the progress so far, unless already complete
+		void Cancel();
+
+	private:
+		const int sceneId;
+		const unsigned int total;
+		std::atomic<unsigned int> loaded = 0;
+		std::atomic<unsigned int> failed = 0;
+		std::atomic<bool> cancelled = false;
+		std::promise<AssetLoadProgress> promise;
+		std::shared_future<AssetLoadProgress> future;
+	};
+
+	// An asset whose Decode() has run, or thrown
+	struct DecodedAsset
+	{
+		std::shared_ptr<Asset> Target;
+		std::exception_ptr Error;
+	};
+
+	/// <summary>
+	/// Worker threads that run Asset::Decode(), i.e. file reads and decoding, away from the game loop.
+	/// Decoded assets are queued for the game loop thread to take and Upload(), as textures can only be created there.
+	/// Assets still waiting when the loader is destroyed are dropped.
+	/// </summary>
+	class AssetLoader
+	{
+	public:
+		explicit AssetLoader(size_t threadCount = 1);
+		~AssetLoader();
+
+		AssetLoader(const AssetLoader& other) = delete;
+		AssetLoader& operator=(const AssetLoader& other) = delete;
+
+		void Submit(std::shared_ptr<Asset> asset);
+
+		// Takes the next decoded asset, if there is one, without waiting
+		bool TryTakeDecoded(DecodedAsset& decoded);
+
+		// Submitted assets not yet taken
+		[[nodiscard]] size_t GetPendingCount() const;
+		[[nodiscard]] size_t GetThreadCount() const { return workers.size(); }
+
+	private:
+		void WorkerLoop();
+
+		mutable std::mutex mutex;
+		std::condition_variable submitted;
+		std::deque<std::shared_ptr<Asset>> toDecode;
+		std::deque<DecodedAsset> decoded;
+		size_t pending = 0;
+		bool stopping = false;
+		std::vector<std::thread> workers;
+	};
+
+	/// <summary>
+	/// Hands decoded assets to the thread that may create textures, e.g. a PipelinedGameLoop's render thread, to
+	/// Upload(), and the results back. Add() and TryTakeUploaded() are for the game loop thread
+	/// </summary>
+	class AssetUploadQueue
+	{
+	public:
+		void Add(std::shared_ptr<Asset> asset);
+
+		// Uploads up to maxUploads waiting assets on the calling thread
+		/// <returns>Number of assets uploaded</returns>
+		size_t Upload(size_t maxUploads = SIZE_MAX);
+
+		// Takes the next uploaded asset, with what Upload() threw if it failed, without waiting
+		bool TryTakeUploaded(DecodedAsset& uploadedAsset);
+
+		void Clear();
+
+	private:
+		mutable std::mutex mutex;
+		std::deque<std::shared_ptr<Asset>> toUpload;
+		std::deque<DecodedAsset> uploaded;
+	};
+}
+
+#endif
@@ -0,0 +1,92 @@
+#include "AssetResidency.h"
+
+namespace gamelib
+{
+	void AssetResidency::SetBudget(const size_t budgetBytes)
+	{
+		std::lock_guard lock(mutex);
+		this->budgetBytes = budgetBytes;
+	}
+
+	size_t AssetResidency::GetBudget() const
+	{
+		std::lock_guard lock(mutex);
+		return budgetBytes;
+	}
+
+	void AssetResidency::Add(const int uid, const size_t sizeBytes)
+	{
+		std::lock_guard lock(mutex);
+		if (const auto existing = entries.find(uid); existing != entries.end())
+		{
+			residentBytes -= existing->second.SizeBytes;
+			recency.erase(existing->second.Position);
+		}
+
+		entries[uid] = { recency.insert(recency.end(), uid), sizeBytes };
+		residentBytes += sizeBytes;
+	}
+
+	void AssetResidency::Remove(const int uid)
+	{
+		std::lock_guard lock(mutex);
+		if (const auto entry = entries.find(uid); entry != entries.end())
+		{
+			residentBytes -= entry->second.SizeBytes;
+			recency.erase(entry->second.Position);
+			entries.erase(entry);
+		}
+	}
+
+	void AssetResidency::Clear()
+	{
+		std::lock_guard lock(mutex);
+		entries.clear();
+		recency.clear();
+		residentBytes = 0;
+	}
+
+	void AssetResidency::Touch(const int uid)
+	{
+		std::lock_guard lock(mutex);
+		if (const auto entry = entries.find(uid); entry != entries.end())
+		{
+			recency.splice(recency.end(), recency, entry->second.Position);
+		}
+	}
+
+	bool AssetResidency::IsResident(const int uid) const
+	{
+		std::lock_guard lock(mutex);
+		return entries.contains(uid);
+	}
+
+	size_t AssetResidency::GetResidentBytes() const
+	{
+		std::lock_guard lock(mutex);
+		return residentBytes;
+	}
+
+	size_t AssetResidency::GetResidentCount() const
+	{
+		std::lock_guard lock(mutex);
+		return entries.size();
+	}
+
+	std::vector<int> AssetResidency::SelectEvictions(const std::function<bool(int uid)>& keep) const
+	{
+		std::lock_guard lock(mutex);
+		std::vector<int> evictions;
+		if (budgetBytes == 0) { return evictions; }
+
+		auto bytes = residentBytes;
+		for (auto uid = recency.begin(); uid != recency.end() && bytes > budgetBytes; ++uid)
+		{
+			if (keep(*uid)) { continue; }
+
+			evictions.push_back(*uid);
+			bytes -= entries.at(*uid).SizeBytes;
+		}
+		return evictions;
+	}
+}
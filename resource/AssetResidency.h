@@ -0,0 +1,63 @@
+#pragma once
+#ifndef ASSETRESIDENCY_H
+#define ASSETRESIDENCY_H
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace gamelib
+{
+	/// <summary>
+	/// Tracks which assets are loaded, their sizes, and the order they were last used in, against a memory budget.
+	/// It only keeps the books: ResourceManager decides what to load and unloads what SelectEvictions() picks.
+	/// Assets may be touched from any thread.
+	/// </summary>
+	class AssetResidency
+	{
+	public:
+		// budgetBytes of 0 is no budget
+		explicit AssetResidency(size_t budgetBytes = 0) : budgetBytes(budgetBytes) { }
+
+		void SetBudget(size_t budgetBytes);
+		[[nodiscard]] size_t GetBudget() const;
+
+		// A loaded asset becomes the most recently used. Adding it again updates its size
+		void Add(int uid, size_t sizeBytes);
+		void Remove(int uid);
+		void Clear();
+
+		// Marks a loaded asset as just used
+		void Touch(int uid);
+
+		[[nodiscard]] bool IsResident(int uid) const;
+		[[nodiscard]] size_t GetResidentBytes() const;
+		[[nodiscard]] size_t GetResidentCount() const;
+
+		/// <summary>
+		/// Assets to unload to get back within budget, least recently used first. Assets for which keep() is true are
+		/// passed over, so the result may still leave the budget exceeded
+		/// </summary>
+		[[nodiscard]] std::vector<int> SelectEvictions(const std::function<bool(int uid)>& keep) const;
+
+	private:
+		struct Entry
+		{
+			std::list<int>::iterator Position;
+			size_t SizeBytes;
+		};
+
+		mutable std::mutex mutex;
+		size_t budgetBytes;
+		size_t residentBytes = 0;
+
+		// Least recently used at the front
+		std::list<int> recency;
+		std::unordered_map<int, Entry> entries;
+	};
+}
+
+#endif
@@ -1,10 +1,15 @@
 #include "ResourceManager.h"
 #include <tinyxml2.h>
+#include "AssetArchive.h"
+#include "AssetLoader.h"
+#include <algorithm>
 #include <map>
 #include <memory>
+#include <thread>
 #include "audio/AudioManager.h"
 #include "common/Common.h"
 #include "events/EventManager.h"
+#include "events/SceneAssetsReadyEvent.h"
 #include "events/SceneChangedEvent.h"
 #include "font/FontManager.h"
 #include <exceptions/EngineException.h>
@@ -17,7 +22,7 @@ namespace gamelib
 	using namespace tinyxml2;
 	using namespace std;
 
-	ResourceManager::ResourceManager(): debug(false) {  }
+	ResourceManager::ResourceManager(): debug(false), uploadQueue(make_unique<AssetUploadQueue>()) {  }
 	ResourceManager::~ResourceManager() { instance = nullptr; }
 
 	/// <summary>
@@ -40,11 +45,14 @@ namespace gamelib
 
 	vector<shared_ptr<Event>> ResourceManager::HandleEvent(const std::shared_ptr<Event>& event, const unsigned long deltaMs)
 	{
-		if (event->Id.PrimaryId == SceneChangedEventTypeEventId.PrimaryId)
+		if (event->Id.GetPrimaryId() == SceneChangedEventTypeEventId.GetPrimaryId())
 		{
 			LogThis("ResourceManager: Detected level change. Loading level assets...", debug, [&]()
 			{
-				LoadSceneAssets(dynamic_pointer_cast<SceneChangedEvent>(event)->SceneId);
+				const auto sceneId = dynamic_pointer_cast<SceneChangedEvent>(event)->SceneId;
+				// Loading in place would upload off the thread that owns the renderer
+				if (IsAsyncLoading() || renderThreadUploads) { LoadSceneAssetsAsync(sceneId); }
+				else { LoadSceneAssets(sceneId); }
 				return true;
 			}, true, true);
 		}
@@ -55,58 +63,319 @@ namespace gamelib
 	/// <summary>
 	/// Load all the resources required by the scene and unload out all those that are not in the scene.
 	/// </summary>
-	/// <remarks>Other scene assets are unloaded</remarks>
+	/// <remarks>Other scene assets are unloaded, unless hinted or kept by the memory budget</remarks>
 	/// <param name="level">Scene/Level assets to load.</param>
 	void ResourceManager::LoadSceneAssets(const int level)
 	{
+		currentScene = level;
+		CancelSupersededLoads();
+
+		// Assets already loading in the background, e.g. prefetched, are finished rather than loaded twice
+		WaitForLoads(level);
+		UnloadOtherSceneAssets(level);
+
 		for (const auto& kv : resourcesByScene) // we need access to all resources to swap in/out resources
 		{
 			const auto& val = kv.second;
 			for (const auto& asset : val)
 			{
-				const auto alwaysLoadResource = asset->SceneId == 0;
-				if ((asset->SceneId == level || alwaysLoadResource) && !asset->IsLoadedInMemory)
+				if (IsSkipped(*asset) || !IsInScene(*asset, level)) { continue; }
+
+				if (asset->IsLoadedInMemory)
 				{
-					asset->Load();
+					residency.Touch(asset->Uid);
+					continue;
+				}
 
-					std::stringstream message;
+				asset->Load();
+				residency.Add(asset->Uid, asset->GetSizeBytes());
 
-					message << "LoadSceneAssets: Scene "
-					<< to_string(asset->SceneId)
-					<< ": "
-					<< string(asset->Name)
-					<< " asset loaded.";
+				std::stringstream message;
 
-					Logger::Get()->LogThis(message.str());
+				message << "LoadSceneAssets: Scene "
+				<< to_string(asset->SceneId)
+				<< ": "
+				<< string(asset->Name)
+				<< " asset loaded.";
 
-					countLoadedResources++;
-					countUnloadedResources--;
-				}
-				else if (asset->IsLoadedInMemory && asset->SceneId != level && !alwaysLoadResource)
-				{
-					asset->Unload();
+				Logger::Get()->LogThis(message.str());
 
-					std::stringstream message;
+				countLoadedResources++;
+				countUnloadedResources--;
+			}
+		}
 
-					message <<
-					"LoadSceneAssets: Scene "
-					<< to_string(asset->SceneId)
-					<<  string(asset->Name)
-					<< " asset unloaded.";
+		EnforceBudget();
+	}
+
+	/// <summary>
+	/// Unload the assets of scenes other than the given one. Assets of scene 0 and hinted scenes are kept, and with a
+	/// memory budget it is left to EnforceBudget()
+	/// </summary>
+	void ResourceManager::UnloadOtherSceneAssets(const int level)
+	{
+		if (residency.GetBudget() > 0) { return; }
 
-					Logger::Get()->LogThis(message.str());
+		for (const auto& kv : resourcesByScene)
+		{
+			for (const auto& asset : kv.second)
+			{
+				// Assets still loading are left to FinishLoad(), which doesn't keep them unless wanted
+				if (IsSkipped(*asset) || hintedScenes.contains(asset->SceneId) || loadingAssets.contains(asset->Uid)) { continue; }
 
-					countUnloadedResources++;
-					countLoadedResources--;
+				if (asset->IsLoadedInMemory && !IsInScene(*asset, level))
+				{
+					UnloadAsset(*asset);
 				}
 			}
 		}
 	}
 
+	void ResourceManager::UnloadAsset(Asset& asset)
+	{
+		asset.Unload();
+		residency.Remove(asset.Uid);
+
+		std::stringstream message;
+
+		message <<
+		"LoadSceneAssets: Scene "
+		<< to_string(asset.SceneId)
+		<<  string(asset.Name)
+		<< " asset unloaded.";
+
+		Logger::Get()->LogThis(message.str());
+
+		countUnloadedResources++;
+		countLoadedResources--;
+	}
+
+	void ResourceManager::EnforceBudget()
+	{
+		const auto evictions = residency.SelectEvictions([&](const int uid)
+		{
+			const auto asset = resourcesById.find(uid);
+			return asset == resourcesById.end() || IsInScene(*asset->second, currentScene);
+		});
+
+		for (const auto uid : evictions)
+		{
+			UnloadAsset(*resourcesById.at(uid));
+		}
+	}
+
+	void ResourceManager::SetMemoryBudget(const size_t budgetBytes)
+	{
+		residency.SetBudget(budgetBytes);
+		EnforceBudget();
+	}
+
+	void ResourceManager::HintNextScenes(const std::vector<int>& scenes)
+	{
+		hintedScenes = { scenes.begin(), scenes.end() };
+		CancelSupersededLoads();
+
+		for (const auto scene : hintedScenes)
+		{
+			if (scene == currentScene) { continue; }
+
+			StartLoading(scene);
+		}
+	}
+
+	void ResourceManager::SetAsyncLoading(const size_t threadCount)
+	{
+		// Finish anything in flight so no asset is left half loaded
+		WaitForAllLoads();
+
+		// Started again with the new thread count when next needed
+		loaderThreads = threadCount;
+		loader = nullptr;
+	}
+
+	void ResourceManager::WaitForAllLoads()
+	{
+		while (loader && !loadingAssets.empty())
+		{
+			if (CompleteLoads() == 0) { this_thread::yield(); }
+		}
+	}
+
+	void ResourceManager::WaitForLoads(const int scene)
+	{
+		const auto isLoadingForScene = [&]
+		{
+			return ranges::any_of(loadingAssets, [&](const auto& loading)
+			{
+				return IsInScene(*resourcesById.at(loading.first), scene);
+			});
+		};
+
+		while (isLoadingForScene())
+		{
+			if (CompleteLoads() == 0) { this_thread::yield(); }
+		}
+	}
+
+	void ResourceManager::CancelSupersededLoads()
+	{
+		// The assets stay in flight, with no one waiting on them, until CompleteLoads() takes them
+		for (auto& [uid, waiting] : loadingAssets)
+		{
+			erase_if(waiting, [&](const shared_ptr<AssetLoadHandle>& handle)
+			{
+				const auto scene = handle->GetSceneId();
+				if (scene == currentScene || hintedScenes.contains(scene)) { return false; }
+
+				handle->Cancel();
+				return true;
+			});
+		}
+	}
+
+	bool ResourceManager::IsWanted(const Asset& asset) const
+	{
+		// With a budget other scenes' assets are kept until it runs out, as when changing scene
+		return residency.GetBudget() > 0 || IsInScene(asset, currentScene) || hintedScenes.contains(asset.SceneId);
+	}
+
+	shared_ptr<AssetLoadHandle> ResourceManager::LoadSceneAssetsAsync(const int scene)
+	{
+		currentScene = scene;
+		CancelSupersededLoads();
+		UnloadOtherSceneAssets(scene);
+		auto handle = StartLoading(scene);
+		EnforceBudget();
+		return handle;
+	}
+
+	shared_ptr<AssetLoadHandle> ResourceManager::StartLoading(const int scene)
+	{
+		vector<shared_ptr<Asset>> toLoad;
+		for (const auto& kv : resourcesByScene)
+		{
+			for (const auto& asset : kv.second)
+			{
+				if (IsSkipped(*asset) || !IsInScene(*asset, scene)) { continue; }
+
+				if (!loadingAssets.contains(asset->Uid) && asset->IsLoadedInMemory) { residency.Touch(asset->Uid); }
+				else { toLoad.push_back(asset); }
+			}
+		}
+
+		auto handle = make_shared<AssetLoadHandle>(scene, static_cast<unsigned int>(toLoad.size()));
+		if (toLoad.empty())
+		{
+			EventManager::Get()->RaiseEvent(make_shared<SceneAssetsReadyEvent>(scene, 0), this);
+			return handle;
+		}
+
+		if (!loader) { loader = make_unique<AssetLoader>(max<size_t>(loaderThreads, 1)); }
+
+		for (const auto& asset : toLoad)
+		{
+			// An asset already on its way, e.g. one shared with the previous scene, is only loaded once
+			const auto [waiting, isNew] = loadingAssets.try_emplace(asset->Uid);
+			if (isNew) { loader->Submit(asset); }
+			waiting->second.push_back(handle);
+		}
+
+		LogMessage("LoadSceneAssetsAsync: Scene " + to_string(scene) + ": loading " + to_string(toLoad.size()) + " assets.", debug);
+		return handle;
+	}
+
+	size_t ResourceManager::CompleteLoads(const size_t maxUploads)
+	{
+		size_t finished = 0;
+		DecodedAsset loaded;
+
+		// Those uploaded on the upload thread since the last call
+		while (uploadQueue->TryTakeUploaded(loaded))
+		{
+			FinishLoad(loaded);
+			finished++;
+		}
+
+		while (loader && finished < maxUploads && loader->TryTakeDecoded(loaded))
+		{
+			if (renderThreadUploads && !loaded.Error)
+			{
+				uploadQueue->Add(loaded.Target);
+				continue;
+			}
+
+			try
+			{
+				if (!loaded.Error) { loaded.Target->Upload(); }
+			}
+			catch (...)
+			{
+				loaded.Error = current_exception();
+			}
+
+			FinishLoad(loaded);
+			finished++;
+		}
+
+		if (finished > 0) { EnforceBudget(); }
+		return finished;
+	}
+
+	void ResourceManager::FinishLoad(const DecodedAsset& loaded)
+	{
+		const auto& asset = loaded.Target;
+		try
+		{
+			// A failed decode or upload is reported here, on the game loop thread
+			if (loaded.Error) { rethrow_exception(loaded.Error); }
+		}
+		catch (const std::exception& e)
+		{
+			Logger::Get()->LogThis("CompleteLoads: " + asset->Name + " failed to load: " + e.what());
+		}
+
+		auto waiting = loadingAssets.extract(asset->Uid);
+		if (!IsWanted(*asset))
+		{
+			// Its scene was changed away from while it loaded, so it isn't kept
+			if (asset->IsLoadedInMemory) { asset->Unload(); }
+			return;
+		}
+
+		const auto failed = !asset->IsLoadedInMemory;
+		if (!failed)
+		{
+			residency.Add(asset->Uid, asset->GetSizeBytes());
+			countLoadedResources++;
+			countUnloadedResources--;
+		}
+
+		if (!waiting) { return; }
+
+		for (const auto& handle : waiting.mapped())
+		{
+			if (handle->AssetDone(failed))
+			{
+				EventManager::Get()->RaiseEvent(make_shared<SceneAssetsReadyEvent>(handle->GetSceneId(), handle->GetProgress().Failed), this);
+			}
+		}
+	}
+
+	void ResourceManager::SetRenderThreadUploads(const bool isRenderThreadUploads)
+	{
+		renderThreadUploads = isRenderThreadUploads;
+		if (!renderThreadUploads) { UploadPending(); }
+	}
+
+	size_t ResourceManager::UploadPending(const size_t maxUploads)
+	{
+		return uploadQueue->Upload(maxUploads);
+	}
+
 	/// <summary>
 	/// Ask each asset to unload itself
 	/// </summary>
-	void ResourceManager::Unload() const
+	void ResourceManager::Unload()
 	{
 		LogThis("Unloading all resources...", debug, [&]()
 		{
@@ -114,11 +383,13 @@ namespace gamelib
 			{
 				auto& assetName = item.first;
 				auto& asset = item.second;
+				if (IsSkipped(*asset)) { continue; }
 
 				asset->Unload();
 
 				LogMessage("Unloaded asset '" + assetName + string("'."));
 			}
+			residency.Clear();
 			return true;
 		}, true, true);
 	}
@@ -287,12 +558,97 @@ namespace gamelib
 
 		// Index the asset by its id
 		resourcesById.insert(pair(asset->Uid, asset));
+
+		AttachPackedData(*asset);
+	}
+
+	void ResourceManager::AddAsset(const shared_ptr<Asset>& asset)
+	{
+		StoreAsset(asset);
+		countResources++;
+	}
+
+	void ResourceManager::MountArchive(const std::string& archivePath)
+	{
+		// Loads in flight may be decoding from the assets' files or packed data, which is about to change
+		WaitForAllLoads();
+		UnmountArchive();
+		archive = make_unique<AssetArchive>(archivePath);
+
+		// Loaded assets keep what they loaded from their files until they are next loaded
+		for (const auto& [uid, asset] : resourcesById) { AttachPackedData(*asset); }
+
+		LogMessage("Mounted asset archive '" + archivePath + "' with " + to_string(archive->GetEntries().size()) + " assets.");
+	}
+
+	void ResourceManager::UnmountArchive()
+	{
+		if (!archive) { return; }
+
+		// Music and fonts read from the archive for as long as they are loaded
+		for (const auto& [uid, asset] : resourcesById)
+		{
+			if (asset->PackedData.empty()) { continue; }
+
+			WaitForLoads(asset->SceneId);
+			if (asset->IsLoadedInMemory) { UnloadAsset(*asset); }
+			asset->PackedData = {};
+		}
+
+		archive = nullptr;
+	}
+
+	void ResourceManager::AttachPackedData(Asset& asset) const
+	{
+		if (!archive) { return; }
+
+		const auto* entry = archive->Find(asset.Uid);
+		if (entry && entry->NameHash == AssetArchive::HashName(asset.Name))
+		{
+			asset.PackedData = archive->GetData(*entry);
+		}
+		else if (entry)
+		{
+			LogMessage("Asset " + to_string(asset.Uid) + " '" + asset.Name + "' does not match the archive's, loading it from its file.");
+		}
 	}
 
 	string ResourceManager::GetSubscriberName() { return "resource manager"; }
 
+	bool ResourceManager::IsSkipped(const Asset& asset) const
+	{
+		if (!metadataOnly) { return false; }
+
+		switch (asset.AssetType)
+		{
+			case Asset::AssetType::Graphic:
+			case Asset::AssetType::Sprite:
+			case Asset::AssetType::Audio:
+			case Asset::AssetType::Font:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	bool ResourceManager::IsInScene(const Asset& asset, const int scene)
+	{
+		return asset.SceneId == scene || asset.SceneId == 0;
+	}
+
 	void ResourceManager::Reset()
 	{
+		// Stop decoding first, loads in flight are abandoned
+		loader = nullptr;
+		uploadQueue->Clear();
+		for (const auto& [uid, waiting] : loadingAssets)
+		{
+			for (const auto& handle : waiting) { handle->AssetDone(true); }
+		}
+		loadingAssets.clear();
+		hintedScenes.clear();
+		currentScene = 0;
+
 		Unload();
 		resourcesById.clear();
 		resourcesByName.clear();
@@ -304,11 +660,15 @@ namespace gamelib
 
 	shared_ptr<Asset> ResourceManager::GetAssetInfo(const string& name)
 	{
-		return resourcesByName[name];
+		auto& asset = resourcesByName[name];
+		if (asset) { residency.Touch(asset->Uid); }
+		return asset;
 	}
 	shared_ptr<Asset> ResourceManager::GetAssetInfo(const int uuid)
 	{
-		return resourcesById[uuid];
+		auto& asset = resourcesById[uuid];
+		if (asset) { residency.Touch(asset->Uid); }
+		return asset;
 	}
 
 	ResourceManager* ResourceManager::Get()
@@ -2,7 +2,10 @@
 #include <string>
 #include <map>
 #include <memory>
+#include <cstdint>
+#include <set>
 #include "events/EventSubscriber.h"
+#include "resource/AssetResidency.h"
 
 namespace tinyxml2
 {
@@ -12,6 +15,11 @@ namespace tinyxml2
 namespace gamelib
 {
 	class Asset;
+	class AssetArchive;
+	class AssetLoader;
+	class AssetLoadHandle;
+	class AssetUploadQueue;
+	struct DecodedAsset;
 	/***
 	 * co-ordinates the resources in the game - such as holding definitions of all the resources/assets in the game
 	 */
@@ -24,7 +32,7 @@ namespace gamelib
 		std::shared_ptr<Asset> GetAssetInfo(int uuid);
 		[[nodiscard]] int GetCountResources() const { return countResources; }
 		std::vector<std::shared_ptr<Event>> HandleEvent(const std::shared_ptr<Event>& event, unsigned long deltaMs) override;
-		void Unload() const;
+		void Unload();
 		
 		bool Initialize(const std::string& filePath);
 	    std::string GetSubscriberName() override;
@@ -36,6 +44,70 @@ namespace gamelib
 		[[nodiscard]] int GetCountUnloadedResources() const { return countUnloadedResources; }
 		[[nodiscard]] int GetCountLoadedResources() const { return countLoadedResources; }
 
+		// Index and track assets without loading textures, audio or fonts, e.g. on a headless server. Scripts still load
+		void SetMetadataOnly(const bool isMetadataOnly) { metadataOnly = isMetadataOnly; }
+		[[nodiscard]] bool IsMetadataOnly() const { return metadataOnly; }
+
+		// Decode assets on this many background threads when the scene changes. 0 loads them in place (the default)
+		void SetAsyncLoading(size_t threadCount);
+		[[nodiscard]] bool IsAsyncLoading() const { return loaderThreads > 0; }
+
+		// Most assets the game loop finishes loading each frame, so a scene change's textures are spread over frames
+		void SetMaxUploadsPerFrame(const size_t maxUploads) { maxUploadsPerFrame = maxUploads; }
+		[[nodiscard]] size_t GetMaxUploadsPerFrame() const { return maxUploadsPerFrame; }
+
+		/// <summary>
+		/// Unloads other scenes' assets and starts loading the scene's in the background. Call CompleteLoads() each
+		/// frame to finish them; SceneAssetsReady is raised once all have loaded or failed to. Loads of scenes that are
+		/// neither this one nor hinted are cancelled, and their assets aren't kept once they finish
+		/// </summary>
+		std::shared_ptr<AssetLoadHandle> LoadSceneAssetsAsync(int scene);
+
+		/// <summary>
+		/// Finishes loading up to maxUploads decoded assets, e.g. creating their textures. Game loop thread only
+		/// </summary>
+		/// <returns>Number of assets finished</returns>
+		size_t CompleteLoads(size_t maxUploads = SIZE_MAX);
+
+		/// <summary>
+		/// Leaves creating textures and other uploads to the thread calling UploadPending(), e.g. a render thread that
+		/// owns the renderer, while CompleteLoads() still finishes the loads. Scene changes then always load in the
+		/// background. Turning it off uploads what is left on the calling thread
+		/// </summary>
+		void SetRenderThreadUploads(bool isRenderThreadUploads);
+		[[nodiscard]] bool IsRenderThreadUploads() const { return renderThreadUploads; }
+
+		/// <summary>
+		/// Uploads up to maxUploads assets handed over by CompleteLoads(). Upload thread only
+		/// </summary>
+		/// <returns>Number of assets uploaded</returns>
+		size_t UploadPending(size_t maxUploads = SIZE_MAX);
+
+		/// <summary>
+		/// Memory loaded assets may take up. With no budget (0, the default) changing scene unloads every other
+		/// scene's assets. With one, they stay loaded and the least recently used are unloaded once over budget;
+		/// the current scene's and scene 0's assets are never unloaded, so the budget should at least fit those
+		/// </summary>
+		void SetMemoryBudget(size_t budgetBytes);
+		[[nodiscard]] const AssetResidency& GetResidency() const { return residency; }
+
+		/// <summary>
+		/// Scenes likely to come next, e.g. from the scene file. Their assets are loaded in the background, raising
+		/// SceneAssetsReady for each, and are kept over other scenes' when changing scene. Replaces earlier hints
+		/// </summary>
+		void HintNextScenes(const std::vector<int>& scenes);
+
+		/// <summary>
+		/// Load assets out of a packed archive (see AssetArchive) instead of their own files. Assets are matched by uid
+		/// and name, and those not in the archive still load from their files. Stays mounted across IndexResourceFile()
+		/// </summary>
+		void MountArchive(const std::string& archivePath);
+		void UnmountArchive();
+		[[nodiscard]] const AssetArchive* GetArchive() const { return archive.get(); }
+
+		// Indexes an asset that isn't in the resources file, e.g. one made at runtime
+		void AddAsset(const std::shared_ptr<Asset>& asset);
+
 		enum class ErrorNumbers
 		{
 			NoAssetManagerForType,
@@ -48,7 +120,28 @@ namespace gamelib
 	private:
 		ResourceManager();		
 		void LoadSceneAssets(int level);
+		void UnloadOtherSceneAssets(int level);
+		std::shared_ptr<AssetLoadHandle> StartLoading(int scene);
+		void WaitForLoads(int scene);
+		void WaitForAllLoads();
+
+		// Keeps or discards an asset whose load ended and raises SceneAssetsReady for the scenes it completes
+		void FinishLoad(const DecodedAsset& loaded);
+
+		// Cancels the loads of scenes no longer current or hinted
+		void CancelSupersededLoads();
+		[[nodiscard]] bool IsWanted(const Asset& asset) const;
+		void UnloadAsset(Asset& asset);
+
+		// Unloads the least recently used assets until back within the memory budget
+		void EnforceBudget();
+		// Scene 0's assets are in every scene
+		[[nodiscard]] static bool IsInScene(const Asset& asset, int scene);
 	    void StoreAsset(const std::shared_ptr<Asset>& asset);
+		void AttachPackedData(Asset& asset) const;
+
+		// Textures, audio and fonts: assets only needed to present the game
+		[[nodiscard]] bool IsSkipped(const Asset& asset) const;
 		std::map<int, std::vector<std::shared_ptr<Asset>>> resourcesByScene;   
 		std::map<std::string, std::shared_ptr<Asset>> resourcesByName;   
 		std::map<int, std::shared_ptr<Asset>> resourcesById;
@@ -57,6 +150,21 @@ namespace gamelib
 		int countLoadedResources = 0;
 		int countUnloadedResources = 0;
 		bool debug;
+		bool metadataOnly = false;
+
+		// Background loading: assets being decoded and the scene loads waiting on them
+		std::unique_ptr<AssetLoader> loader;
+		std::map<int, std::vector<std::shared_ptr<AssetLoadHandle>>> loadingAssets;
+		size_t loaderThreads = 0;
+		size_t maxUploadsPerFrame = 4;
+		std::unique_ptr<AssetUploadQueue> uploadQueue;
+		bool renderThreadUploads = false;
+
+		AssetResidency residency;
+		std::set<int> hintedScenes;
+		int currentScene = 0;
+
+		std::unique_ptr<AssetArchive> archive;
 	};
 }
 
@@ -1,5 +1,6 @@
 #include "SceneManager.h"
 #include <list>
+#include <sstream>
 #include <tinyxml2.h>
 #include <memory>
 #include "events/GameObjectEvent.h"
@@ -11,7 +12,10 @@
 #include "events/UpdateAllGameObjectsEvent.h"
 #include "objects/GameObjectFactory.h"
 #include "file/SettingsManager.h"
+#include "graphic/RenderPacket.h"
 #include "graphic/SDLGraphicsManager.h"
+#include "resource/ResourceManager.h"
+#include "structure/Profiler.h"
 #include "utils/Utils.h"
 #include "objects/GameObject.h"
 #include "Layer.h"
@@ -70,12 +74,12 @@ namespace gamelib
 		vector<shared_ptr<Event>> secondaryEvents;
 
 		// ReSharper disable once CppDefaultCaseNotHandledInSwitchStatement
-		if(event->Id.PrimaryId == DrawCurrentSceneEventId.PrimaryId) { DrawScene(); }
-		if(event->Id.PrimaryId == SceneChangedEventTypeEventId.PrimaryId) { LoadNewScene(event); }
-		if(event->Id.PrimaryId == UpdateAllGameObjectsEventTypeEventId.PrimaryId) { UpdateAllObjects(deltaMs); }
-		if(event->Id.PrimaryId == AddGameObjectToCurrentSceneEventId.PrimaryId) { AddGameObjectToScene(event);}
-		if(event->Id.PrimaryId == GameObjectTypeEventId.PrimaryId) { OnGameObjectEventReceived(event); }
-		if(event->Id.PrimaryId == SceneLoadedEventId.PrimaryId) { OnSceneLoaded(event);}
+		if(event->Id.GetPrimaryId() == DrawCurrentSceneEventId.GetPrimaryId()) { DrawScene(); }
+		if(event->Id.GetPrimaryId() == SceneChangedEventTypeEventId.GetPrimaryId()) { LoadNewScene(event); }
+		if(event->Id.GetPrimaryId() == UpdateAllGameObjectsEventTypeEventId.GetPrimaryId()) { UpdateAllObjects(deltaMs); }
+		if(event->Id.GetPrimaryId() == AddGameObjectToCurrentSceneEventId.GetPrimaryId()) { AddGameObjectToScene(event);}
+		if(event->Id.GetPrimaryId() == GameObjectTypeEventId.GetPrimaryId()) { OnGameObjectEventReceived(event); }
+		if(event->Id.GetPrimaryId() == SceneLoadedEventId.GetPrimaryId()) { OnSceneLoaded(event);}
 		
 		// We don't generate any events yet;
 		return secondaryEvents;
@@ -172,6 +176,8 @@ namespace gamelib
 
 	void SceneManager::DrawScene(bool skipHiddenLayers) const
 	{
+		PROFILE_ZONE("SceneManager::DrawScene");
+
 		// Function that collects all game objects in the loaded scene and draws them in layered order
 		const auto renderAllObjectsFn = static_cast<RenderFunc>([&](SDL_Renderer* windowRenderer)
 		{
@@ -199,6 +205,42 @@ namespace gamelib
 		SdlGraphicsManager::Get()->ClearAndDraw(renderAllObjectsFn);
 	}
 
+	void SceneManager::SnapshotScene(RenderPacket& packet, const bool skipHiddenLayers) const
+	{
+		uint16_t layerNumber = 0;
+		for (const auto& layer : GetLayers())
+		{
+			if (!skipHiddenLayers || layer->Visible)
+			{
+				for (const auto& gameObject : layer->Objects)
+				{
+					const auto theGameObject = gameObject.lock();
+					if (!theGameObject) { continue; }
+
+					const auto firstItem = packet.Items.size();
+					if (!theGameObject->AddRenderItems(packet.Items))
+					{
+						// Objects whose drawing can't be described are left out, so say which
+						packet.Items.resize(firstItem);
+						if (unsnapshottedObjects.insert(theGameObject->Id).second)
+						{
+							Logger::Get()->LogThis("SnapshotScene: " + theGameObject->Name + " can't be drawn from a render packet and is left out");
+						}
+						continue;
+					}
+
+					for (auto item = firstItem; item < packet.Items.size(); item++) { packet.Items[item].Layer = layerNumber; }
+				}
+			}
+			layerNumber++;
+		}
+	}
+
+	void SceneManager::DrawRenderPacket(const RenderPacket& packet)
+	{
+		SdlGraphicsManager::Get()->ClearAndDraw([&](SDL_Renderer* windowRenderer) { packet.Draw(windowRenderer); });
+	}
+
 	std::vector <std::weak_ptr<GameObject>> SceneManager::GetAllObjects() const
 	{
 		// We'll store all the game objects we find in the scene
@@ -228,7 +270,7 @@ namespace gamelib
 		
 		/* Eg. 
 
-			<scene id="2">
+			<scene id="2" next="3">
 			  <layer name="layer0" posx="0" posy="0" visible="true">
 				<objects>
 				  <object posx="100" posy="40" resourceId="7" visible="true" colourKey="true" r="0" g="0" b="0"></object>
@@ -307,6 +349,15 @@ namespace gamelib
 				// We want to draw from zOrder 0 -> onwards (in order)
 				SortLayers(); 
 
+				// Scenes that can follow this one, e.g. next="3,4", have their assets loaded ahead of time
+				if (const auto* next = scene->Attribute("next"))
+				{
+					vector<int> nextScenes;
+					stringstream sceneIds(next);
+					for (string sceneId; getline(sceneIds, sceneId, ',');) { nextScenes.push_back(stoi(sceneId)); }
+					ResourceManager::Get()->HintNextScenes(nextScenes);
+				}
+
 				// Remember what scene we are currently in
 				currentSceneName = filename;
 
@@ -321,7 +372,7 @@ namespace gamelib
 
 	std::shared_ptr<GameObject> SceneManager::GetGameObjectFrom(const std::shared_ptr<Event>& event)
 	{
-		if (event->Id.PrimaryId != AddGameObjectToCurrentSceneEventId.PrimaryId) { THROW(1, "Cannot extract game object from event", "SceneManager"); }
+		if (event->Id.GetPrimaryId() != AddGameObjectToCurrentSceneEventId.GetPrimaryId()) { THROW(1, "Cannot extract game object from event", "SceneManager"); }
 
 		return dynamic_pointer_cast<AddGameObjectToCurrentSceneEvent>(event)->GetGameObject();
 	}
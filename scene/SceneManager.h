@@ -2,6 +2,7 @@
 #define SCENE_MANAGER_H
 
 #include <list>
+#include <set>
 #include "events/EventSubscriber.h"
 #include "objects/GameWorldData.h"
 #include "events/EventNumbers.h"
@@ -10,6 +11,7 @@ namespace gamelib
 {
 	class Layer;
 	class GameWorldData;
+	struct RenderPacket;
 	const static EventId DrawCurrentSceneEventId(DrawCurrentScene, "DrawCurrentScene");	
 	const static EventId GenerateNewLevelEventId(GenerateNewLevel, "GenerateNewLevel");
 
@@ -28,6 +30,10 @@ namespace gamelib
 		void StartScene(int sceneId);
 		[[nodiscard]] std::list<std::shared_ptr<Layer>> GetLayers() const;
 
+		// Adds what DrawScene() would draw to the packet, to be drawn with DrawRenderPacket(), e.g. by a PipelinedGameLoop
+		void SnapshotScene(RenderPacket& packet, bool skipHiddenLayers = true) const;
+		static void DrawRenderPacket(const RenderPacket& packet);
+
 	protected:
 		static SceneManager* instance;
 
@@ -66,6 +72,9 @@ namespace gamelib
 		bool isInitialized = false;
 		std::string sceneFolder;
 		GameWorldData gameWorld;
+
+		// Objects SnapshotScene() has left out, so each is only logged once
+		mutable std::set<int> unsnapshottedObjects;
 	};
 }
 #endif
\ No newline at end of file
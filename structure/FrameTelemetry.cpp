@@ -0,0 +1,173 @@
+#include "FrameTelemetry.h"
+#include <numeric>
+#include <sstream>
+#include "file/TextFile.h"
+#include "time/time.h"
+
+namespace gamelib
+{
+	FrameStageTimer::FrameStageTimer(FrameTelemetry& telemetry, const FrameStage stage)
+		: telemetry(telemetry), stage(stage), startUs(telemetry.GetTimeNowUs()) { }
+
+	FrameStageTimer::~FrameStageTimer()
+	{
+		telemetry.RecordStage(stage, telemetry.GetTimeNowUs() - startUs);
+	}
+
+	FrameTelemetry::FrameTelemetry(const uint64_t stallThresholdUs, const uint64_t summaryIntervalMs)
+		: nowUs(GetTimeUs),
+		  stallThresholdUs(stallThresholdUs),
+		  summaryIntervalUs(summaryIntervalMs * 1000),
+		  frameStartUs(nowUs()),
+		  summaryStartUs(frameStartUs)
+	{
+		recentStalls.reserve(MaxRecentStalls);
+	}
+
+	FrameTelemetry::~FrameTelemetry() = default;
+
+	void FrameTelemetry::SetClock(std::function<uint64_t()> nowUs)
+	{
+		this->nowUs = std::move(nowUs);
+		Reset();
+	}
+
+	void FrameTelemetry::RecordStage(const FrameStage stage, const uint64_t durationUs)
+	{
+		currentStageUs[static_cast<size_t>(stage)] += durationUs;
+	}
+
+	void FrameTelemetry::EndFrame()
+	{
+		const auto now = nowUs();
+		const auto frameTimeUs = now - frameStartUs;
+		frameStartUs = now;
+		const auto timedUs = std::accumulate(currentStageUs.begin(), currentStageUs.end(), uint64_t { 0 });
+		const auto frameUntimedUs = frameTimeUs > timedUs ? frameTimeUs - timedUs : 0;
+
+		if (frameTimeUs > stallThresholdUs)
+		{
+			FrameStall stall { frameNumber, frameTimeUs, currentStageUs, frameUntimedUs };
+
+			// Judged against the frames before it
+			uint64_t worstOverrunUs = 0;
+			const auto blameIfWorse = [&](const FrameStage culprit, const uint64_t tookUs, const Histogram& usual)
+			{
+				const auto usualUs = usual.GetPercentile(50.0);
+				const auto overrunUs = tookUs > usualUs ? tookUs - usualUs : 0;
+				if (overrunUs > worstOverrunUs)
+				{
+					worstOverrunUs = overrunUs;
+					stall.Culprit = culprit;
+				}
+			};
+			for (size_t stage = 0; stage < FrameStageCount; stage++)
+			{
+				blameIfWorse(static_cast<FrameStage>(stage), currentStageUs[stage], stageUs[stage]);
+			}
+			blameIfWorse(FrameStage::Untimed, frameUntimedUs, untimedUs);
+
+			if (recentStalls.size() < MaxRecentStalls) { recentStalls.push_back(stall); }
+			else { recentStalls[nextStall] = stall; }
+			nextStall = (nextStall + 1) % MaxRecentStalls;
+			stallCount++;
+			stallsSinceSummary++;
+
+			if (stallCallback) { stallCallback(stall); }
+		}
+
+		frameUs.Record(frameTimeUs);
+		for (size_t stage = 0; stage < FrameStageCount; stage++) { stageUs[stage].Record(currentStageUs[stage]); }
+		untimedUs.Record(frameUntimedUs);
+		currentStageUs.fill(0);
+		frameNumber++;
+
+		if (summaryIntervalUs > 0 && now - summaryStartUs >= summaryIntervalUs)
+		{
+			WriteSummary();
+			summaryStartUs = now;
+		}
+	}
+
+	void FrameTelemetry::SetSummaryFile(const std::string& fileName)
+	{
+		summaryFile = fileName.empty() ? nullptr : std::make_unique<TextFile>(fileName);
+	}
+
+	void FrameTelemetry::SetSummaryCallback(std::function<void(const std::string& summary)> callback)
+	{
+		summaryCallback = std::move(callback);
+	}
+
+	void FrameTelemetry::SetStallCallback(std::function<void(const FrameStall& stall)> callback)
+	{
+		stallCallback = std::move(callback);
+	}
+
+	std::string FrameTelemetry::GetSummary() const
+	{
+		std::stringstream summary;
+		const auto writePercentiles = [&](const char* name, const Histogram& histogram)
+		{
+			summary << ' ' << name << "_us=" << histogram.GetPercentile(50.0) << '/' << histogram.GetPercentile(95.0)
+			        << '/' << histogram.GetPercentile(99.0) << '/' << histogram.GetMax();
+		};
+
+		summary << "frames=" << frameUs.GetCount() << " stalls=" << stallsSinceSummary;
+		writePercentiles("frame", frameUs);
+		for (size_t stage = 0; stage < FrameStageCount; stage++)
+		{
+			writePercentiles(GetStageName(static_cast<FrameStage>(stage)), stageUs[stage]);
+		}
+		writePercentiles(GetStageName(FrameStage::Untimed), untimedUs);
+		return summary.str();
+	}
+
+	void FrameTelemetry::WriteSummary()
+	{
+		const auto summary = GetSummary();
+		if (summaryFile) { summaryFile->Append(summary + '\n'); }
+		if (summaryCallback) { summaryCallback(summary); }
+
+		frameUs.Reset();
+		for (auto& histogram : stageUs) { histogram.Reset(); }
+		untimedUs.Reset();
+		stallsSinceSummary = 0;
+	}
+
+	std::vector<FrameStall> FrameTelemetry::GetRecentStalls() const
+	{
+		// Once full, the oldest stall is the next one to be overwritten
+		if (recentStalls.size() < MaxRecentStalls) { return recentStalls; }
+
+		std::vector<FrameStall> ordered(recentStalls.begin() + static_cast<std::ptrdiff_t>(nextStall), recentStalls.end());
+		ordered.insert(ordered.end(), recentStalls.begin(), recentStalls.begin() + static_cast<std::ptrdiff_t>(nextStall));
+		return ordered;
+	}
+
+	void FrameTelemetry::Reset()
+	{
+		frameUs.Reset();
+		for (auto& histogram : stageUs) { histogram.Reset(); }
+		untimedUs.Reset();
+		currentStageUs.fill(0);
+		recentStalls.clear();
+		nextStall = 0;
+		frameNumber = stallCount = stallsSinceSummary = 0;
+		frameStartUs = summaryStartUs = nowUs();
+	}
+
+	const char* FrameTelemetry::GetStageName(const FrameStage stage)
+	{
+		switch (stage)
+		{
+			case FrameStage::Input: return "input";
+			case FrameStage::Network: return "network";
+			case FrameStage::Update: return "update";
+			case FrameStage::Draw: return "draw";
+			case FrameStage::Untimed: return "untimed";
+			case FrameStage::None: return "none";
+		}
+		return "unknown";
+	}
+}
@@ -0,0 +1,143 @@
+#pragma once
+#ifndef FRAMETELEMETRY_H
+#define FRAMETELEMETRY_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "utils/Histogram.h"
+
+namespace gamelib
+{
+	class TextFile;
+
+	// Parts of a frame that are timed separately
+	enum class FrameStage : uint8_t
+	{
+		Input,
+		Network,
+		Update,
+		Draw,
+
+		// Not timed, only for FrameStall::Culprit
+		Untimed,
+		None
+	};
+
+	// The timed stages
+	constexpr size_t FrameStageCount = 4;
+
+	// A frame that took longer than the stall threshold, and where its time went
+	struct FrameStall
+	{
+		uint64_t FrameNumber {};
+		uint64_t FrameUs {};
+		std::array<uint64_t, FrameStageCount> StageUs {};
+
+		// Frame time outside every timed stage, e.g. sleeping, waiting for vsync or work between EndFrame() calls
+		uint64_t UntimedUs {};
+
+		// The stage, or the untimed time, furthest over its usual (median) time. None if nothing took longer than usual
+		FrameStage Culprit = FrameStage::None;
+	};
+
+	class FrameTelemetry;
+
+	// Times a stage from construction to destruction, see FrameTelemetry::TimeStage()
+	class FrameStageTimer
+	{
+	public:
+		FrameStageTimer(FrameTelemetry& telemetry, FrameStage stage);
+		~FrameStageTimer();
+
+		FrameStageTimer(const FrameStageTimer& other) = delete;
+		FrameStageTimer& operator=(const FrameStageTimer& other) = delete;
+
+	private:
+		FrameTelemetry& telemetry;
+		FrameStage stage;
+		uint64_t startUs;
+	};
+
+	/// <summary>
+	/// Machine-readable frame timings for tracking frame latency.
+	/// Stage durations are added up over a frame, which runs from one EndFrame() to the next, and recorded into
+	/// histograms along with the whole frame's time. Frames over the stall threshold are kept with their breakdown.
+	/// Every summary interval a one line summary of the p50/p95/p99/max of each histogram is written to the summary
+	/// file and/or callback, and the histograms start over.
+	/// </summary>
+	class FrameTelemetry
+	{
+	public:
+		explicit FrameTelemetry(uint64_t stallThresholdUs = 50000, uint64_t summaryIntervalMs = 10000);
+		~FrameTelemetry();
+
+		FrameTelemetry(const FrameTelemetry& other) = delete;
+		FrameTelemetry& operator=(const FrameTelemetry& other) = delete;
+
+		[[nodiscard]] FrameStageTimer TimeStage(const FrameStage stage) { return { *this, stage }; }
+		void RecordStage(FrameStage stage, uint64_t durationUs);
+		void EndFrame();
+
+		// Summaries are appended to the file, one line each
+		void SetSummaryFile(const std::string& fileName);
+		void SetSummaryCallback(std::function<void(const std::string& summary)> callback);
+		void SetStallCallback(std::function<void(const FrameStall& stall)> callback);
+
+		// p50/p95/p99/max in microseconds of the frame and each stage since the last summary, e.g.
+		// "frames=600 stalls=1 frame_us=16639/16895/17151/51200 input_us=... network_us=... update_us=... draw_us=...
+		// untimed_us=..."
+		[[nodiscard]] std::string GetSummary() const;
+
+		[[nodiscard]] const Histogram& GetFrameHistogram() const { return frameUs; }
+		[[nodiscard]] const Histogram& GetStageHistogram(const FrameStage stage) const { return stageUs[static_cast<size_t>(stage)]; }
+		[[nodiscard]] const Histogram& GetUntimedHistogram() const { return untimedUs; }
+
+		// The latest stalls, oldest first
+		[[nodiscard]] std::vector<FrameStall> GetRecentStalls() const;
+		[[nodiscard]] uint64_t GetFrameCount() const { return frameNumber; }
+		[[nodiscard]] uint64_t GetStallCount() const { return stallCount; }
+
+		void Reset();
+
+		// Replaces the clock, e.g. to drive telemetry from a test
+		void SetClock(std::function<uint64_t()> nowUs);
+		[[nodiscard]] uint64_t GetTimeNowUs() const { return nowUs(); }
+
+		static const char* GetStageName(FrameStage stage);
+
+	private:
+		void WriteSummary();
+
+		static constexpr size_t MaxRecentStalls = 32;
+
+		std::function<uint64_t()> nowUs;
+		const uint64_t stallThresholdUs;
+		const uint64_t summaryIntervalUs;
+
+		Histogram frameUs;
+		std::array<Histogram, FrameStageCount> stageUs;
+		Histogram untimedUs;
+
+		// Stage times of the frame in progress
+		std::array<uint64_t, FrameStageCount> currentStageUs {};
+		uint64_t frameStartUs;
+		uint64_t summaryStartUs;
+		uint64_t frameNumber = 0;
+		uint64_t stallCount = 0;
+		uint64_t stallsSinceSummary = 0;
+
+		// Ring of the latest stalls
+		std::vector<FrameStall> recentStalls;
+		size_t nextStall = 0;
+
+		std::unique_ptr<TextFile> summaryFile;
+		std::function<void(const std::string& summary)> summaryCallback;
+		std::function<void(const FrameStall& stall)> stallCallback;
+	};
+}
+
+#endif
@@ -15,16 +15,30 @@
 #include <net/NetworkManager.h>
 #include "Logging/ErrorLogManager.h"
 #include <events/UpdateProcessesEvent.h>
+#include "HeadlessGameLoop.h"
 #include "VariableGameLoop.h"
 #include "events/EventFactory.h"
 #include "font/FontManager.h"
 #include "file/SettingsManager.h"
 #include <time/time.h>
+#include "FrameTelemetry.h"
+#include "Profiler.h"
 
 using namespace std;
 
 namespace gamelib
 {
+	namespace
+	{
+		template <typename Work>
+		void TimeStage(FrameTelemetry* telemetry, const FrameStage stage, Work&& work)
+		{
+			if (telemetry == nullptr) { work(); return; }
+
+			const auto timer = telemetry->TimeStage(stage);
+			work();
+		}
+	}
 
 	GameStructure::GameStructure(std::shared_ptr<IGameLoopStrategy> gameLoop): gameLoop(std::move(gameLoop))
 	{
@@ -48,6 +62,7 @@ namespace gamelib
 	{
 		// We use the old variable game loop if we don't specify a specific one
 		gameLoop =  MakeVariableGameLoop();		
+		usingDefaultGameLoop = true;
 	}
 
 	bool GameStructure::DoGameLoop(GameWorldData* gameWorldData) const
@@ -104,23 +119,90 @@ namespace gamelib
 		}, true, true);
 	}
 
+	bool GameStructure::InitializeHeadless(const string& resourceFilePath, const string& sceneFolderPath, const unsigned int tickRateHz)
+	{
+		const auto beVerbose = SettingsManager::Bool("global", "verbose");
+
+		// Nobody is at the controls
+		sampleInput = false;
+		sampleNetwork = SettingsManager::Bool("gameStructure", "sampleNetwork");
+
+		return LogThis("GameStructure::InitializeHeadless()", beVerbose, [&]()
+		{
+			if (SettingsManager::Bool("global", "isNetworkGame"))
+			{
+				LogOnFailure(NetworkManager::Get()->Initialize(), "Could not initialize network manager");
+			}
+
+			ResourceManager::Get()->SetMetadataOnly(true);
+
+			if (IsFailedOrFalse(LogOnFailure(EventManager::Get()->Initialize(),
+			                                 "Could not initialize event manager")) ||
+				IsFailedOrFalse(LogOnFailure(ResourceManager::Get()->Initialize(resourceFilePath),
+				                             "Could not initialize resource manager")) ||
+				IsFailedOrFalse(LogOnFailure(SceneManager::Get()->Initialize(sceneFolderPath),
+				                             "Could not initialize scene manager")))
+			{ return false; }
+
+			headless = true;
+
+			if (usingDefaultGameLoop)
+			{
+				const auto tickTimeUs = tickRateHz == 0 ? 0ULL : 1000000ULL / tickRateHz;
+				gameLoop = make_shared<HeadlessGameLoop>([this](const unsigned long deltaMs) { Update(deltaMs); }, tickTimeUs);
+			}
+
+			return true;
+		}, true, true);
+	}
+
 	void GameStructure::Update(const unsigned long deltaMs) const
 	{
-		
-		ReadKeyboard(deltaMs);
-		ReadNetwork(deltaMs);
+		PROFILE_ZONE("GameStructure::Update");
+
+		const auto telemetry = frameTelemetry.get();
+
+		TimeStage(telemetry, FrameStage::Input, [&] { ReadKeyboard(deltaMs); });
+		TimeStage(telemetry, FrameStage::Network, [&] { ReadNetwork(deltaMs); });
+		TimeStage(telemetry, FrameStage::Update, [&]
+		{
+			// Headless, background loads are finished here rather than before drawing
+			if (headless) { ResourceManager::Get()->CompleteLoads(ResourceManager::Get()->GetMaxUploadsPerFrame()); }
+
+			EventManager::Get()->ProcessAllEvents(deltaMs);
+			EventManager::Get()->DispatchEventToSubscriber(EventFactory::CreateUpdateAllGameObjectsEvent(), deltaMs);
+			EventManager::Get()->DispatchEventToSubscriber(EventFactory::CreateUpdateProcessesEvent(), deltaMs);
+		});
 
-		EventManager::Get()->ProcessAllEvents(deltaMs);
-		EventManager::Get()->DispatchEventToSubscriber(EventFactory::CreateUpdateAllGameObjectsEvent(), deltaMs);
-		EventManager::Get()->DispatchEventToSubscriber(EventFactory::CreateUpdateProcessesEvent(), deltaMs);
-		std::cout << deltaMs <<  " ";
-		
+		// Headless, nothing is drawn so frames end with their update
+		if (headless)
+		{
+			PROFILE_FRAME();
+			if (telemetry) { telemetry->EndFrame(); }
+		}
 	}
 
-	void GameStructure::Draw(unsigned long percentWithinTick)
+	void GameStructure::Draw(unsigned long percentWithinTick) const
 	{
-		// Time-sensitive, skip queue. Draws the current scene
-		EventManager::Get()->DispatchEventToSubscriber(EventFactory::CreateGenericEvent(DrawCurrentSceneEventId, "GameStructure"), 0UL);
+		// There's no renderer to draw with, even if a game loop that draws was given
+		if (headless) { return; }
+
+		{
+			PROFILE_ZONE("GameStructure::Draw");
+
+			// Time-sensitive, skip queue. Draws the current scene
+			TimeStage(frameTelemetry.get(), FrameStage::Draw, []
+			{
+				// Textures of assets decoded in the background can only be created on the thread that draws
+				ResourceManager::Get()->CompleteLoads(ResourceManager::Get()->GetMaxUploadsPerFrame());
+
+				EventManager::Get()->DispatchEventToSubscriber(EventFactory::CreateGenericEvent(DrawCurrentSceneEventId, "GameStructure"), 0UL);
+			});
+		}
+
+		// A frame ends with its drawing
+		PROFILE_FRAME();
+		if (frameTelemetry) { frameTelemetry->EndFrame(); }
 	}
 
 
@@ -219,7 +301,8 @@ namespace gamelib
 
 	GameStructure::~GameStructure()
 	{
-		// Ensure we unload when this object is about to die/destruct
-		Unload();
+		// Ensure we unload when this object is about to die/destruct. Headless, there's no SDL to shut down
+		if (headless) { ResourceManager::Get()->Unload(); }
+		else { Unload(); }
 	}
 }
@@ -9,6 +9,7 @@ namespace gamelib
 	class IGameLoopStrategy;
 	class VariableGameLoop;
 	class GameWorldData;
+	class FrameTelemetry;
 
 	/// <summary>
 	/// logical structure of the game such as the game initialization, game loop etc.
@@ -33,6 +34,16 @@ namespace gamelib
 		                const std::string &resourceFilePath, const std::string &sceneFolderPath,
 		                bool hideWindow );
 
+		// Initialize for simulation only, e.g. on a dedicated server: events, resource metadata, scenes and networking,
+		// but no SDL window, renderer, audio or fonts, and textures, audio and fonts are never loaded.
+		// Unless a game loop was given, the game updates uncapped or, with a tick rate, at that many ticks a second
+		bool InitializeHeadless(const std::string& resourceFilePath, const std::string& sceneFolderPath, unsigned int tickRateHz = 0);
+
+		[[nodiscard]] bool IsHeadless() const { return headless; }
+
+		// Time the input, network, update and draw stages of each frame into the telemetry. Null stops timing
+		void SetFrameTelemetry(std::shared_ptr<FrameTelemetry> telemetry) { frameTelemetry = std::move(telemetry); }
+
 		// Finish up and unload the Game structure
 		~GameStructure() override;
 
@@ -48,7 +59,7 @@ namespace gamelib
 		[[nodiscard]] std::shared_ptr<VariableGameLoop> MakeVariableGameLoop() const;
 
 		// Draw the game
-		static void Draw(unsigned long);
+		void Draw(unsigned long) const;
 
 		// Update the game
 		void Update(unsigned long deltaMs) const;
@@ -85,5 +96,14 @@ namespace gamelib
 
 		// Reference to the provided game loop
 		std::shared_ptr<IGameLoopStrategy> gameLoop;
+
+		// If we made the game loop rather than being given one
+		bool usingDefaultGameLoop{};
+
+		// If initialized without SDL
+		bool headless{};
+
+		// Optional timing of each frame
+		std::shared_ptr<FrameTelemetry> frameTelemetry;
 	};
 }
@@ -0,0 +1,70 @@
+#include "HeadlessGameLoop.h"
+#include <chrono>
+#include <thread>
+#include "objects/GameWorldData.h"
+#include "time/time.h"
+
+namespace gamelib
+{
+	HeadlessGameLoop::HeadlessGameLoop(std::function<void(unsigned long deltaMs)> updateFunc, const uint64_t tickTimeUs, const unsigned int maxLateTicks)
+		: updateFunc(std::move(updateFunc)),
+		  nowUs(GetTimeUs),
+		  sleepUs([](const uint64_t durationUs) { std::this_thread::sleep_for(std::chrono::microseconds(durationUs)); }),
+		  tickTimeUs(tickTimeUs),
+		  maxLateTicks(maxLateTicks) { }
+
+	void HeadlessGameLoop::SetClock(std::function<uint64_t()> nowUs, std::function<void(uint64_t durationUs)> sleepUs)
+	{
+		this->nowUs = std::move(nowUs);
+		this->sleepUs = std::move(sleepUs);
+	}
+
+	void HeadlessGameLoop::Loop(GameWorldData* gameWorldData)
+	{
+		auto previous = nowUs();
+		auto nextTick = previous + tickTimeUs;
+
+		// Sub-millisecond time is carried over rather than lost
+		uint64_t remainderUs = 0;
+
+		while (!gameWorldData->IsGameDone)
+		{
+			const auto now = nowUs();
+
+			if (tickTimeUs == 0)
+			{
+				remainderUs += now - previous;
+				previous = now;
+			}
+			else
+			{
+				if (now < nextTick)
+				{
+					sleepUs(nextTick - now);
+					continue;
+				}
+
+				if (const auto lateTicks = (now - nextTick) / tickTimeUs; lateTicks > maxLateTicks)
+				{
+					droppedTicks += static_cast<unsigned long>(lateTicks);
+					nextTick += lateTicks * tickTimeUs;
+				}
+
+				remainderUs += tickTimeUs;
+				nextTick += tickTimeUs;
+			}
+
+			const auto deltaMs = static_cast<unsigned long>(remainderUs / 1000);
+			remainderUs %= 1000;
+			gameWorldData->ElapsedGameTime += deltaMs;
+
+			Update(deltaMs);
+		}
+	}
+
+	void HeadlessGameLoop::Update(const unsigned long deltaMs)
+	{
+		updateFunc(deltaMs);
+		updateCount++;
+	}
+}
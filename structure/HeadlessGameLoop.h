@@ -0,0 +1,47 @@
+#pragma once
+#ifndef HEADLESSGAMELOOP_H
+#define HEADLESSGAMELOOP_H
+
+#include <cstdint>
+#include <functional>
+
+#include "structure/IGameLoopStrategy.h"
+
+namespace gamelib
+{
+	/// <summary>
+	/// Game loop that only updates, for simulations nobody watches such as dedicated servers.
+	/// Uncapped, updates run back to back with the time since the last one. At a fixed tick rate, each update is given
+	/// one tick and the loop sleeps until the next is due; if updates fall more than maxLateTicks behind, the missed
+	/// ticks are dropped rather than run back to back.
+	/// </summary>
+	class HeadlessGameLoop final : public IGameLoopStrategy
+	{
+	public:
+		// tickTimeUs of 0 runs uncapped
+		explicit HeadlessGameLoop(std::function<void(unsigned long deltaMs)> updateFunc, uint64_t tickTimeUs = 0, unsigned int maxLateTicks = 5);
+
+		void Loop(GameWorldData* gameWorldData) override;
+		void Update(unsigned long deltaMs) override;
+
+		// Nothing is drawn
+		void Draw() override { }
+
+		// Replaces the clock and sleep, e.g. to drive the loop from a test
+		void SetClock(std::function<uint64_t()> nowUs, std::function<void(uint64_t durationUs)> sleepUs);
+
+		[[nodiscard]] unsigned long GetUpdateCount() const { return updateCount; }
+		[[nodiscard]] unsigned long GetDroppedTicks() const { return droppedTicks; }
+
+	private:
+		std::function<void(unsigned long deltaMs)> updateFunc;
+		std::function<uint64_t()> nowUs;
+		std::function<void(uint64_t durationUs)> sleepUs;
+		const uint64_t tickTimeUs;
+		const unsigned int maxLateTicks;
+		unsigned long updateCount = 0;
+		unsigned long droppedTicks = 0;
+	};
+}
+
+#endif
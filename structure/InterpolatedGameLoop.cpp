@@ -0,0 +1,99 @@
+#include "InterpolatedGameLoop.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "exceptions/EngineException.h"
+#include "objects/GameWorldData.h"
+#include "time/time.h"
+
+namespace gamelib
+{
+	InterpolatedGameLoop::InterpolatedGameLoop(const uint64_t timeStepUs,
+		std::function<void(unsigned long deltaMs)> updateFunc,
+		std::function<void(float alpha)> drawFunc,
+		std::function<void(unsigned long deltaMs)> inputFunc,
+		const unsigned int maxCatchUpSteps,
+		const uint64_t frameTimeUs)
+		: updateFunc(std::move(updateFunc)),
+		  drawFunc(std::move(drawFunc)),
+		  inputFunc(std::move(inputFunc)),
+		  nowUs(GetTimeUs),
+		  sleepUs([](const uint64_t durationUs) { std::this_thread::sleep_for(std::chrono::microseconds(durationUs)); }),
+		  timeStepUs(timeStepUs),
+		  maxCatchUpSteps(std::max(1U, maxCatchUpSteps)),
+		  frameTimeUs(frameTimeUs)
+	{
+		if (timeStepUs == 0) { THROW(0, "The time step must be at least 1us", "InterpolatedGameLoop"); }
+	}
+
+	void InterpolatedGameLoop::SetClock(std::function<uint64_t()> nowUs, std::function<void(uint64_t durationUs)> sleepUs)
+	{
+		this->nowUs = std::move(nowUs);
+		this->sleepUs = std::move(sleepUs);
+	}
+
+	void InterpolatedGameLoop::Loop(GameWorldData* gameWorldData)
+	{
+		// Fixed update time step with interpolated rendering: https://gafferongames.com/post/fix_your_timestep/
+		auto previous = nowUs();
+		uint64_t lag = 0;
+		uint64_t elapsedRemainderUs = 0;
+
+		while (!gameWorldData->IsGameDone)
+		{
+			const auto frameStart = nowUs();
+			const auto elapsed = frameStart - previous;
+			previous = frameStart;
+			lag += elapsed;
+
+			elapsedRemainderUs += elapsed;
+			gameWorldData->ElapsedGameTime += static_cast<unsigned long>(elapsedRemainderUs / 1000);
+			elapsedRemainderUs %= 1000;
+
+			auto steps = 0U;
+			while (lag >= timeStepUs && steps < maxCatchUpSteps)
+			{
+				Update(NextStepMs());
+				lag -= timeStepUs;
+				steps++;
+			}
+
+			if (lag >= timeStepUs)
+			{
+				// Couldn't keep up: let the game run slower rather than spend ever longer catching up
+				droppedTimeUs += lag - lag % timeStepUs;
+				lag %= timeStepUs;
+			}
+
+			alpha = static_cast<float>(lag) / static_cast<float>(timeStepUs);
+
+			if (gameWorldData->CanDraw) { Draw(); }
+
+			if (frameTimeUs > 0)
+			{
+				const auto frameElapsed = nowUs() - frameStart;
+				if (frameElapsed < frameTimeUs) { sleepUs(frameTimeUs - frameElapsed); }
+			}
+		}
+	}
+
+	void InterpolatedGameLoop::Update(const unsigned long deltaMs)
+	{
+		inputFunc(deltaMs);
+		updateFunc(deltaMs);
+		updateCount++;
+	}
+
+	void InterpolatedGameLoop::Draw()
+	{
+		drawFunc(alpha);
+	}
+
+	unsigned long InterpolatedGameLoop::NextStepMs()
+	{
+		stepRemainderUs += timeStepUs;
+		const auto deltaMs = stepRemainderUs / 1000;
+		stepRemainderUs %= 1000;
+		return static_cast<unsigned long>(deltaMs);
+	}
+}
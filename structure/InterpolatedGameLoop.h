@@ -0,0 +1,67 @@
+#pragma once
+#ifndef INTERPOLATEDGAMELOOP_H
+#define INTERPOLATEDGAMELOOP_H
+
+#include <cstdint>
+#include <functional>
+
+#include "structure/IGameLoopStrategy.h"
+
+namespace gamelib
+{
+	/// <summary>
+	/// Fixed time step loop that renders between steps.
+	/// Updates run in fixed steps timed with a microsecond clock; after them the draw function is given the
+	/// interpolation alpha, i.e. how far into the next step the frame is (0 to 1), so it can blend the last two states.
+	/// At most maxCatchUpSteps updates run per frame: time beyond that is dropped rather than making every following
+	/// frame slower still. With a frame time set, the loop sleeps out what is left of each frame instead of busy-spinning.
+	/// </summary>
+	class InterpolatedGameLoop final : public IGameLoopStrategy
+	{
+	public:
+		// frameTimeUs of 0 runs frames as fast as possible
+		InterpolatedGameLoop(uint64_t timeStepUs,
+			std::function<void(unsigned long deltaMs)> updateFunc,
+			std::function<void(float alpha)> drawFunc,
+			std::function<void(unsigned long deltaMs)> inputFunc,
+			unsigned int maxCatchUpSteps = 5,
+			uint64_t frameTimeUs = 0);
+
+		void Loop(GameWorldData* gameWorldData) override;
+
+		// One fixed step: input is sampled and the game updated with the step's whole milliseconds
+		void Update(unsigned long deltaMs) override;
+
+		// Draws with the alpha of the last frame
+		void Draw() override;
+
+		// Replaces the clock and sleep, e.g. to drive the loop from a test
+		void SetClock(std::function<uint64_t()> nowUs, std::function<void(uint64_t durationUs)> sleepUs);
+
+		[[nodiscard]] float GetAlpha() const { return alpha; }
+		[[nodiscard]] unsigned long GetUpdateCount() const { return updateCount; }
+
+		// Time given up because updates could not keep up
+		[[nodiscard]] uint64_t GetDroppedTimeUs() const { return droppedTimeUs; }
+
+	private:
+		// Milliseconds to pass for the next step. Steps need not be whole milliseconds, so the remainder is carried
+		// over and the deltas add up to the simulated time
+		unsigned long NextStepMs();
+
+		std::function<void(unsigned long deltaMs)> updateFunc;
+		std::function<void(float alpha)> drawFunc;
+		std::function<void(unsigned long deltaMs)> inputFunc;
+		std::function<uint64_t()> nowUs;
+		std::function<void(uint64_t durationUs)> sleepUs;
+		const uint64_t timeStepUs;
+		const unsigned int maxCatchUpSteps;
+		const uint64_t frameTimeUs;
+		uint64_t stepRemainderUs = 0;
+		float alpha = 0.0f;
+		unsigned long updateCount = 0;
+		uint64_t droppedTimeUs = 0;
+	};
+}
+
+#endif
@@ -0,0 +1,168 @@
+#include "PipelinedGameLoop.h"
+#include <chrono>
+#include <exception>
+#include <thread>
+#include "graphic/SDLGraphicsManager.h"
+#include "events/EventManager.h"
+#include "objects/GameWorldData.h"
+#include "resource/ResourceManager.h"
+#include "time/time.h"
+
+namespace gamelib
+{
+	PipelinedGameLoop::PipelinedGameLoop(std::function<void(unsigned long deltaMs)> updateFunc,
+		std::function<void(RenderPacket& packet)> snapshotFunc,
+		std::function<void(const RenderPacket& packet)> renderFunc,
+		std::function<void(unsigned long deltaMs)> inputFunc,
+		const size_t packetCount)
+		: updateFunc(std::move(updateFunc)),
+		  snapshotFunc(std::move(snapshotFunc)),
+		  renderFunc(std::move(renderFunc)),
+		  inputFunc(std::move(inputFunc)),
+		  packets(packetCount) { }
+
+	void PipelinedGameLoop::Loop(GameWorldData* gameWorldData)
+	{
+		packets.Reset();
+		stopping = false;
+
+		// Textures unloaded by the simulation are destroyed here, once the packets that may draw them have been
+		auto& retireQueue = SdlGraphicsManager::Get()->GetRetireQueue();
+		retireQueue.SetSimulatedFrame(framesSimulated);
+		retireQueue.SetDeferring(true);
+		lastInputUs = GetTimeUs();
+
+		// Textures may only be created here, on the thread that owns the renderer
+		auto* resources = ResourceManager::Get();
+		resources->SetRenderThreadUploads(true);
+
+		std::exception_ptr simulationError;
+		std::atomic<bool> simulationDone = false;
+		std::thread simulation([&]
+		{
+			try { Simulate(gameWorldData); }
+			catch (...) { simulationError = std::current_exception(); }
+
+			// Lets the renderer finish what has been written, then stop
+			packets.Close();
+			simulationDone = true;
+		});
+
+		std::exception_ptr renderError;
+		try
+		{
+			while (true)
+			{
+				SampleInput();
+				const auto* packet = NextPacket();
+				if (packet == nullptr) { break; }
+
+				resources->UploadPending(resources->GetMaxUploadsPerFrame());
+				if (gameWorldData->CanDraw) { renderFunc(*packet); }
+				const auto frameNumber = packet->FrameNumber;
+				packets.EndRead();
+				retireQueue.ReleaseDrawn(frameNumber);
+				++framesDrawn;
+			}
+		}
+		catch (...)
+		{
+			renderError = std::current_exception();
+			stopping = true;
+			packets.Close();
+		}
+
+		// The simulation may be waiting on loads to finish before it can stop
+		while (!simulationDone)
+		{
+			if (resources->UploadPending() == 0) { std::this_thread::yield(); }
+		}
+
+		simulation.join();
+		resources->SetRenderThreadUploads(false);
+		retireQueue.SetDeferring(false);
+		EventManager::Get()->SetGameLoopThread();
+
+		if (simulationError) { std::rethrow_exception(simulationError); }
+		if (renderError) { std::rethrow_exception(renderError); }
+	}
+
+	const RenderPacket* PipelinedGameLoop::NextPacket()
+	{
+		constexpr auto uploadInterval = std::chrono::milliseconds(1);
+		while (true)
+		{
+			if (const auto* packet = packets.BeginReadFor(uploadInterval)) { return packet; }
+			if (packets.IsClosed()) { return packets.BeginRead(false); }
+
+			// The simulation may be waiting on these, e.g. to mount an archive
+			ResourceManager::Get()->UploadPending(ResourceManager::Get()->GetMaxUploadsPerFrame());
+		}
+	}
+
+	void PipelinedGameLoop::Simulate(GameWorldData* gameWorldData)
+	{
+		// Events raised by the render thread, e.g. input, queue up for this thread rather than being dispatched there
+		EventManager::Get()->SetGameLoopThread();
+
+		auto previous = GetTimeUs();
+		uint64_t elapsedRemainderUs = 0;
+
+		while (!gameWorldData->IsGameDone && !stopping)
+		{
+			const auto now = GetTimeUs();
+			elapsedRemainderUs += now - previous;
+			previous = now;
+
+			// Sub-millisecond time is carried over to the next frame rather than lost
+			const auto deltaMs = static_cast<unsigned long>(elapsedRemainderUs / 1000);
+			elapsedRemainderUs %= 1000;
+			gameWorldData->ElapsedGameTime += deltaMs;
+
+			Update(deltaMs);
+		}
+	}
+
+	void PipelinedGameLoop::Update(const unsigned long deltaMs)
+	{
+		SdlGraphicsManager::Get()->GetRetireQueue().SetSimulatedFrame(framesSimulated);
+		ResourceManager::Get()->CompleteLoads();
+		updateFunc(deltaMs);
+
+		auto* packet = packets.BeginWrite();
+		if (packet == nullptr)
+		{
+			// The renderer has stopped
+			return;
+		}
+
+		packet->Clear();
+		packet->FrameNumber = framesSimulated;
+		packet->DeltaMs = deltaMs;
+		snapshotFunc(*packet);
+		packets.EndWrite();
+		++framesSimulated;
+	}
+
+	void PipelinedGameLoop::Draw()
+	{
+		SampleInput();
+		ResourceManager::Get()->UploadPending(ResourceManager::Get()->GetMaxUploadsPerFrame());
+		const auto* packet = packets.BeginRead(false);
+		if (packet == nullptr) { return; }
+
+		renderFunc(*packet);
+		const auto frameNumber = packet->FrameNumber;
+		packets.EndRead();
+		SdlGraphicsManager::Get()->GetRetireQueue().ReleaseDrawn(frameNumber);
+		++framesDrawn;
+	}
+
+	void PipelinedGameLoop::SampleInput()
+	{
+		const auto now = GetTimeUs();
+		const auto deltaMs = static_cast<unsigned long>((now - lastInputUs) / 1000);
+		lastInputUs = now;
+		inputFunc(deltaMs);
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+#ifndef PIPELINEDGAMELOOP_H
+#define PIPELINEDGAMELOOP_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "graphic/RenderPacket.h"
+#include "structure/IGameLoopStrategy.h"
+
+namespace gamelib
+{
+	/// <summary>
+	/// Game loop that draws one frame while simulating the next.
+	/// Each update ends by snapshotting what is to be drawn into a render packet. Packets are drawn on the thread that
+	/// called Loop(), which is the one that may use the window's renderer and read input, while updates run on a
+	/// simulation thread of their own. With the default two packets the simulation stays at most one frame ahead of what
+	/// is drawn. Input is sampled before each packet is drawn and should be handed to the simulation as raised events,
+	/// which reach it at its next ProcessAllEvents(). Scene assets always load in the background: they are decoded on
+	/// loader threads, uploaded, e.g. into textures, on the render thread before each packet is drawn and while it waits
+	/// for one, and finished at the start of each update on the simulation thread, which owns the resource manager.
+	/// Updates must leave drawing to the render function: game objects may change while their last packet is drawn.
+	/// Textures unloaded by the simulation are destroyed on the render thread once no packet waiting to be drawn can
+	/// refer to them.
+	/// </summary>
+	class PipelinedGameLoop final : public IGameLoopStrategy
+	{
+	public:
+		PipelinedGameLoop(std::function<void(unsigned long deltaMs)> updateFunc,
+			std::function<void(RenderPacket& packet)> snapshotFunc,
+			std::function<void(const RenderPacket& packet)> renderFunc,
+			std::function<void(unsigned long deltaMs)> inputFunc,
+			size_t packetCount = 2);
+
+		// Returns once the game is done and every packet written has been drawn. Exceptions from either thread stop
+		// both and are rethrown here
+		void Loop(GameWorldData* gameWorldData) override;
+
+		// Updates and publishes a packet of the result. Waits while the renderer is too far behind
+		void Update(unsigned long deltaMs) override;
+
+		// Samples input and draws the oldest packet not yet drawn, if there is one
+		void Draw() override;
+
+		[[nodiscard]] uint64_t GetFramesSimulated() const { return framesSimulated; }
+		[[nodiscard]] uint64_t GetFramesDrawn() const { return framesDrawn; }
+
+	private:
+		void Simulate(GameWorldData* gameWorldData);
+		void SampleInput();
+
+		// Waits for the next packet to draw, uploading loaded assets meanwhile. Null once the simulation has stopped
+		const RenderPacket* NextPacket();
+
+		std::function<void(unsigned long deltaMs)> updateFunc;
+		std::function<void(RenderPacket& packet)> snapshotFunc;
+		std::function<void(const RenderPacket& packet)> renderFunc;
+		std::function<void(unsigned long deltaMs)> inputFunc;
+		RenderPacketBuffer packets;
+		std::atomic<bool> stopping = false;
+		std::atomic<uint64_t> framesSimulated = 0;
+		std::atomic<uint64_t> framesDrawn = 0;
+		uint64_t lastInputUs = 0;
+	};
+}
+
+#endif
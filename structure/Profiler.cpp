@@ -1 +1,209 @@
 #include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace gamelib
+{
+	namespace
+	{
+		int64_t GetSteadyClockNs()
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		// Zones a thread keeps between frames, beyond which they are dropped, e.g. when frames are never ended
+		constexpr size_t MaxZonesPerThread = 65536;
+	}
+
+	struct Profiler::ThreadZones
+	{
+		// Taken by the owning thread to add a zone, and by EndFrame() to gather them
+		std::mutex mutex;
+		std::vector<ProfileZone> ended;
+
+		// Time spent in nested zones, for each open zone. Only used by the owning thread
+		std::vector<uint64_t> openZoneChildNs;
+
+		uint32_t thread {};
+	};
+
+	Profiler* Profiler::Get()
+	{
+		// Never destroyed, as zones may still end while other statics are torn down
+		static auto* instance = new Profiler();
+		return instance;
+	}
+
+	Profiler::Profiler() : epochNs(GetSteadyClockNs()) { }
+
+	void Profiler::SetEnabled(const bool enabled)
+	{
+		this->enabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	void Profiler::SetTimelineCapacity(const size_t capacity)
+	{
+		std::lock_guard lock(mutex);
+		timelineCapacity = capacity;
+		timeline.clear();
+		nextTimelineZone = 0;
+	}
+
+	uint64_t Profiler::GetTimeNowNs() const
+	{
+		return static_cast<uint64_t>(GetSteadyClockNs() - epochNs.load(std::memory_order_relaxed));
+	}
+
+	Profiler::ThreadZones& Profiler::GetThreadZones()
+	{
+		thread_local std::shared_ptr<ThreadZones> zones;
+		if (!zones)
+		{
+			zones = std::make_shared<ThreadZones>();
+
+			std::lock_guard lock(mutex);
+			zones->thread = nextThreadNumber++;
+			threads.push_back(zones);
+		}
+		return *zones;
+	}
+
+	uint64_t Profiler::BeginZone()
+	{
+		GetThreadZones().openZoneChildNs.push_back(0);
+		return GetTimeNowNs();
+	}
+
+	void Profiler::EndZone(const char* name, const uint64_t startNs)
+	{
+		const auto endNs = GetTimeNowNs();
+		auto& zones = GetThreadZones();
+
+		// Reset() while the zone was open moves the clock's epoch past its start
+		const auto durationNs = endNs > startNs ? endNs - startNs : 0;
+
+		const auto childNs = zones.openZoneChildNs.back();
+		zones.openZoneChildNs.pop_back();
+		if (!zones.openZoneChildNs.empty()) { zones.openZoneChildNs.back() += durationNs; }
+
+		std::lock_guard lock(zones.mutex);
+		if (zones.ended.size() >= MaxZonesPerThread) { return; }
+
+		zones.ended.push_back({ name, startNs, durationNs, durationNs - std::min(durationNs, childNs),
+			static_cast<uint32_t>(zones.openZoneChildNs.size()), zones.thread, 0 });
+	}
+
+	void Profiler::EndFrame()
+	{
+		std::lock_guard lock(mutex);
+		lastFrame.clear();
+
+		for (auto thread = threads.begin(); thread != threads.end();)
+		{
+			auto& zones = **thread;
+			{
+				std::lock_guard threadLock(zones.mutex);
+				for (auto& zone : zones.ended)
+				{
+					zone.Frame = frameNumber;
+
+					auto totals = std::find_if(lastFrame.begin(), lastFrame.end(), [&](const ProfileZoneTotals& existing)
+					{
+						// The same literal can have a different address in each translation unit
+						return existing.Name == zone.Name || std::strcmp(existing.Name, zone.Name) == 0;
+					});
+					if (totals == lastFrame.end()) { totals = lastFrame.insert(lastFrame.end(), { zone.Name }); }
+
+					totals->Calls++;
+					totals->TotalNs += zone.DurationNs;
+					totals->SelfNs += zone.SelfNs;
+					totals->MaxNs = std::max(totals->MaxNs, zone.DurationNs);
+
+					if (timelineCapacity == 0) { continue; }
+					if (timeline.size() < timelineCapacity) { timeline.push_back(zone); }
+					else { timeline[nextTimelineZone] = zone; }
+					nextTimelineZone = (nextTimelineZone + 1) % timelineCapacity;
+				}
+				zones.ended.clear();
+			}
+
+			// Only we hold on to the zones of threads that have finished
+			if (thread->use_count() == 1) { thread = threads.erase(thread); }
+			else { ++thread; }
+		}
+
+		frameNumber++;
+	}
+
+	uint64_t Profiler::GetFrameNumber() const
+	{
+		std::lock_guard lock(mutex);
+		return frameNumber;
+	}
+
+	std::vector<ProfileZoneTotals> Profiler::GetLastFrame() const
+	{
+		std::lock_guard lock(mutex);
+		return lastFrame;
+	}
+
+	std::vector<ProfileZone> Profiler::GetTimeline() const
+	{
+		std::lock_guard lock(mutex);
+
+		// Once full, the oldest zone is the next one to be overwritten
+		if (timeline.size() < timelineCapacity) { return timeline; }
+
+		std::vector<ProfileZone> ordered(timeline.begin() + static_cast<std::ptrdiff_t>(nextTimelineZone), timeline.end());
+		ordered.insert(ordered.end(), timeline.begin(), timeline.begin() + static_cast<std::ptrdiff_t>(nextTimelineZone));
+		return ordered;
+	}
+
+	void Profiler::WriteChromeTrace(std::ostream& out) const
+	{
+		const auto zones = GetTimeline();
+
+		out << "{\"traceEvents\":[";
+		for (size_t i = 0; i < zones.size(); i++)
+		{
+			const auto& zone = zones[i];
+
+			out << (i == 0 ? "" : ",") << "\n{\"name\":\"";
+			for (const auto* character = zone.Name; *character != '\0'; character++)
+			{
+				if (*character == '"' || *character == '\\') { out << '\\'; }
+				out << *character;
+			}
+
+			// Timestamps are in microseconds
+			out << "\",\"cat\":\"gamelib\",\"ph\":\"X\",\"ts\":" << static_cast<double>(zone.StartNs) / 1000.0
+			    << ",\"dur\":" << static_cast<double>(zone.DurationNs) / 1000.0
+			    << ",\"pid\":1,\"tid\":" << zone.Thread
+			    << ",\"args\":{\"frame\":" << zone.Frame << ",\"self\":" << static_cast<double>(zone.SelfNs) / 1000.0 << "}}";
+		}
+		out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+	}
+
+	void Profiler::Reset()
+	{
+		std::lock_guard lock(mutex);
+		for (const auto& zones : threads)
+		{
+			std::lock_guard threadLock(zones->mutex);
+			zones->ended.clear();
+		}
+		lastFrame.clear();
+		timeline.clear();
+		nextTimelineZone = 0;
+		frameNumber = 0;
+		epochNs = GetSteadyClockNs();
+	}
+
+	uint64_t Profiler::GetDurationNs(const std::function<void()>& funcToProfile)
+	{
+		const auto before = GetSteadyClockNs();
+		funcToProfile();
+		return static_cast<uint64_t>(GetSteadyClockNs() - before);
+	}
+}
@@ -1,16 +1,97 @@
 #pragma once
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
 #include <time/time.h>
 
 namespace gamelib
 {
+	// One timed zone on one thread
+	struct ProfileZone
+	{
+		// Zone names are string literals, so are kept by pointer
+		const char* Name {};
+
+		// Since the profiler was created or reset
+		uint64_t StartNs {};
+		uint64_t DurationNs {};
+
+		// Less the time spent in zones nested inside it
+		uint64_t SelfNs {};
+
+		// Number of zones it is nested in
+		uint32_t Depth {};
+		uint32_t Thread {};
+		uint64_t Frame {};
+	};
+
+	// All zones of one name ended within a frame
+	struct ProfileZoneTotals
+	{
+		const char* Name {};
+		unsigned long Calls {};
+		uint64_t TotalNs {};
+		uint64_t SelfNs {};
+		uint64_t MaxNs {};
+	};
+
+	/// <summary>
+	/// Times nested zones of code on any thread with a nanosecond steady clock.
+	/// Zones are marked with PROFILE_ZONE("name") and frames ended with PROFILE_FRAME(). Each thread keeps its own stack
+	/// of open zones and buffer of ended ones, so recording takes no shared lock; ending a frame gathers the buffers into
+	/// per-frame totals and a timeline of the latest zones, which can be written out for chrome://tracing, Perfetto or
+	/// Tracy's chrome trace importer.
+	/// Nothing is recorded until enabled. Building without GAMELIB_PROFILING defined compiles the macros out entirely.
+	/// </summary>
 	class Profiler
 	{
 	public:
+		static Profiler* Get();
+
+		Profiler(const Profiler& other) = delete;
+		Profiler& operator=(const Profiler& other) = delete;
+
+		void SetEnabled(bool enabled);
+		[[nodiscard]] bool IsEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+		// Zones kept in the timeline, the oldest being dropped first
+		void SetTimelineCapacity(size_t capacity);
+
+		// Used by ProfileScope. Returns the zone's start time
+		uint64_t BeginZone();
+		void EndZone(const char* name, uint64_t startNs);
+
+		// Gathers the zones ended since the last frame from every thread
+		void EndFrame();
+
+		[[nodiscard]] uint64_t GetFrameNumber() const;
+
+		// Totals of the last ended frame, by the order their zones first ended
+		[[nodiscard]] std::vector<ProfileZoneTotals> GetLastFrame() const;
+
+		// Oldest first
+		[[nodiscard]] std::vector<ProfileZone> GetTimeline() const;
+
+		// Chrome trace event format: one complete event per zone in the timeline
+		void WriteChromeTrace(std::ostream& out) const;
+
+		void Reset();
+
+		// Steady clock in nanoseconds since the profiler was created or reset
+		[[nodiscard]] uint64_t GetTimeNowNs() const;
+
 		static long GetTimeNowMs()
 		{
 			return static_cast<long>(GetTimeMs());
 		}
+
 		static long GetDuration(const std::function<void()> &funcToProfile)
 		{
 			const auto before = GetTimeNowMs();
@@ -18,6 +99,56 @@ namespace gamelib
 			const auto after = GetTimeNowMs();
 			return after - before;
 		}
+
+		static uint64_t GetDurationNs(const std::function<void()>& funcToProfile);
+
+	private:
+		Profiler();
+
+		struct ThreadZones;
+		ThreadZones& GetThreadZones();
+
+		std::atomic<bool> enabled = false;
+		std::atomic<int64_t> epochNs;
+
+		mutable std::mutex mutex;
+		std::vector<std::shared_ptr<ThreadZones>> threads;
+		uint32_t nextThreadNumber = 1;
+		uint64_t frameNumber = 0;
+		std::vector<ProfileZoneTotals> lastFrame;
+
+		// Ring of the latest zones
+		std::vector<ProfileZone> timeline;
+		size_t timelineCapacity = 65536;
+		size_t nextTimelineZone = 0;
+	};
+
+	// Times the enclosing scope as a zone, see PROFILE_ZONE
+	class ProfileScope
+	{
+	public:
+		explicit ProfileScope(const char* name) : name(name), startNs(Profiler::Get()->IsEnabled() ? Profiler::Get()->BeginZone() : NotStarted) { }
+		~ProfileScope() { if (startNs != NotStarted) { Profiler::Get()->EndZone(name, startNs); } }
+
+		ProfileScope(const ProfileScope& other) = delete;
+		ProfileScope& operator=(const ProfileScope& other) = delete;
+
+	private:
+		static constexpr uint64_t NotStarted = UINT64_MAX;
+		const char* name;
+		uint64_t startNs;
 	};
 }
 
+#define GAMELIB_PROFILE_CONCAT_INNER(a, b) a##b
+#define GAMELIB_PROFILE_CONCAT(a, b) GAMELIB_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef GAMELIB_PROFILING
+#define PROFILE_ZONE(name) const ::gamelib::ProfileScope GAMELIB_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FRAME() ::gamelib::Profiler::Get()->EndFrame()
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#endif
+
+#endif
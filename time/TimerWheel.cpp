@@ -0,0 +1,248 @@
+#include "TimerWheel.h"
+#include <algorithm>
+#include <bit>
+#include "events/EventManager.h"
+
+namespace gamelib
+{
+	TimerHandle TimerWheel::ScheduleOnce(const unsigned long delayMs, std::function<void()> callback)
+	{
+		return Schedule(delayMs, 0, std::move(callback));
+	}
+
+	TimerHandle TimerWheel::SchedulePeriodic(const unsigned long periodMs, std::function<void()> callback)
+	{
+		return Schedule(periodMs, std::max(periodMs, 1UL), std::move(callback));
+	}
+
+	TimerHandle TimerWheel::ScheduleEvent(const unsigned long delayMs, const std::shared_ptr<Event>& event, EventManager* eventManager)
+	{
+		auto* target = eventManager ? eventManager : EventManager::Get();
+		return ScheduleOnce(delayMs, [target, event] { target->RaiseEventWithNoLogging(event); });
+	}
+
+	TimerHandle TimerWheel::Schedule(const unsigned long delayMs, const unsigned long periodMs, std::function<void()> callback)
+	{
+		uint32_t index;
+		if (!freeTimers.empty())
+		{
+			index = freeTimers.back();
+			freeTimers.pop_back();
+		}
+		else
+		{
+			index = static_cast<uint32_t>(timers.size());
+			timers.emplace_back();
+		}
+
+		auto& timer = timers[index];
+		timer.Callback = std::move(callback);
+		timer.ExpiryMs = nowMs + std::max(delayMs, 1UL);
+		timer.PeriodMs = periodMs;
+		Insert(index);
+		timerCount++;
+
+		return { index, timer.Generation };
+	}
+
+	bool TimerWheel::Cancel(const TimerHandle handle)
+	{
+		if (!IsScheduled(handle)) { return false; }
+
+		Unlink(handle.Index);
+
+		// A periodic timer cancelling itself is freed once its callback returns
+		if (handle.Index != firing) { Free(handle.Index); }
+		return true;
+	}
+
+	bool TimerWheel::IsScheduled(const TimerHandle handle) const
+	{
+		return handle.Index < timers.size() && timers[handle.Index].Generation == handle.Generation && timers[handle.Index].Bucket != NoBucket;
+	}
+
+	size_t TimerWheel::Advance(const unsigned long deltaMs)
+	{
+		// Left over from a callback that threw
+		auto fired = FireFiring();
+
+		const auto targetMs = nowMs + deltaMs;
+		while (nowMs < targetMs)
+		{
+			const auto nextMs = GetNextSlotMs();
+			if (nextMs > targetMs)
+			{
+				nowMs = targetMs;
+				break;
+			}
+
+			nowMs = nextMs;
+			if ((nowMs & SlotMask) == 0) { Cascade(); }
+
+			MoveDueToFiring();
+			fired += FireFiring();
+		}
+
+		return fired;
+	}
+
+	/// <summary>
+	/// When the next occupied slot comes round: the finest level's slots are due then, coarser levels' are moved down.
+	/// Nothing coarser can come round before the end of a finer level's turn, so the first level with a later slot wins.
+	/// </summary>
+	uint64_t TimerWheel::GetNextSlotMs() const
+	{
+		for (uint32_t level = 0; level < Levels; level++)
+		{
+			const auto shift = SlotBits * level;
+			const auto slot = static_cast<uint32_t>((nowMs >> shift) & SlotMask);
+			const auto laterSlots = slot == SlotMask ? 0 : occupied[level] & (~0ULL << (slot + 1));
+			if (laterSlots != 0)
+			{
+				const auto turnStartMs = nowMs >> (shift + SlotBits) << (shift + SlotBits);
+				return turnStartMs + (static_cast<uint64_t>(std::countr_zero(laterSlots)) << shift);
+			}
+		}
+
+		// Start of the top level's next turn, when timers beyond the wheel are placed again
+		constexpr auto wheelBits = SlotBits * Levels;
+		return ((nowMs >> wheelBits) + 1) << wheelBits;
+	}
+
+	/// <summary>
+	/// Places a timer by the highest digit (6 bits to a level) at which its expiry differs from now: the slot for that
+	/// digit is reached, and the timer moved down to a finer level, once no coarser digit differs.
+	/// </summary>
+	void TimerWheel::Insert(const uint32_t index)
+	{
+		const auto expiryMs = timers[index].ExpiryMs;
+		const auto differentBits = expiryMs ^ nowMs;
+		const auto level = differentBits == 0 ? 0 : static_cast<uint32_t>((std::bit_width(differentBits) - 1) / SlotBits);
+
+		if (level >= Levels)
+		{
+			// Too far off for the wheel: placed again when the top level starts its next turn
+			Link(index, OverflowBucket);
+			return;
+		}
+
+		Link(index, level * SlotsPerLevel + static_cast<uint32_t>((expiryMs >> (SlotBits * level)) & SlotMask));
+	}
+
+	void TimerWheel::Cascade()
+	{
+		if ((nowMs & ((1ULL << (SlotBits * Levels)) - 1)) == 0)
+		{
+			auto index = heads[OverflowBucket];
+			heads[OverflowBucket] = Nil;
+			while (index != Nil)
+			{
+				const auto next = timers[index].Next;
+				Insert(index);
+				index = next;
+			}
+		}
+
+		// Coarsest first, so timers moved down a level are moved again if their new slot is also being reached
+		for (auto level = Levels - 1; level > 0; level--)
+		{
+			const auto shift = SlotBits * level;
+			if ((nowMs & ((1ULL << shift) - 1)) != 0) { continue; }
+
+			const auto slot = static_cast<uint32_t>((nowMs >> shift) & SlotMask);
+			auto index = heads[level * SlotsPerLevel + slot];
+			heads[level * SlotsPerLevel + slot] = Nil;
+			occupied[level] &= ~(1ULL << slot);
+			while (index != Nil)
+			{
+				const auto next = timers[index].Next;
+				Insert(index);
+				index = next;
+			}
+		}
+	}
+
+	void TimerWheel::MoveDueToFiring()
+	{
+		const auto bucket = static_cast<uint32_t>(nowMs & SlotMask);
+		auto index = heads[bucket];
+		while (index != Nil)
+		{
+			const auto next = timers[index].Next;
+			Unlink(index);
+			Link(index, FiringBucket);
+			index = next;
+		}
+	}
+
+	size_t TimerWheel::FireFiring()
+	{
+		size_t fired = 0;
+		while (heads[FiringBucket] != Nil)
+		{
+			const auto index = heads[FiringBucket];
+			Unlink(index);
+
+			// Rescheduled before the callback runs, so the callback can cancel it
+			auto& timer = timers[index];
+			if (timer.PeriodMs > 0)
+			{
+				timer.ExpiryMs += timer.PeriodMs;
+				Insert(index);
+			}
+
+			firing = index;
+			try { timer.Callback(); }
+			catch (...)
+			{
+				FinishFiring(index);
+				throw;
+			}
+			FinishFiring(index);
+			fired++;
+		}
+		return fired;
+	}
+
+	void TimerWheel::FinishFiring(const uint32_t index)
+	{
+		firing = Nil;
+
+		// One-shot, or periodic and cancelled by its callback
+		if (timers[index].Bucket == NoBucket) { Free(index); }
+	}
+
+	void TimerWheel::Link(const uint32_t index, const uint32_t bucket)
+	{
+		auto& timer = timers[index];
+		timer.Prev = Nil;
+		timer.Next = heads[bucket];
+		timer.Bucket = bucket;
+		if (timer.Next != Nil) { timers[timer.Next].Prev = index; }
+		heads[bucket] = index;
+
+		if (bucket < FiringBucket) { occupied[bucket / SlotsPerLevel] |= 1ULL << (bucket & SlotMask); }
+	}
+
+	void TimerWheel::Unlink(const uint32_t index)
+	{
+		auto& timer = timers[index];
+		if (timer.Prev != Nil) { timers[timer.Prev].Next = timer.Next; }
+		else { heads[timer.Bucket] = timer.Next; }
+		if (timer.Next != Nil) { timers[timer.Next].Prev = timer.Prev; }
+
+		if (timer.Bucket < FiringBucket && heads[timer.Bucket] == Nil) { occupied[timer.Bucket / SlotsPerLevel] &= ~(1ULL << (timer.Bucket & SlotMask)); }
+
+		timer.Next = timer.Prev = Nil;
+		timer.Bucket = NoBucket;
+	}
+
+	void TimerWheel::Free(const uint32_t index)
+	{
+		auto& timer = timers[index];
+		timer.Callback = nullptr;
+		timer.Generation++;
+		freeTimers.push_back(index);
+		timerCount--;
+	}
+}
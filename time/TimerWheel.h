@@ -0,0 +1,118 @@
+#pragma once
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace gamelib
+{
+	class Event;
+	class EventManager;
+
+	/// <summary>
+	/// Identifies a timer scheduled on a TimerWheel.
+	/// Handles stay safe to use after the timer has fired or been cancelled: the generation no longer matches and they are ignored.
+	/// </summary>
+	struct TimerHandle
+	{
+		uint32_t Index = std::numeric_limits<uint32_t>::max();
+		uint32_t Generation = 0;
+
+		[[nodiscard]] bool IsValid() const { return Index != std::numeric_limits<uint32_t>::max(); }
+	};
+
+	/// <summary>
+	/// Runs one-shot and periodic callbacks after a number of milliseconds of game time, as given to Advance().
+	/// Timers are kept in a hierarchical timing wheel: six levels of 64 slots, each level 64 times coarser than the
+	/// one below, covering about two years. Timers move down a level at a time as they get closer, and Advance() jumps
+	/// straight past empty slots, so its cost depends on the timers firing rather than on the timers scheduled.
+	/// Callbacks run on the thread calling Advance() and may schedule or cancel timers, including their own.
+	/// </summary>
+	class TimerWheel
+	{
+	public:
+		TimerWheel() = default;
+		TimerWheel(const TimerWheel& other) = delete;
+		TimerWheel& operator=(const TimerWheel& other) = delete;
+
+		// Runs callback once, delayMs from now. Delays under 1ms fire on the next Advance()
+		TimerHandle ScheduleOnce(unsigned long delayMs, std::function<void()> callback);
+
+		// Runs callback every periodMs, the first time periodMs from now, until cancelled
+		TimerHandle SchedulePeriodic(unsigned long periodMs, std::function<void()> callback);
+
+		// Raises event on eventManager (the global one if not given) delayMs from now
+		TimerHandle ScheduleEvent(unsigned long delayMs, const std::shared_ptr<Event>& event, EventManager* eventManager = nullptr);
+
+		// False if the timer had already fired or been cancelled
+		bool Cancel(TimerHandle handle);
+		[[nodiscard]] bool IsScheduled(TimerHandle handle) const;
+
+		// Moves time on by deltaMs, running the callbacks of timers that come due in order. Returns the number run
+		size_t Advance(unsigned long deltaMs);
+
+		[[nodiscard]] uint64_t GetTimeMs() const { return nowMs; }
+		[[nodiscard]] size_t GetTimerCount() const { return timerCount; }
+
+	private:
+		static constexpr uint32_t SlotBits = 6;
+		static constexpr uint32_t SlotsPerLevel = 1 << SlotBits;
+		static constexpr uint32_t SlotMask = SlotsPerLevel - 1;
+		static constexpr uint32_t Levels = 6;
+		static constexpr uint32_t Nil = std::numeric_limits<uint32_t>::max();
+
+		// Buckets are the wheel slots, level by level, then the timers currently being fired and those beyond the wheel
+		static constexpr uint32_t FiringBucket = Levels * SlotsPerLevel;
+		static constexpr uint32_t OverflowBucket = FiringBucket + 1;
+		static constexpr uint32_t NoBucket = OverflowBucket + 1;
+
+		struct Timer
+		{
+			std::function<void()> Callback;
+			uint64_t ExpiryMs = 0;
+			unsigned long PeriodMs = 0;
+			uint32_t Next = Nil;
+			uint32_t Prev = Nil;
+			uint32_t Bucket = NoBucket;
+			uint32_t Generation = 0;
+		};
+
+		TimerHandle Schedule(unsigned long delayMs, unsigned long periodMs, std::function<void()> callback);
+		void Insert(uint32_t index);
+		void Link(uint32_t index, uint32_t bucket);
+		void Unlink(uint32_t index);
+		void Free(uint32_t index);
+		[[nodiscard]] uint64_t GetNextSlotMs() const;
+		void Cascade();
+		void MoveDueToFiring();
+		size_t FireFiring();
+		void FinishFiring(uint32_t index);
+
+		// A deque, so callbacks stay put while the timers they schedule are added
+		std::deque<Timer> timers;
+		std::vector<uint32_t> freeTimers;
+		std::array<uint32_t, NoBucket> heads = MakeEmptyHeads();
+
+		// Which slots of each level hold timers, so Advance() can jump straight to the next one
+		std::array<uint64_t, Levels> occupied {};
+
+		uint64_t nowMs = 0;
+		size_t timerCount = 0;
+		uint32_t firing = Nil;
+
+		static std::array<uint32_t, NoBucket> MakeEmptyHeads()
+		{
+			std::array<uint32_t, NoBucket> empty {};
+			empty.fill(Nil);
+			return empty;
+		}
+	};
+}
+
+#endif
@@ -12,6 +12,14 @@ namespace gamelib
             ).count();
         }
 
+        uint64_t GetTimeUs()
+        {
+            using namespace std::chrono;
+            return duration_cast<microseconds>(
+                steady_clock::now().time_since_epoch()
+            ).count();
+        }
+
         std::tm localtime_safe(std::time_t t)
         {
             std::tm tm{};
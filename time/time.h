@@ -8,5 +8,8 @@ namespace gamelib
 
 	uint64_t GetTimeMs();
 
+	// Steady clock in microseconds, for timing finer than a millisecond
+	uint64_t GetTimeUs();
+
 	std::tm localtime_safe(std::time_t t);
 }
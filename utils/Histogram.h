@@ -0,0 +1,101 @@
+#pragma once
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+namespace gamelib
+{
+	/// <summary>
+	/// Fixed-size log-linear histogram in the style of HdrHistogram.
+	/// Values are grouped by power of two and each group is split into SubBuckets linear buckets,
+	/// so percentiles are accurate to within 1/SubBuckets of the value at any magnitude, with no allocation.
+	/// </summary>
+	class Histogram
+	{
+	public:
+		void Record(const uint64_t value, const uint64_t count = 1)
+		{
+			counts[GetBucketIndex(value)] += count;
+			totalCount += count;
+			sum += value * count;
+			if (value > max) { max = value; }
+			if (value < min) { min = value; }
+		}
+
+		// The (upper bound of the bucket holding the) value below which percentile% of recorded values fall
+		[[nodiscard]] uint64_t GetPercentile(const double percentile) const
+		{
+			if (totalCount == 0) { return 0; }
+
+			auto target = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(totalCount) + 0.5);
+			if (target < 1) { target = 1; }
+
+			uint64_t seen = 0;
+			for (size_t bucket = 0; bucket < BucketCount; bucket++)
+			{
+				seen += counts[bucket];
+				if (seen >= target)
+				{
+					const auto upper = GetBucketUpperBound(bucket);
+					return upper < max ? upper : max;
+				}
+			}
+			return max;
+		}
+
+		[[nodiscard]] uint64_t GetCount() const { return totalCount; }
+		[[nodiscard]] uint64_t GetMax() const { return max; }
+		[[nodiscard]] uint64_t GetMin() const { return totalCount == 0 ? 0 : min; }
+		[[nodiscard]] double GetMean() const { return totalCount == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(totalCount); }
+
+		void Merge(const Histogram& other)
+		{
+			for (size_t bucket = 0; bucket < BucketCount; bucket++) { counts[bucket] += other.counts[bucket]; }
+			totalCount += other.totalCount;
+			sum += other.sum;
+			if (other.max > max) { max = other.max; }
+			if (other.min < min) { min = other.min; }
+		}
+
+		void Reset() { *this = Histogram(); }
+
+	private:
+		static constexpr unsigned SubBucketBits = 4;
+		static constexpr uint64_t SubBuckets = 1ULL << SubBucketBits;
+
+		// Exact buckets below SubBuckets, then SubBuckets buckets for every power of two up to 2^63
+		static constexpr size_t BucketCount = SubBuckets + (64 - SubBucketBits) * SubBuckets;
+
+		static size_t GetBucketIndex(const uint64_t value)
+		{
+			if (value < SubBuckets) { return static_cast<size_t>(value); }
+
+			const auto magnitude = static_cast<unsigned>(std::bit_width(value)) - 1;
+			const auto shift = magnitude - SubBucketBits;
+			const auto subBucket = (value >> shift) - SubBuckets;
+			return static_cast<size_t>(SubBuckets + shift * SubBuckets + subBucket);
+		}
+
+		static uint64_t GetBucketUpperBound(const size_t bucket)
+		{
+			if (bucket < SubBuckets) { return bucket; }
+
+			const auto shift = (bucket - SubBuckets) / SubBuckets;
+			const auto subBucket = (bucket - SubBuckets) % SubBuckets;
+			const auto lower = (SubBuckets + subBucket) << shift;
+			return lower + ((1ULL << shift) - 1);
+		}
+
+		std::array<uint64_t, BucketCount> counts {};
+		uint64_t totalCount = 0;
+		uint64_t sum = 0;
+		uint64_t max = 0;
+		uint64_t min = std::numeric_limits<uint64_t>::max();
+	};
+}
+
+#endif
@@ -0,0 +1,143 @@
+#pragma once
+#ifndef MPSCRINGBUFFER_H
+#define MPSCRINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace gamelib
+{
+	// Back-pressure counters for an MpscRingBuffer
+	struct MpscRingBufferStatistics
+	{
+		size_t Capacity {};
+		unsigned long Pushed {};
+
+		// Items refused because the buffer was full
+		unsigned long Dropped {};
+
+		// Most items ever waiting in the buffer at once
+		size_t HighWaterMark {};
+	};
+
+	/// <summary>
+	/// Bounded lock-free queue that any number of threads can push into and one thread pops from.
+	/// Each slot carries a sequence number that tells producers and the consumer whose turn it is to use it.
+	/// </summary>
+	template <class T>
+	class MpscRingBuffer
+	{
+	public:
+		// Capacity is rounded up to a power of two
+		explicit MpscRingBuffer(const size_t capacity = 1024)
+		{
+			size_t size = 2;
+			while (size < capacity) { size <<= 1; }
+
+			mask = size - 1;
+			cells = std::make_unique<Cell[]>(size);
+			for (size_t i = 0; i < size; i++) { cells[i].Sequence.store(i, std::memory_order_relaxed); }
+		}
+
+		MpscRingBuffer(const MpscRingBuffer& other) = delete;
+		MpscRingBuffer& operator=(const MpscRingBuffer& other) = delete;
+
+		// Safe to call from any thread. Returns false, and counts a drop, when the buffer is full
+		bool TryPush(T item)
+		{
+			Cell* cell;
+			auto position = enqueuePosition.load(std::memory_order_relaxed);
+			while (true)
+			{
+				cell = &cells[position & mask];
+				const auto sequence = cell->Sequence.load(std::memory_order_acquire);
+				const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+				if (difference == 0)
+				{
+					// Slot is free for this position: claim it
+					if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) { break; }
+				}
+				else if (difference < 0)
+				{
+					// Consumer hasn't freed this slot yet: full
+					dropped.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+				else
+				{
+					// Another producer claimed it first
+					position = enqueuePosition.load(std::memory_order_relaxed);
+				}
+			}
+
+			cell->Data = std::move(item);
+			cell->Sequence.store(position + 1, std::memory_order_release);
+
+			pushed.fetch_add(1, std::memory_order_relaxed);
+			const auto dequeued = dequeuePosition.load(std::memory_order_relaxed);
+			if (position + 1 > dequeued) { UpdateHighWaterMark(position + 1 - dequeued); }
+			return true;
+		}
+
+		// Only the consumer thread may pop
+		bool TryPop(T& item)
+		{
+			const auto position = dequeuePosition.load(std::memory_order_relaxed);
+			auto& cell = cells[position & mask];
+			const auto sequence = cell.Sequence.load(std::memory_order_acquire);
+
+			// Producer hasn't finished writing this slot yet: empty (as far as we can see)
+			if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1) < 0) { return false; }
+
+			item = std::move(cell.Data);
+			cell.Data = T();
+			cell.Sequence.store(position + mask + 1, std::memory_order_release);
+			dequeuePosition.store(position + 1, std::memory_order_relaxed);
+			return true;
+		}
+
+		// Approximate when producers are active
+		[[nodiscard]] size_t Size() const
+		{
+			const auto enqueued = enqueuePosition.load(std::memory_order_relaxed);
+			const auto dequeued = dequeuePosition.load(std::memory_order_relaxed);
+			return enqueued > dequeued ? enqueued - dequeued : 0;
+		}
+
+		[[nodiscard]] size_t GetCapacity() const { return mask + 1; }
+
+		[[nodiscard]] MpscRingBufferStatistics GetStatistics() const
+		{
+			return { GetCapacity(), pushed.load(std::memory_order_relaxed), dropped.load(std::memory_order_relaxed), highWaterMark.load(std::memory_order_relaxed) };
+		}
+
+	private:
+		struct Cell
+		{
+			std::atomic<size_t> Sequence;
+			T Data;
+		};
+
+		void UpdateHighWaterMark(const size_t depth)
+		{
+			auto highest = highWaterMark.load(std::memory_order_relaxed);
+			while (depth > highest && !highWaterMark.compare_exchange_weak(highest, depth, std::memory_order_relaxed)) {}
+		}
+
+		std::unique_ptr<Cell[]> cells;
+		size_t mask {};
+
+		// Keep producer and consumer positions on separate cache lines
+		alignas(64) std::atomic<size_t> enqueuePosition {0};
+		alignas(64) std::atomic<size_t> dequeuePosition {0};
+
+		std::atomic<unsigned long> pushed {0};
+		std::atomic<unsigned long> dropped {0};
+		std::atomic<size_t> highWaterMark {0};
+	};
+}
+
+#endif
@@ -0,0 +1,172 @@
+#include "ThreadPool.h"
+#include "exceptions/EngineException.h"
+
+namespace gamelib
+{
+	namespace
+	{
+		uint64_t PackRange(const uint64_t begin, const uint64_t end) { return begin << 32 | end; }
+		size_t RangeBegin(const uint64_t range) { return static_cast<size_t>(range >> 32); }
+		size_t RangeEnd(const uint64_t range) { return static_cast<size_t>(range & 0xFFFFFFFF); }
+	}
+
+	ThreadPool::ThreadPool(size_t threadCount)
+	{
+		if (threadCount == 0)
+		{
+			const auto hardwareThreads = std::thread::hardware_concurrency();
+			threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+		}
+
+		ranges = std::make_unique<WorkRange[]>(threadCount + 1);
+
+		workers.reserve(threadCount);
+		for (size_t i = 0; i < threadCount; i++)
+		{
+			workers.emplace_back([this, i] { WorkerLoop(i + 1); });
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard lock(mutex);
+			stopping = true;
+		}
+		batchStarted.notify_all();
+
+		for (auto& worker : workers) { worker.join(); }
+	}
+
+	void ThreadPool::RunBatch(const size_t count, void* workContext, const WorkFn workFn, void* callingThreadContext, const CallingThreadFn callingThreadFn)
+	{
+		if (count > 0xFFFFFFFF) { THROW(0, "Too many items in one batch", "ThreadPool"); }
+
+		{
+			std::lock_guard lock(mutex);
+			context = workContext;
+			work = workFn;
+
+			// Deal out equal shares up front; stealing evens out the rest
+			const auto threads = workers.size() + 1;
+			for (size_t i = 0; i < threads; i++)
+			{
+				ranges[i].Items = PackRange(count * i / threads, count * (i + 1) / threads);
+			}
+
+			itemsRemaining = count;
+			firstError = nullptr;
+			batch++;
+		}
+		if (count > 0) { batchStarted.notify_all(); }
+
+		if (callingThreadFn)
+		{
+			try { callingThreadFn(callingThreadContext); }
+			catch (...)
+			{
+				std::lock_guard lock(mutex);
+				if (!firstError) { firstError = std::current_exception(); }
+			}
+		}
+
+		// Help out until there is nothing left to run or steal
+		RunItems(0);
+
+		// Wait for items still running on workers, and for workers to stop looking at this batch
+		std::unique_lock lock(mutex);
+		batchFinished.wait(lock, [this] { return itemsRemaining == 0 && activeWorkers == 0; });
+		work = nullptr;
+
+		if (firstError)
+		{
+			const auto error = firstError;
+			firstError = nullptr;
+			std::rethrow_exception(error);
+		}
+	}
+
+	void ThreadPool::RunItems(const size_t self)
+	{
+		size_t index;
+		while (PopItem(self, index) || StealItems(self, index))
+		{
+			try { work(context, index); }
+			catch (...)
+			{
+				std::lock_guard lock(mutex);
+				if (!firstError) { firstError = std::current_exception(); }
+			}
+
+			if (--itemsRemaining == 0)
+			{
+				std::lock_guard lock(mutex);
+				batchFinished.notify_all();
+			}
+		}
+	}
+
+	bool ThreadPool::PopItem(const size_t self, size_t& index)
+	{
+		auto& items = ranges[self].Items;
+		auto range = items.load();
+		while (RangeBegin(range) < RangeEnd(range))
+		{
+			if (items.compare_exchange_weak(range, PackRange(RangeBegin(range) + 1, RangeEnd(range))))
+			{
+				index = RangeBegin(range);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool ThreadPool::StealItems(const size_t self, size_t& index)
+	{
+		// Only called once this thread's own range is empty, and only this thread ever makes it non-empty again
+		const auto threads = workers.size() + 1;
+		for (size_t offset = 1; offset < threads; offset++)
+		{
+			auto& victim = ranges[(self + offset) % threads].Items;
+			auto range = victim.load();
+			while (RangeBegin(range) < RangeEnd(range))
+			{
+				const auto begin = RangeBegin(range);
+				const auto end = RangeEnd(range);
+
+				// Take the back half (or the last item), leaving the victim to carry on from the front
+				const auto split = end - (end - begin + 1) / 2;
+				if (victim.compare_exchange_weak(range, PackRange(begin, split)))
+				{
+					ranges[self].Items = PackRange(split + 1, end);
+					index = split;
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	void ThreadPool::WorkerLoop(const size_t self)
+	{
+		unsigned long lastBatch = 0;
+		while (true)
+		{
+			{
+				std::unique_lock lock(mutex);
+				batchStarted.wait(lock, [&] { return stopping || (batch != lastBatch && work != nullptr); });
+				if (stopping) { return; }
+				lastBatch = batch;
+				activeWorkers++;
+			}
+
+			RunItems(self);
+
+			{
+				std::lock_guard lock(mutex);
+				activeWorkers--;
+			}
+			batchFinished.notify_all();
+		}
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gamelib
+{
+	/// <summary>
+	/// Fixed set of worker threads that run batches of indexed work items.
+	/// The calling thread takes part in each batch, so a pool with no workers simply runs the batch in place.
+	/// Each thread starts on its own contiguous share of a batch and, once that runs out, steals half of what is left of
+	/// another thread's share, so uneven items balance out without every thread contending on a single counter.
+	/// </summary>
+	class ThreadPool
+	{
+	public:
+		// threadCount = 0 uses one worker per hardware thread, less the calling thread
+		explicit ThreadPool(size_t threadCount = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool& other) = delete;
+		ThreadPool& operator=(const ThreadPool& other) = delete;
+
+		/// <summary>
+		/// Runs work(index) for each index in [0, count) across the workers and returns once all have finished.
+		/// onCallingThread, if given, runs first on the calling thread alongside the workers.
+		/// The first exception thrown by any work item is rethrown here.
+		/// </summary>
+		template <typename Work, typename CallingThreadWork>
+		void ParallelFor(size_t count, Work& work, CallingThreadWork& onCallingThread)
+		{
+			RunBatch(count, &work, [](void* context, const size_t index) { (*static_cast<Work*>(context))(index); },
+			         &onCallingThread, [](void* context) { (*static_cast<CallingThreadWork*>(context))(); });
+		}
+
+		template <typename Work>
+		void ParallelFor(size_t count, Work& work)
+		{
+			RunBatch(count, &work, [](void* context, const size_t index) { (*static_cast<Work*>(context))(index); },
+			         nullptr, nullptr);
+		}
+
+		[[nodiscard]] size_t GetThreadCount() const { return workers.size(); }
+
+	private:
+		using WorkFn = void(*)(void* context, size_t index);
+		using CallingThreadFn = void(*)(void* context);
+
+		void RunBatch(size_t count, void* workContext, WorkFn workFn, void* callingThreadContext, CallingThreadFn callingThreadFn);
+		void WorkerLoop(size_t self);
+		void RunItems(size_t self);
+		bool PopItem(size_t self, size_t& index);
+		bool StealItems(size_t self, size_t& index);
+
+		// [begin, end) of the items a thread has yet to run, packed as begin << 32 | end so it can be split atomically
+		struct alignas(64) WorkRange
+		{
+			std::atomic<uint64_t> Items {0};
+		};
+
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::condition_variable batchStarted;
+		std::condition_variable batchFinished;
+
+		// Current batch
+		void* context = nullptr;
+		WorkFn work = nullptr;
+		// One per worker, plus the calling thread's at index 0
+		std::unique_ptr<WorkRange[]> ranges;
+		std::atomic<size_t> itemsRemaining {0};
+		unsigned long batch = 0;
+		size_t activeWorkers = 0;
+		std::exception_ptr firstError;
+		bool stopping = false;
+	};
+}
+
+#endif